@@ -0,0 +1,39 @@
+﻿using Hat.Native;
+
+namespace Hat;
+
+/// <summary>
+/// A pattern with a scanner that is resolved once, up front, so that repeated scans only pay for the scan itself.
+/// </summary>
+public class CompiledPattern : IDisposable
+{
+	internal nint Handle;
+
+	/// <summary>
+	/// Compiles a pattern. The source pattern may be disposed once the compiled pattern has been created.
+	/// </summary>
+	/// <param name="pattern">The pattern to compile.</param>
+	/// <param name="alignment">The byte alignment of the results.</param>
+	/// <exception cref="InvalidOperationException">An unknown error occurred.</exception>
+	public unsafe CompiledPattern(Pattern pattern, ScanAlignment alignment = ScanAlignment.X1)
+	{
+		Utils.CheckStatus(Functions.libhat_compile_pattern(pattern.Signature, alignment, out Handle));
+	}
+
+	~CompiledPattern()
+	{
+		Dispose();
+	}
+
+	/// <summary>
+	/// Frees the memory allocated for the compiled pattern.
+	/// </summary>
+	public void Dispose()
+	{
+		if (Handle == nint.Zero) return;
+
+		Functions.libhat_free_compiled_pattern(Handle);
+		Handle = nint.Zero;
+		GC.SuppressFinalize(this);
+	}
+}
@@ -20,6 +20,43 @@ internal static unsafe partial class Functions
 	internal static partial nint libhat_find_pattern_mod(Signature* signature, nint module, 
 		[MarshalAs(UnmanagedType.LPStr)] string section, ScanAlignment align);
 
+	[LibraryImport(LIBRARY_NAME)]
+	internal static partial nuint libhat_find_all_pattern(Signature* signature, nint buffer, nuint size,
+		ScanAlignment align, nint* resultsOut, nuint capacity);
+
+	[LibraryImport(LIBRARY_NAME)]
+	internal static partial nuint libhat_find_all_pattern_mod(Signature* signature, nint module,
+		[MarshalAs(UnmanagedType.LPStr)] string section, ScanAlignment align, nint* resultsOut, nuint capacity);
+
+	[LibraryImport(LIBRARY_NAME)]
+	internal static partial Status libhat_find_patterns(Signature** signatures, nuint count, nint buffer, nuint size,
+		ScanAlignment align, nint* resultsOut);
+
+	[LibraryImport(LIBRARY_NAME)]
+	internal static partial Status libhat_find_patterns_mod(Signature** signatures, nuint count, nint module,
+		[MarshalAs(UnmanagedType.LPStr)] string section, ScanAlignment align, nint* resultsOut);
+
+	[LibraryImport(LIBRARY_NAME)]
+	internal static partial Status libhat_compile_pattern(Signature* signature, ScanAlignment align, out nint pattern);
+
+	[LibraryImport(LIBRARY_NAME)]
+	internal static partial nint libhat_find_compiled_pattern(nint pattern, nint buffer, nuint size);
+
+	[LibraryImport(LIBRARY_NAME)]
+	internal static partial nint libhat_find_compiled_pattern_mod(nint pattern, nint module,
+		[MarshalAs(UnmanagedType.LPStr)] string section);
+
+	[LibraryImport(LIBRARY_NAME)]
+	internal static partial nuint libhat_find_all_compiled_pattern(nint pattern, nint buffer, nuint size,
+		nint* resultsOut, nuint capacity);
+
+	[LibraryImport(LIBRARY_NAME)]
+	internal static partial nuint libhat_find_all_compiled_pattern_mod(nint pattern, nint module,
+		[MarshalAs(UnmanagedType.LPStr)] string section, nint* resultsOut, nuint capacity);
+
+	[LibraryImport(LIBRARY_NAME)]
+	internal static partial void libhat_free_compiled_pattern(nint pattern);
+
 	[LibraryImport(LIBRARY_NAME)]
 	internal static partial void libhat_free(nint data);
 }
@@ -13,5 +13,30 @@ public enum ScanAlignment
 	/// <summary>
 	/// The result is aligned to 16 bytes.
 	/// </summary>
-	X16
+	X16,
+
+	/// <summary>
+	/// The result is aligned to 2 bytes.
+	/// </summary>
+	X2,
+
+	/// <summary>
+	/// The result is aligned to 4 bytes, the alignment of pointers on 32-bit platforms.
+	/// </summary>
+	X4,
+
+	/// <summary>
+	/// The result is aligned to 8 bytes, the alignment of pointers on 64-bit platforms.
+	/// </summary>
+	X8,
+
+	/// <summary>
+	/// The result is aligned to 32 bytes.
+	/// </summary>
+	X32,
+
+	/// <summary>
+	/// The result is aligned to 64 bytes.
+	/// </summary>
+	X64
 }
@@ -77,4 +77,125 @@ public unsafe class Scanner
 		
 		throw new InvalidOperationException("Scanner is not initialized.");
 	}
-}
+
+	/// <summary>
+	/// Scans for a compiled pattern.
+	/// </summary>
+	/// <param name="pattern">The pattern to scan for.</param>
+	/// <returns>The address of the pattern if found, otherwise, 0.</returns>
+	public nint FindPattern(CompiledPattern pattern)
+	{
+		if (_buffer is not null && _size is not null)
+		{
+			return Functions.libhat_find_compiled_pattern(pattern.Handle, _buffer.Value, _size.Value);
+		}
+
+		if (_section is not null && _module is not null)
+		{
+			return Functions.libhat_find_compiled_pattern_mod(pattern.Handle, _module.Value, _section);
+		}
+
+		throw new InvalidOperationException("Scanner is not initialized.");
+	}
+
+	/// <summary>
+	/// Scans for every match of a pattern, writing their addresses into the results without allocating. The scan
+	/// stops once the results are full, so a return value equal to their length may indicate that there were more
+	/// matches.
+	/// </summary>
+	/// <param name="pattern">The pattern to scan for.</param>
+	/// <param name="results">Receives the address of every match.</param>
+	/// <param name="alignment">The byte alignment of the results.</param>
+	/// <returns>The number of matches written into the results.</returns>
+	public int FindAllPattern(Pattern pattern, Span<nint> results, ScanAlignment alignment = ScanAlignment.X1)
+	{
+		fixed (nint* resultsOut = results)
+		{
+			if (_buffer is not null && _size is not null)
+			{
+				return (int)Functions.libhat_find_all_pattern(pattern.Signature, _buffer.Value, _size.Value,
+					alignment, resultsOut, (nuint)results.Length);
+			}
+
+			if (_section is not null && _module is not null)
+			{
+				return (int)Functions.libhat_find_all_pattern_mod(pattern.Signature, _module.Value, _section,
+					alignment, resultsOut, (nuint)results.Length);
+			}
+		}
+
+		throw new InvalidOperationException("Scanner is not initialized.");
+	}
+
+	/// <summary>
+	/// Scans for every match of a compiled pattern, writing their addresses into the results without allocating.
+	/// </summary>
+	/// <param name="pattern">The pattern to scan for.</param>
+	/// <param name="results">Receives the address of every match.</param>
+	/// <returns>The number of matches written into the results.</returns>
+	/// <seealso cref="FindAllPattern(Pattern, Span{nint}, ScanAlignment)"/>
+	public int FindAllPattern(CompiledPattern pattern, Span<nint> results)
+	{
+		fixed (nint* resultsOut = results)
+		{
+			if (_buffer is not null && _size is not null)
+			{
+				return (int)Functions.libhat_find_all_compiled_pattern(pattern.Handle, _buffer.Value, _size.Value,
+					resultsOut, (nuint)results.Length);
+			}
+
+			if (_section is not null && _module is not null)
+			{
+				return (int)Functions.libhat_find_all_compiled_pattern_mod(pattern.Handle, _module.Value, _section,
+					resultsOut, (nuint)results.Length);
+			}
+		}
+
+		throw new InvalidOperationException("Scanner is not initialized.");
+	}
+
+	/// <summary>
+	/// Scans for the first match of each of the patterns in a single pass, with a single native call.
+	/// </summary>
+	/// <param name="patterns">The patterns to scan for.</param>
+	/// <param name="results">
+	/// Receives the address of the first match for each pattern, at the same index, or 0 if the pattern has no match.
+	/// </param>
+	/// <param name="alignment">The byte alignment of the results.</param>
+	/// <exception cref="ArgumentException">The results can't hold a result for every pattern.</exception>
+	/// <exception cref="InvalidOperationException">An unknown error occurred.</exception>
+	public void FindPatterns(ReadOnlySpan<Pattern> patterns, Span<nint> results,
+		ScanAlignment alignment = ScanAlignment.X1)
+	{
+		if (results.Length < patterns.Length)
+		{
+			throw new ArgumentException("Results can't hold a result for every pattern.", nameof(results));
+		}
+
+		Span<nint> signatures = patterns.Length <= 256 ? stackalloc nint[patterns.Length] : new nint[patterns.Length];
+		for (var i = 0; i < patterns.Length; i++)
+		{
+			signatures[i] = (nint)patterns[i].Signature;
+		}
+
+		fixed (nint* signaturesIn = signatures)
+		fixed (nint* resultsOut = results)
+		{
+			if (_buffer is not null && _size is not null)
+			{
+				Utils.CheckStatus(Functions.libhat_find_patterns((Signature**)signaturesIn, (nuint)patterns.Length,
+					_buffer.Value, _size.Value, alignment, resultsOut));
+				return;
+			}
+
+			if (_section is not null && _module is not null)
+			{
+				Utils.CheckStatus(Functions.libhat_find_patterns_mod((Signature**)signaturesIn,
+					(nuint)patterns.Length, _module.Value, _section, alignment, resultsOut));
+				return;
+			}
+		}
+
+		throw new InvalidOperationException("Scanner is not initialized.");
+	}
+}
\ No newline at end of file
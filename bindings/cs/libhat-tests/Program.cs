@@ -15,6 +15,20 @@ var address = scanner.FindPattern(pattern);
 
 Console.WriteLine($"found pattern at 0x{address:X}");
 
+Console.WriteLine("\nscanning for several patterns in memory buffer:");
+var patterns = new[] { pattern, randomBytes.AsSpan().Slice(0x8000, 0x10).ToArray().AsPattern() };
+var addresses = new nint[patterns.Length];
+scanner.FindPatterns(patterns, addresses);
+
+Console.WriteLine($"found patterns at 0x{addresses[0]:X}, 0x{addresses[1]:X}");
+
+Console.WriteLine("\nscanning for all matches in memory buffer:");
+using var compiled = new CompiledPattern(new byte?[] { randomBytes[0x1000], null }.AsPattern());
+Span<nint> matches = stackalloc nint[64];
+var count = scanner.FindAllPattern(compiled, matches);
+
+Console.WriteLine($"found {count} matches, the first at 0x{matches[0]:X}");
+
 Console.WriteLine("\nscanning in module:");
 
 var modulePattern = new Pattern("48 89 5C 24 ? 48 89 6C 24 ? 48 89 74 24 ? 57 48 81 EC");
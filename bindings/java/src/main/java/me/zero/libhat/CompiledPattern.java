@@ -0,0 +1,31 @@
+package me.zero.libhat;
+
+import com.sun.jna.Pointer;
+import me.zero.libhat.jna.Libhat;
+import org.jetbrains.annotations.NotNull;
+import org.jetbrains.annotations.Nullable;
+
+import java.util.Objects;
+
+/**
+ * A {@link Signature} with a scanner that was resolved once, up front, so repeated scans only pay for the scan itself.
+ *
+ * @author Brady
+ */
+public final class CompiledPattern implements AutoCloseable {
+
+    @Nullable
+    Pointer handle;
+
+    CompiledPattern(@NotNull final Pointer handle) {
+        this.handle = Objects.requireNonNull(handle);
+    }
+
+    @Override
+    public void close() {
+        if (this.handle != Pointer.NULL) {
+            Libhat.INSTANCE.libhat_free_compiled_pattern(this.handle);
+            this.handle = Pointer.NULL;
+        }
+    }
+}
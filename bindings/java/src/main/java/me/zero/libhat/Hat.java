@@ -211,6 +211,273 @@ public final class Hat {
         }
     }
 
+    /**
+     * Compiles the specified {@link Signature}, resolving the scanner used to search for it once instead of on every
+     * scan. The returned {@link CompiledPattern} is backed by a native heap allocation, and
+     * {@link CompiledPattern#close()} must be called when the object is done being used, either explicitly or through
+     * a try-with-resources block. The {@link Signature} may be closed once this method returns.
+     *
+     * @param signature The pattern to compile
+     * @param alignment The result address alignment
+     * @return The compiled pattern
+     * @throws RuntimeException if an internal error occurred, indicated by {@code status != Status.SUCCESS}
+     * @throws NullPointerException if any arguments are {@code null}
+     */
+    public static @NotNull CompiledPattern compilePattern(@NotNull final Signature signature,
+                                                          @NotNull final ScanAlignment alignment) {
+        Objects.requireNonNull(signature);
+        Objects.requireNonNull(alignment);
+        final Pointer[] handle = new Pointer[1];
+        final int status = Libhat.INSTANCE.libhat_compile_pattern(
+            Objects.requireNonNull(signature.handle),
+            alignment.ordinal(),
+            handle
+        );
+        if (status != 0) {
+            throw new RuntimeException("libhat internal error " + Status.values()[status]);
+        }
+        return new CompiledPattern(handle[0]);
+    }
+
+    /**
+     * Finds the byte pattern described by the given {@link CompiledPattern} in the specified {@code buffer}, searching
+     * the range including {@link ByteBuffer#position()} and up to but excluding {@link ByteBuffer#limit()}. If a match
+     * is found, an {@link OptionalInt} containing the absolute position into {@code buffer} is returned. The specified
+     * {@link ByteBuffer} must be a direct buffer.
+     *
+     * @param pattern The pattern to match
+     * @param buffer  The buffer to search
+     * @return The absolute position into {@code buffer} where a match was found,
+     *         or {@link OptionalInt#empty()} if there was no match
+     * @throws IllegalArgumentException if the buffer is not direct
+     * @throws NullPointerException if any arguments are {@code null}, or the pattern has already been closed
+     */
+    public static OptionalInt findPattern(@NotNull final CompiledPattern pattern, @NotNull final ByteBuffer buffer) {
+        Objects.requireNonNull(pattern);
+        final long start = address(buffer);
+
+        final Pointer result = Libhat.INSTANCE.libhat_find_compiled_pattern(
+            Objects.requireNonNull(pattern.handle),
+            new Pointer(start),
+            buffer.remaining()
+        );
+
+        if (result == Pointer.NULL) {
+            return OptionalInt.empty();
+        }
+        return OptionalInt.of((int) (Pointer.nativeValue(result) - start) + buffer.position());
+    }
+
+    /**
+     * Finds the byte pattern described by the given {@link CompiledPattern} in the specified {@code section} of the
+     * specified {@code module}. If a match is found, an {@link Optional} containing a Pointer to the match is returned.
+     *
+     * @param pattern The pattern to match
+     * @param module  The target module
+     * @param section The section to search in the module
+     * @return A pointer to the memory where a match was identified, or {@link Optional#empty()} if none was found.
+     * @throws NullPointerException if any arguments are {@code null}, or the pattern has already been closed
+     */
+    public static Optional<Pointer> findPattern(@NotNull final CompiledPattern pattern,
+                                                @NotNull final ProcessModule module, @NotNull final String section) {
+        Objects.requireNonNull(pattern);
+        Objects.requireNonNull(module);
+        Objects.requireNonNull(section);
+
+        final Pointer result = Libhat.INSTANCE.libhat_find_compiled_pattern_mod(
+            Objects.requireNonNull(pattern.handle),
+            module.handle,
+            section
+        );
+
+        return Optional.ofNullable(result);
+    }
+
+    /**
+     * Finds all matches of the byte pattern described by the given {@link Signature} in the specified {@code buffer},
+     * searching the range including {@link ByteBuffer#position()} and up to but excluding {@link ByteBuffer#limit()}.
+     * The address of each match is written into {@code results} as a {@link Native#POINTER_SIZE} byte value in native
+     * byte order, starting at its position. The scan stops once {@code results} is full, so a return value equal to
+     * its capacity may indicate that there were more matches. The position of neither buffer is modified, and both
+     * must be direct buffers.
+     *
+     * @param signature The pattern to match
+     * @param buffer    The buffer to search
+     * @param alignment The result address alignment
+     * @param results   The buffer receiving the address of every match
+     * @return The number of matches written into {@code results}
+     * @throws IllegalArgumentException if either buffer is not direct
+     * @throws NullPointerException if any arguments are {@code null}, or the signature has already been closed
+     */
+    public static int findAllPattern(@NotNull final Signature signature, @NotNull final ByteBuffer buffer,
+                                     @NotNull final ScanAlignment alignment, @NotNull final ByteBuffer results) {
+        Objects.requireNonNull(signature);
+        Objects.requireNonNull(alignment);
+
+        return (int) Libhat.INSTANCE.libhat_find_all_pattern(
+            Objects.requireNonNull(signature.handle),
+            new Pointer(address(buffer)),
+            buffer.remaining(),
+            alignment.ordinal(),
+            new Pointer(address(results)),
+            capacity(results)
+        );
+    }
+
+    /**
+     * Finds all matches of the byte pattern described by the given {@link Signature} in the specified {@code section}
+     * of the specified {@code module}. The matches are written into {@code results} the same way as
+     * {@link #findAllPattern(Signature, ByteBuffer, ScanAlignment, ByteBuffer)}.
+     *
+     * @param signature The pattern to match
+     * @param module    The target module
+     * @param section   The section to search in the module
+     * @param alignment The result address alignment
+     * @param results   The buffer receiving the address of every match
+     * @return The number of matches written into {@code results}
+     * @throws IllegalArgumentException if the results buffer is not direct
+     * @throws NullPointerException if any arguments are {@code null}, or the signature has already been closed
+     */
+    public static int findAllPattern(@NotNull final Signature signature, @NotNull final ProcessModule module,
+                                     @NotNull final String section, @NotNull final ScanAlignment alignment,
+                                     @NotNull final ByteBuffer results) {
+        Objects.requireNonNull(signature);
+        Objects.requireNonNull(module);
+        Objects.requireNonNull(section);
+        Objects.requireNonNull(alignment);
+
+        return (int) Libhat.INSTANCE.libhat_find_all_pattern_mod(
+            Objects.requireNonNull(signature.handle),
+            module.handle,
+            section,
+            alignment.ordinal(),
+            new Pointer(address(results)),
+            capacity(results)
+        );
+    }
+
+    /**
+     * Finds all matches of the byte pattern described by the given {@link CompiledPattern} in the specified
+     * {@code buffer}. The matches are written into {@code results} the same way as
+     * {@link #findAllPattern(Signature, ByteBuffer, ScanAlignment, ByteBuffer)}.
+     *
+     * @param pattern The pattern to match
+     * @param buffer  The buffer to search
+     * @param results The buffer receiving the address of every match
+     * @return The number of matches written into {@code results}
+     * @throws IllegalArgumentException if either buffer is not direct
+     * @throws NullPointerException if any arguments are {@code null}, or the pattern has already been closed
+     */
+    public static int findAllPattern(@NotNull final CompiledPattern pattern, @NotNull final ByteBuffer buffer,
+                                     @NotNull final ByteBuffer results) {
+        Objects.requireNonNull(pattern);
+
+        return (int) Libhat.INSTANCE.libhat_find_all_compiled_pattern(
+            Objects.requireNonNull(pattern.handle),
+            new Pointer(address(buffer)),
+            buffer.remaining(),
+            new Pointer(address(results)),
+            capacity(results)
+        );
+    }
+
+    /**
+     * Finds all matches of the byte pattern described by the given {@link CompiledPattern} in the specified
+     * {@code section} of the specified {@code module}. The matches are written into {@code results} the same way as
+     * {@link #findAllPattern(Signature, ByteBuffer, ScanAlignment, ByteBuffer)}.
+     *
+     * @param pattern The pattern to match
+     * @param module  The target module
+     * @param section The section to search in the module
+     * @param results The buffer receiving the address of every match
+     * @return The number of matches written into {@code results}
+     * @throws IllegalArgumentException if the results buffer is not direct
+     * @throws NullPointerException if any arguments are {@code null}, or the pattern has already been closed
+     */
+    public static int findAllPattern(@NotNull final CompiledPattern pattern, @NotNull final ProcessModule module,
+                                     @NotNull final String section, @NotNull final ByteBuffer results) {
+        Objects.requireNonNull(pattern);
+        Objects.requireNonNull(module);
+        Objects.requireNonNull(section);
+
+        return (int) Libhat.INSTANCE.libhat_find_all_compiled_pattern_mod(
+            Objects.requireNonNull(pattern.handle),
+            module.handle,
+            section,
+            new Pointer(address(results)),
+            capacity(results)
+        );
+    }
+
+    /**
+     * Finds the first match for each of the given signatures in a single pass over the specified {@code buffer},
+     * searching the range including {@link ByteBuffer#position()} and up to but excluding {@link ByteBuffer#limit()}.
+     * The address of the match for {@code signatures[i]} is written into {@code results} at index {@code i}, as a
+     * {@link Native#POINTER_SIZE} byte value in native byte order starting at its position, or {@code 0} if the
+     * signature has no match. The position of neither buffer is modified, and both must be direct buffers.
+     *
+     * @param signatures The patterns to match
+     * @param buffer     The buffer to search
+     * @param alignment  The result address alignment
+     * @param results    The buffer receiving the address of the first match for each signature
+     * @throws IllegalArgumentException if either buffer is not direct, or {@code results} can't hold a result for
+     *                                  every signature
+     * @throws RuntimeException if an internal error occurred, indicated by {@code status != Status.SUCCESS}
+     * @throws NullPointerException if any arguments are {@code null}, or any signature has already been closed
+     */
+    public static void findPatterns(@NotNull final Signature @NotNull[] signatures, @NotNull final ByteBuffer buffer,
+                                    @NotNull final ScanAlignment alignment, @NotNull final ByteBuffer results) {
+        Objects.requireNonNull(alignment);
+        final Pointer[] handles = handles(signatures, results);
+
+        final int status = Libhat.INSTANCE.libhat_find_patterns(
+            handles,
+            handles.length,
+            new Pointer(address(buffer)),
+            buffer.remaining(),
+            alignment.ordinal(),
+            new Pointer(address(results))
+        );
+        if (status != 0) {
+            throw new RuntimeException("libhat internal error " + Status.values()[status]);
+        }
+    }
+
+    /**
+     * Finds the first match for each of the given signatures in a single pass over the specified {@code section} of
+     * the specified {@code module}. The matches are written into {@code results} the same way as
+     * {@link #findPatterns(Signature[], ByteBuffer, ScanAlignment, ByteBuffer)}.
+     *
+     * @param signatures The patterns to match
+     * @param module     The target module
+     * @param section    The section to search in the module
+     * @param alignment  The result address alignment
+     * @param results    The buffer receiving the address of the first match for each signature
+     * @throws IllegalArgumentException if the results buffer is not direct or can't hold a result for every signature
+     * @throws RuntimeException if an internal error occurred, indicated by {@code status != Status.SUCCESS}
+     * @throws NullPointerException if any arguments are {@code null}, or any signature has already been closed
+     */
+    public static void findPatterns(@NotNull final Signature @NotNull[] signatures, @NotNull final ProcessModule module,
+                                    @NotNull final String section, @NotNull final ScanAlignment alignment,
+                                    @NotNull final ByteBuffer results) {
+        Objects.requireNonNull(module);
+        Objects.requireNonNull(section);
+        Objects.requireNonNull(alignment);
+        final Pointer[] handles = handles(signatures, results);
+
+        final int status = Libhat.INSTANCE.libhat_find_patterns_mod(
+            handles,
+            handles.length,
+            module.handle,
+            section,
+            alignment.ordinal(),
+            new Pointer(address(results))
+        );
+        if (status != 0) {
+            throw new RuntimeException("libhat internal error " + Status.values()[status]);
+        }
+    }
+
     /**
      * Returns the module for the executable used to create this process
      *
@@ -237,4 +504,30 @@ public final class Hat {
         }
         return Optional.of(new ProcessModule(addr));
     }
+
+    private static long address(@NotNull final ByteBuffer buffer) {
+        Objects.requireNonNull(buffer);
+        if (!buffer.isDirect()) {
+            throw new IllegalArgumentException("Provided buffer must be direct");
+        }
+        return Pointer.nativeValue(Native.getDirectBufferPointer(buffer)) + buffer.position();
+    }
+
+    private static long capacity(@NotNull final ByteBuffer results) {
+        return results.remaining() / Native.POINTER_SIZE;
+    }
+
+    private static Pointer @NotNull[] handles(@NotNull final Signature @NotNull[] signatures,
+                                              @NotNull final ByteBuffer results) {
+        Objects.requireNonNull(signatures);
+        Objects.requireNonNull(results);
+        if (capacity(results) < signatures.length) {
+            throw new IllegalArgumentException("Provided results buffer can't hold a result for every signature");
+        }
+        final Pointer[] handles = new Pointer[signatures.length];
+        for (int i = 0; i < signatures.length; i++) {
+            handles[i] = Objects.requireNonNull(Objects.requireNonNull(signatures[i]).handle);
+        }
+        return handles;
+    }
 }
@@ -1,6 +1,9 @@
 package me.zero.libhat;
 
 /**
+ * The byte alignment of the result of a scan. The ordinal of each constant is passed to the native library, so new
+ * alignments are only ever appended.
+ *
  * @author Brady
  */
 public enum ScanAlignment {
@@ -12,5 +15,30 @@ public enum ScanAlignment {
     /**
      * 16 byte alignment
      */
-    X16
+    X16,
+
+    /**
+     * 2 byte alignment
+     */
+    X2,
+
+    /**
+     * 4 byte alignment, the alignment of pointers on 32-bit platforms
+     */
+    X4,
+
+    /**
+     * 8 byte alignment, the alignment of pointers on 64-bit platforms
+     */
+    X8,
+
+    /**
+     * 32 byte alignment
+     */
+    X32,
+
+    /**
+     * 64 byte alignment
+     */
+    X64
 }
@@ -47,6 +47,114 @@ public interface Libhat extends Library {
      */
     Pointer libhat_find_pattern_mod(Pointer signature, Pointer module, String section, int align);
 
+    /*
+     * size_t libhat_find_all_pattern(
+     *     const signature_t*  signature,
+     *     const void*         buffer,
+     *     size_t              size,
+     *     scan_alignment_t    align,
+     *     const void**        resultsOut,
+     *     size_t              capacity
+     * );
+     */
+    long libhat_find_all_pattern(Pointer signature, Pointer buffer, long size, int align, Pointer resultsOut,
+                                 long capacity);
+
+    /*
+     * size_t libhat_find_all_pattern_mod(
+     *     const signature_t*  signature,
+     *     const void*         module,
+     *     const char*         section,
+     *     scan_alignment_t    align,
+     *     const void**        resultsOut,
+     *     size_t              capacity
+     * );
+     */
+    long libhat_find_all_pattern_mod(Pointer signature, Pointer module, String section, int align, Pointer resultsOut,
+                                     long capacity);
+
+    /*
+     * libhat_status_t libhat_find_patterns(
+     *     const signature_t* const*  signatures,
+     *     size_t                     count,
+     *     const void*                buffer,
+     *     size_t                     size,
+     *     scan_alignment_t           align,
+     *     const void**               resultsOut
+     * );
+     */
+    int libhat_find_patterns(Pointer[] signatures, long count, Pointer buffer, long size, int align,
+                             Pointer resultsOut);
+
+    /*
+     * libhat_status_t libhat_find_patterns_mod(
+     *     const signature_t* const*  signatures,
+     *     size_t                     count,
+     *     const void*                module,
+     *     const char*                section,
+     *     scan_alignment_t           align,
+     *     const void**               resultsOut
+     * );
+     */
+    int libhat_find_patterns_mod(Pointer[] signatures, long count, Pointer module, String section, int align,
+                                 Pointer resultsOut);
+
+    /*
+     * libhat_status_t libhat_compile_pattern(
+     *     const signature_t*    signature,
+     *     scan_alignment_t      align,
+     *     compiled_pattern_t**  patternOut
+     * );
+     */
+    int libhat_compile_pattern(Pointer signature, int align, Pointer[] patternOut);
+
+    /*
+     * const void* libhat_find_compiled_pattern(
+     *     const compiled_pattern_t*  pattern,
+     *     const void*                buffer,
+     *     size_t                     size
+     * );
+     */
+    Pointer libhat_find_compiled_pattern(Pointer pattern, Pointer buffer, long size);
+
+    /*
+     * const void* libhat_find_compiled_pattern_mod(
+     *     const compiled_pattern_t*  pattern,
+     *     const void*                module,
+     *     const char*                section
+     * );
+     */
+    Pointer libhat_find_compiled_pattern_mod(Pointer pattern, Pointer module, String section);
+
+    /*
+     * size_t libhat_find_all_compiled_pattern(
+     *     const compiled_pattern_t*  pattern,
+     *     const void*                buffer,
+     *     size_t                     size,
+     *     const void**               resultsOut,
+     *     size_t                     capacity
+     * );
+     */
+    long libhat_find_all_compiled_pattern(Pointer pattern, Pointer buffer, long size, Pointer resultsOut,
+                                          long capacity);
+
+    /*
+     * size_t libhat_find_all_compiled_pattern_mod(
+     *     const compiled_pattern_t*  pattern,
+     *     const void*                module,
+     *     const char*                section,
+     *     const void**               resultsOut,
+     *     size_t                     capacity
+     * );
+     */
+    long libhat_find_all_compiled_pattern_mod(Pointer pattern, Pointer module, String section, Pointer resultsOut,
+                                              long capacity);
+
+    /*
+     * void libhat_free_compiled_pattern(compiled_pattern_t* pattern);
+     */
+    void libhat_free_compiled_pattern(Pointer pattern);
+
     /*
      * const void* libhat_get_module(const char* name);
      */
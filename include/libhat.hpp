@@ -3,14 +3,29 @@
 #include "libhat/Access.hpp"
 #include "libhat/Callable.hpp"
 #include "libhat/CompileTime.hpp"
+#include "libhat/CompiledPattern.hpp"
 #include "libhat/Concepts.hpp"
 #include "libhat/Defines.hpp"
+#include "libhat/FixedPattern.hpp"
 #include "libhat/FixedString.hpp"
+#include "libhat/FrequencyModel.hpp"
+#include "libhat/ImageFile.hpp"
 #include "libhat/MemoryProtector.hpp"
+#include "libhat/PatternSet.hpp"
 #include "libhat/Process.hpp"
+#include "libhat/RemoteProcess.hpp"
+#include "libhat/ResolutionCache.hpp"
+#include "libhat/ResolveChain.hpp"
 #include "libhat/Result.hpp"
+#include "libhat/ScanBuffer.hpp"
+#include "libhat/ScanScheduler.hpp"
+#include "libhat/ScanStats.hpp"
 #include "libhat/Scanner.hpp"
 #include "libhat/Signature.hpp"
+#include "libhat/SignatureArena.hpp"
+#include "libhat/StreamScanner.hpp"
 #include "libhat/StringLiteral.hpp"
 #include "libhat/System.hpp"
 #include "libhat/Traits.hpp"
+#include "libhat/Watch.hpp"
+#include "libhat/XrefIndex.hpp"
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include "Concepts.hpp"
+#include "Process.hpp"
+#include "Scanner.hpp"
+#include "Signature.hpp"
+
+namespace hat {
+
+    /// A signature with a scan context that is resolved once, up front. Every call to find_pattern truncates the
+    /// signature, selects the scanner for the current system, chooses the byte pair to compare against, and prepares
+    /// the vector masks before scanning. A compiled_pattern does all of that on construction, so each subsequent scan
+    /// only pays for the scan itself.
+    class compiled_pattern {
+    public:
+        /// Compiles the signature. If a frequency model of the data that will be scanned is provided, the byte pair
+        /// compared by the scanner is selected from it. The model is only used during construction. If a mode is
+        /// given and supported by the current system, its scanner is used regardless of the global selection.
+        explicit compiled_pattern(
+            const signature_view           signature,
+            const scan_alignment           alignment = scan_alignment::X1,
+            const scan_hint                hints = scan_hint::none,
+            const frequency_model*         model = nullptr,
+            const std::optional<scan_mode> mode = std::nullopt
+        ) {
+            const auto [offset, trunc] = detail::truncate(signature);
+            this->offset = offset;
+            this->storage.assign(trunc.begin(), trunc.end());
+            if (!this->storage.empty()) {
+                this->context.emplace(detail::scan_context::create(this->storage, alignment, hints, {}, model, mode));
+            }
+        }
+
+        compiled_pattern(const compiled_pattern& other)
+            : offset(other.offset), storage(other.storage), context(other.context) {
+            this->rebind();
+        }
+
+        compiled_pattern(compiled_pattern&& other) noexcept = default;
+
+        compiled_pattern& operator=(const compiled_pattern& other) {
+            if (this != &other) {
+                this->offset = other.offset;
+                this->storage = other.storage;
+                this->context = other.context;
+                this->rebind();
+            }
+            return *this;
+        }
+
+        compiled_pattern& operator=(compiled_pattern&& other) noexcept = default;
+
+        /// Returns the size of the signature this pattern was compiled from, including leading wildcards
+        [[nodiscard]] size_t size() const noexcept {
+            return this->offset + this->storage.size();
+        }
+
+        [[nodiscard]] scan_alignment alignment() const noexcept {
+            return this->context ? this->context->alignment : scan_alignment::X1;
+        }
+
+        /// Returns the scan mode that was requested for this pattern, if any
+        [[nodiscard]] std::optional<scan_mode> mode() const noexcept {
+            return this->context ? this->context->mode : std::nullopt;
+        }
+
+        /// Finds the first match of the pattern in the input range
+        template<detail::byte_input_iterator Iter>
+        [[nodiscard]] auto find(const Iter beginIt, const Iter endIt) const -> detail::result_type_for<Iter> {
+            const auto begin = std::to_address(beginIt) + this->offset;
+            const auto end = std::to_address(endIt);
+
+            if (!this->context || begin >= end || this->storage.size() > static_cast<size_t>(std::distance(begin, end))) {
+                return {nullptr};
+            }
+
+            const const_scan_result result = this->context->scan(begin, end);
+            return result.has_result()
+                ? const_cast<typename detail::result_type_for<Iter>::underlying_type>(result.get() - this->offset)
+                : nullptr;
+        }
+
+        /// Finds the first match of the pattern in a specific section of the process module or a specified module
+        [[nodiscard]] scan_result find(
+            const std::string_view  section,
+            const process::module_t mod = process::get_process_module()
+        ) const {
+            const auto data = process::get_section_data(mod, section);
+            if (data.empty()) {
+                return nullptr;
+            }
+            return this->find(data.begin(), data.end());
+        }
+
+        /// Finds all of the matches of the pattern in the input range, writes them to the output iterator, and
+        /// returns the number of matches
+        template<detail::byte_input_iterator In, std::output_iterator<detail::result_type_for<In>> Out>
+        size_t find_all(const In beginIn, const In endIn, const Out outIn) const {
+            if (!this->context) {
+                return 0;
+            }
+
+            const std::byte* begin = std::to_address(beginIn) + this->offset;
+            const std::byte* end = std::to_address(endIn);
+
+            auto out = outIn;
+            size_t matches{};
+
+            detail::for_each_match(*this->context, begin, end, [&](const std::byte* match) {
+                *out++ = const_cast<typename detail::result_type_for<In>::underlying_type>(match - this->offset);
+                matches++;
+                return true;
+            });
+            return matches;
+        }
+
+        /// Invokes the callback with every match of the pattern in the input range, in ascending order. If the
+        /// callback returns a value convertible to bool, returning false stops the scan. Returns the number of matches
+        /// the callback was invoked with.
+        template<detail::byte_input_iterator In, typename Fn>
+            requires std::invocable<Fn&, detail::result_type_for<In>>
+        size_t find_all(const In beginIn, const In endIn, Fn&& callback) const {
+            if (!this->context) {
+                return 0;
+            }
+
+            const std::byte* begin = std::to_address(beginIn) + this->offset;
+            const std::byte* end = std::to_address(endIn);
+
+            size_t matches{};
+            detail::for_each_match(*this->context, begin, end, [&](const std::byte* match) {
+                const detail::result_type_for<In> result{
+                    const_cast<typename detail::result_type_for<In>::underlying_type>(match - this->offset)
+                };
+                matches++;
+                if constexpr (std::is_convertible_v<std::invoke_result_t<Fn&, detail::result_type_for<In>>, bool>) {
+                    return static_cast<bool>(callback(result));
+                } else {
+                    callback(result);
+                    return true;
+                }
+            });
+            return matches;
+        }
+
+        /// Counts the matches of the pattern in the input range, without materializing their addresses
+        template<detail::byte_input_iterator Iter>
+        [[nodiscard]] size_t count(const Iter beginIt, const Iter endIt) const {
+            const auto begin = std::to_address(beginIt) + this->offset;
+            const auto end = std::to_address(endIt);
+
+            if (!this->context || begin >= end || this->storage.size() > static_cast<size_t>(std::distance(begin, end))) {
+                return 0;
+            }
+
+            detail::match_sink sink{};
+            this->context->scan_all(begin, end, sink);
+            return sink.count;
+        }
+
+        /// Finds all of the matches of the pattern in the input range, and returns them as a std::vector
+        template<detail::byte_input_iterator In>
+        [[nodiscard]] auto find_all(const In beginIt, const In endIt) const -> std::vector<detail::result_type_for<In>> {
+            std::vector<detail::result_type_for<In>> results{};
+            this->find_all(beginIt, endIt, std::back_inserter(results));
+            return results;
+        }
+    private:
+        void rebind() {
+            if (this->context) {
+                this->context->signature = this->storage;
+            }
+        }
+
+        size_t offset{};
+        std::vector<signature_element> storage{};
+        std::optional<detail::scan_context> context{};
+    };
+}
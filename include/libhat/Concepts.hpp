@@ -27,6 +27,12 @@ namespace hat::detail {
                             && std::contiguous_iterator<T>
                             && std::same_as<std::iter_value_t<T>, std::byte>;
 
+    /// A condition polled by an interruptible scan, such as std::stop_token or hat::scan_deadline
+    template<typename T>
+    concept stop_condition = requires(const T& t) {
+        { t.stop_requested() } -> std::convertible_to<bool>;
+    };
+
     template<typename T>
     concept char_iterator = std::is_same_v<std::iter_value_t<T>, char>;
 }
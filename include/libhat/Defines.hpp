@@ -8,6 +8,9 @@
     #endif
 #elif defined(_M_ARM64) || defined(__aarch64__) || defined(_M_ARM) || defined(__arm__)
     #define LIBHAT_ARM
+    #if defined(_M_ARM64) || defined(__aarch64__)
+        #define LIBHAT_ARM64
+    #endif
 #else
     #error Unsupported Architecture
 #endif
@@ -15,20 +18,20 @@
 // Detect Operating System
 #if defined(_WIN32)
     #define LIBHAT_WINDOWS
+#elif defined(__linux__)
+    #define LIBHAT_LINUX
 #else
     #error Unsupported Operating System
 #endif
 
 // Macros wrapping intrinsics
-#ifdef LIBHAT_X86
-    #ifdef LIBHAT_X86_64
-        #define LIBHAT_TZCNT64(num) _tzcnt_u64(num)
-        #define LIBHAT_BLSR64(num) _blsr_u64(num)
-    #else
-        #include <bit>
-        #define LIBHAT_TZCNT64(num) std::countl_zero(num)
-        #define LIBHAT_BLSR64(num) num & (num - 1)
-    #endif
+#ifdef LIBHAT_X86_64
+    #define LIBHAT_TZCNT64(num) _tzcnt_u64(num)
+    #define LIBHAT_BLSR64(num) _blsr_u64(num)
+#else
+    #include <bit>
+    #define LIBHAT_TZCNT64(num) std::countr_zero(num)
+    #define LIBHAT_BLSR64(num) ((num) & ((num) - 1))
 #endif
 
 #ifdef _MSC_VER
@@ -45,14 +48,38 @@
     #define LIBHAT_RETURN_ADDRESS() _ReturnAddress()
     #define LIBHAT_BSF32(num) hat::detail::bsf(num)
 #else
-    #if defined(__clang__)
-        #include <x86intrin.h>
-    #elif defined(__GNUC__)
-        #include <x86gprintrin.h>
+    #ifdef LIBHAT_X86
+        #if defined(__clang__)
+            #include <x86intrin.h>
+        #elif defined(__GNUC__)
+            #include <x86gprintrin.h>
+        #endif
     #endif
 
     #define LIBHAT_RETURN_ADDRESS() __builtin_extract_return_addr(__builtin_return_address(0))
-    #define LIBHAT_BSF32(num) _bit_scan_forward(num)
+    #define LIBHAT_BSF32(num) __builtin_ctz(num)
+#endif
+
+// Enables an instruction set for a single function, so that it may use intrinsics which the rest of the translation unit
+// isn't compiled for. MSVC allows any intrinsic without it.
+#if defined(LIBHAT_X86) && (defined(__GNUC__) || defined(__clang__))
+    #define LIBHAT_TARGET(...) __attribute__((target(__VA_ARGS__)))
+#else
+    #define LIBHAT_TARGET(...)
+#endif
+
+// Enables an instruction set for every function defined between LIBHAT_TARGET_BEGIN and LIBHAT_TARGET_END, so that the
+// kernels for it don't require the translation unit to be compiled with any flags
+#define LIBHAT_PRAGMA(...) _Pragma(#__VA_ARGS__)
+#if defined(LIBHAT_X86) && defined(__clang__)
+    #define LIBHAT_TARGET_BEGIN(features) LIBHAT_PRAGMA(clang attribute push(__attribute__((target(features))), apply_to = function))
+    #define LIBHAT_TARGET_END() LIBHAT_PRAGMA(clang attribute pop)
+#elif defined(LIBHAT_X86) && defined(__GNUC__)
+    #define LIBHAT_TARGET_BEGIN(features) LIBHAT_PRAGMA(GCC push_options) LIBHAT_PRAGMA(GCC target(features))
+    #define LIBHAT_TARGET_END() LIBHAT_PRAGMA(GCC pop_options)
+#else
+    #define LIBHAT_TARGET_BEGIN(features)
+    #define LIBHAT_TARGET_END()
 #endif
 
 #if __cpp_if_consteval >= 202106L
@@ -0,0 +1,419 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <utility>
+
+#include "Defines.hpp"
+#include "FixedString.hpp"
+#include "Scanner.hpp"
+#include "Signature.hpp"
+
+#if defined(LIBHAT_X86)
+    #include <immintrin.h>
+#endif
+
+namespace hat::detail {
+
+    /// Everything the scanners need to know about a signature literal, computed at compile time
+    template<fixed_string str>
+    struct fixed_pattern {
+        static constexpr auto full = compile_signature<str>();
+
+        // Leading wildcards are truncated, like they are from a runtime signature
+        static constexpr size_t offset = [] {
+            size_t i = 0;
+            while (full[i].is_wildcard()) {
+                i++;
+            }
+            return i;
+        }();
+        static constexpr size_t size = full.size() - offset;
+
+        static constexpr auto elements = [] {
+            std::array<signature_element, size> truncated{};
+            std::copy(full.begin() + offset, full.end(), truncated.begin());
+            return truncated;
+        }();
+
+        // The first pair of exact bytes within the first 16 bytes, which is compared in the vectors of every scanner
+        static constexpr std::optional<size_t> pair = []() -> std::optional<size_t> {
+            for (size_t i = 0; i + 1 < std::min<size_t>(size, 16); i++) {
+                if (elements[i].has_value() && elements[i + 1].has_value()) {
+                    return i;
+                }
+            }
+            return std::nullopt;
+        }();
+
+        // The signature is verified 8 bytes at a time, as the mask and value of each word in the byte order of memory.
+        // If the size isn't a multiple of 8, the last word ends with the signature and overlaps the word before it.
+        static constexpr size_t words = (size + 7) / 8;
+        static constexpr size_t word_width = std::min<size_t>(size, 8);
+
+        static constexpr size_t word_offset(const size_t w) {
+            return std::min(w * 8, size - word_width);
+        }
+
+        template<bool mask>
+        static constexpr auto make_words() {
+            std::array<uint64_t, words> result{};
+            for (size_t w = 0; w != words; w++) {
+                std::array<std::byte, 8> bytes{};
+                for (size_t i = 0; i != word_width; i++) {
+                    const auto& element = elements[word_offset(w) + i];
+                    bytes[i] = mask ? element.mask() : element.value();
+                }
+                result[w] = std::bit_cast<uint64_t>(bytes);
+            }
+            return result;
+        }
+
+        static constexpr auto wordMask = make_words<true>();
+        static constexpr auto wordValue = make_words<false>();
+    };
+
+    template<typename Pattern, size_t W>
+    LIBHAT_FORCEINLINE bool verify_fixed_word(const std::byte* candidate) {
+        if constexpr (Pattern::wordMask[W] == 0) {
+            return true;
+        } else {
+            uint64_t word{};
+            std::memcpy(&word, candidate + Pattern::word_offset(W), Pattern::word_width);
+            return (word & Pattern::wordMask[W]) == Pattern::wordValue[W];
+        }
+    }
+
+    /// Compares a candidate against the entire signature, with the comparison of each word unrolled
+    template<typename Pattern>
+    LIBHAT_FORCEINLINE constexpr bool verify_fixed(const std::byte* candidate) {
+        count_candidate();
+        if LIBHAT_IF_CONSTEVAL {
+            return [&]<size_t... I>(std::index_sequence<I...>) {
+                return (Pattern::elements[I].matches(candidate[I]) && ...);
+            }(std::make_index_sequence<Pattern::size>{});
+        } else {
+            return [&]<size_t... W>(std::index_sequence<W...>) {
+                return (verify_fixed_word<Pattern, W>(candidate) && ...);
+            }(std::make_index_sequence<Pattern::words>{});
+        }
+    }
+
+    template<typename Pattern, scan_alignment alignment>
+    constexpr const std::byte* find_fixed_single(const std::byte* begin, const std::byte* end) {
+        constexpr auto stride = alignment_stride<alignment>;
+        constexpr auto first = Pattern::elements[0];
+
+        if constexpr (alignment != scan_alignment::X1) {
+            begin = next_boundary_align<alignment>(begin);
+        }
+        if (begin >= end || static_cast<size_t>(end - begin) < Pattern::size) {
+            return nullptr;
+        }
+
+        const auto last = end - Pattern::size;
+        if constexpr (alignment == scan_alignment::X1 && first.has_value()) {
+            for (auto i = begin; (i = std::find(i, last + 1, first.value())) != last + 1; i++) {
+                if (verify_fixed<Pattern>(i)) LIBHAT_UNLIKELY {
+                    return i;
+                }
+            }
+        } else {
+            for (auto i = begin; i <= last; i += stride) {
+                if (first.matches(*i) && verify_fixed<Pattern>(i)) LIBHAT_UNLIKELY {
+                    return i;
+                }
+                if (static_cast<size_t>(last - i) < stride) {
+                    break;
+                }
+            }
+        }
+        return nullptr;
+    }
+
+#if defined(LIBHAT_X86)
+    // The alignment of the vector types depends on the instruction sets enabled for the translation unit, while the
+    // alignment masks require the vectors to be aligned to their size
+    struct alignas(64) fixed_vector_512 {
+        __m512i value;
+    };
+
+    struct alignas(32) fixed_vector_256 {
+        __m256i value;
+    };
+
+    struct alignas(16) fixed_vector_128 {
+        __m128i value;
+    };
+
+    // The vectorized scanners compare the anchor, which is the pair if there is one and the scan isn't aligned, and
+    // otherwise the first byte with its mask applied
+
+    template<typename Pattern, scan_alignment alignment>
+    inline constexpr bool fixed_paired = alignment == scan_alignment::X1 && Pattern::pair.has_value();
+
+    template<typename Pattern, scan_alignment alignment>
+    inline constexpr size_t fixed_anchor = fixed_paired<Pattern, alignment> ? *Pattern::pair : 0;
+
+#if !defined(LIBHAT_DISABLE_AVX512)
+    template<typename Pattern, scan_alignment alignment>
+    LIBHAT_TARGET("avx512f,avx512bw") LIBHAT_FORCEINLINE uint64_t match_fixed_avx512(const __m512i data) {
+        constexpr auto index = fixed_anchor<Pattern, alignment>;
+        constexpr auto first = Pattern::elements[index];
+        const auto value = _mm512_set1_epi8(static_cast<int8_t>(first.value()));
+
+        uint64_t mask;
+        if constexpr (first.has_value()) {
+            mask = _mm512_cmpeq_epi8_mask(data, value);
+        } else {
+            const auto bits = _mm512_set1_epi8(static_cast<int8_t>(first.mask()));
+            mask = _mm512_cmpeq_epi8_mask(_mm512_and_si512(data, bits), value);
+        }
+
+        if constexpr (fixed_paired<Pattern, alignment>) {
+            const auto second = _mm512_set1_epi8(static_cast<int8_t>(*Pattern::elements[index + 1]));
+            const uint64_t mask2 = _mm512_cmpeq_epi8_mask(data, second);
+            // A match of the first byte in the last position implies that the second byte also matched
+            mask &= (mask2 >> 1) | (uint64_t{1} << 63);
+        } else if constexpr (alignment != scan_alignment::X1) {
+            mask &= create_alignment_mask<uint64_t, alignment>();
+        }
+        return mask;
+    }
+
+    template<typename Pattern, scan_alignment alignment>
+    LIBHAT_TARGET("avx512f,avx512bw") const std::byte* find_fixed_avx512(const std::byte* begin, const std::byte* end) {
+        constexpr auto index = fixed_anchor<Pattern, alignment>;
+
+        begin = next_boundary_align<alignment>(begin);
+        if (begin >= end) LIBHAT_UNLIKELY {
+            return nullptr;
+        }
+
+        auto [pre, vec, post] = segment_scan<fixed_vector_512>(begin, end, Pattern::size, index);
+
+        if (!pre.empty()) {
+            if (const auto result = find_fixed_single<Pattern, alignment>(pre.data(), pre.data() + pre.size())) {
+                return result;
+            }
+        }
+
+        for (auto& it : vec) {
+            auto mask = match_fixed_avx512<Pattern, alignment>(_mm512_load_si512(&it.value));
+            while (mask) {
+                const auto i = reinterpret_cast<const std::byte*>(&it) + std::countr_zero(mask) - index;
+                if (verify_fixed<Pattern>(i)) LIBHAT_UNLIKELY {
+                    return i;
+                }
+                mask &= mask - 1;
+            }
+        }
+
+        if (!post.empty()) {
+            return find_fixed_single<Pattern, alignment>(post.data(), post.data() + post.size());
+        }
+        return nullptr;
+    }
+#endif
+
+    template<typename Pattern, scan_alignment alignment>
+    LIBHAT_TARGET("avx2") LIBHAT_FORCEINLINE uint32_t match_fixed_avx2(const __m256i data) {
+        constexpr auto index = fixed_anchor<Pattern, alignment>;
+        constexpr auto first = Pattern::elements[index];
+        const auto value = _mm256_set1_epi8(static_cast<int8_t>(first.value()));
+
+        uint32_t mask;
+        if constexpr (first.has_value()) {
+            mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(data, value)));
+        } else {
+            const auto bits = _mm256_set1_epi8(static_cast<int8_t>(first.mask()));
+            mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(data, bits), value)));
+        }
+
+        if constexpr (fixed_paired<Pattern, alignment>) {
+            const auto second = _mm256_set1_epi8(static_cast<int8_t>(*Pattern::elements[index + 1]));
+            const auto mask2 = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(data, second)));
+            // A match of the first byte in the last position implies that the second byte also matched
+            mask &= (mask2 >> 1) | (0b1u << 31);
+        } else if constexpr (alignment != scan_alignment::X1) {
+            mask &= create_alignment_mask<uint32_t, alignment>();
+        }
+        return mask;
+    }
+
+    template<typename Pattern, scan_alignment alignment>
+    LIBHAT_TARGET("avx2") const std::byte* find_fixed_avx2(const std::byte* begin, const std::byte* end) {
+        constexpr auto index = fixed_anchor<Pattern, alignment>;
+
+        begin = next_boundary_align<alignment>(begin);
+        if (begin >= end) LIBHAT_UNLIKELY {
+            return nullptr;
+        }
+
+        auto [pre, vec, post] = segment_scan<fixed_vector_256>(begin, end, Pattern::size, index);
+
+        if (!pre.empty()) {
+            if (const auto result = find_fixed_single<Pattern, alignment>(pre.data(), pre.data() + pre.size())) {
+                return result;
+            }
+        }
+
+        for (auto& it : vec) {
+            auto mask = match_fixed_avx2<Pattern, alignment>(_mm256_load_si256(&it.value));
+            while (mask) {
+                const auto i = reinterpret_cast<const std::byte*>(&it) + std::countr_zero(mask) - index;
+                if (verify_fixed<Pattern>(i)) LIBHAT_UNLIKELY {
+                    return i;
+                }
+                mask &= mask - 1;
+            }
+        }
+
+        if (!post.empty()) {
+            return find_fixed_single<Pattern, alignment>(post.data(), post.data() + post.size());
+        }
+        return nullptr;
+    }
+
+#if !defined(LIBHAT_DISABLE_SSE)
+    template<typename Pattern, scan_alignment alignment>
+    LIBHAT_TARGET("sse2") LIBHAT_FORCEINLINE uint32_t match_fixed_sse(const __m128i data) {
+        constexpr auto index = fixed_anchor<Pattern, alignment>;
+        constexpr auto first = Pattern::elements[index];
+        const auto value = _mm_set1_epi8(static_cast<int8_t>(first.value()));
+
+        uint32_t mask;
+        if constexpr (first.has_value()) {
+            mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(data, value)));
+        } else {
+            const auto bits = _mm_set1_epi8(static_cast<int8_t>(first.mask()));
+            mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(data, bits), value)));
+        }
+
+        if constexpr (fixed_paired<Pattern, alignment>) {
+            const auto second = _mm_set1_epi8(static_cast<int8_t>(*Pattern::elements[index + 1]));
+            const auto mask2 = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(data, second)));
+            // A match of the first byte in the last position implies that the second byte also matched
+            mask &= (mask2 >> 1) | (0b1u << 15);
+        } else if constexpr (alignment != scan_alignment::X1) {
+            mask &= create_alignment_mask<uint16_t, alignment>();
+        }
+        return mask;
+    }
+
+    template<typename Pattern, scan_alignment alignment>
+    LIBHAT_TARGET("sse2") const std::byte* find_fixed_sse(const std::byte* begin, const std::byte* end) {
+        constexpr auto index = fixed_anchor<Pattern, alignment>;
+
+        begin = next_boundary_align<alignment>(begin);
+        if (begin >= end) LIBHAT_UNLIKELY {
+            return nullptr;
+        }
+
+        auto [pre, vec, post] = segment_scan<fixed_vector_128>(begin, end, Pattern::size, index);
+
+        if (!pre.empty()) {
+            if (const auto result = find_fixed_single<Pattern, alignment>(pre.data(), pre.data() + pre.size())) {
+                return result;
+            }
+        }
+
+        for (auto& it : vec) {
+            auto mask = match_fixed_sse<Pattern, alignment>(_mm_load_si128(&it.value));
+            while (mask) {
+                const auto i = reinterpret_cast<const std::byte*>(&it) + std::countr_zero(mask) - index;
+                if (verify_fixed<Pattern>(i)) LIBHAT_UNLIKELY {
+                    return i;
+                }
+                mask &= mask - 1;
+            }
+        }
+
+        if (!post.empty()) {
+            return find_fixed_single<Pattern, alignment>(post.data(), post.data() + post.size());
+        }
+        return nullptr;
+    }
+#endif
+#endif
+
+    /// Runs the instantiation for the instruction set of the selected scan mode. Strides wider than the vectors, as well
+    /// as the other architectures, are scanned per byte.
+    template<typename Pattern, scan_alignment alignment>
+    const std::byte* find_fixed(const std::byte* begin, const std::byte* end) {
+#if defined(LIBHAT_X86)
+        constexpr auto stride = alignment_stride<alignment>;
+        switch (best_scan_mode()) {
+#if !defined(LIBHAT_DISABLE_AVX512)
+            case scan_mode::AVX512:
+                return find_fixed_avx512<Pattern, alignment>(begin, end);
+#endif
+            case scan_mode::AVX2:
+                if constexpr (stride <= sizeof(__m256i)) {
+                    return find_fixed_avx2<Pattern, alignment>(begin, end);
+                }
+                break;
+#if !defined(LIBHAT_DISABLE_SSE)
+            case scan_mode::SSE:
+                if constexpr (stride <= sizeof(__m128i)) {
+                    return find_fixed_sse<Pattern, alignment>(begin, end);
+                }
+                break;
+#endif
+            default:
+                break;
+        }
+#endif
+        return find_fixed_single<Pattern, alignment>(begin, end);
+    }
+}
+
+namespace hat {
+
+    /// Perform a signature scan for a signature literal, such as find_pattern<"48 8B 05 ? ? ? ?">(begin, end). The
+    /// anchor, the vector constants, and the verification of each candidate are specialized for the signature at
+    /// compile time, so the scan is neither dispatched through a scanner function pointer nor does it load the
+    /// signature from memory. The instantiation for the instruction set of the selected scan mode is chosen by a
+    /// switch over the cached selection. Scans through this overload aren't reported to the scan trace hook.
+    template<fixed_string str, scan_alignment alignment = scan_alignment::X1, detail::byte_input_iterator Iter>
+    constexpr auto find_pattern(
+        const Iter beginIt,
+        const Iter endIt
+    ) -> detail::result_type_for<Iter> {
+        using pattern = detail::fixed_pattern<str>;
+        const auto begin = std::to_address(beginIt) + pattern::offset;
+        const auto end = std::to_address(endIt);
+
+        if (begin >= end || pattern::size > static_cast<size_t>(std::distance(begin, end))) {
+            return {nullptr};
+        }
+
+        const std::byte* result;
+        if LIBHAT_IF_CONSTEVAL {
+            result = detail::find_fixed_single<pattern, alignment>(begin, end);
+        } else {
+            result = detail::find_fixed<pattern, alignment>(begin, end);
+        }
+        return result
+            ? const_cast<typename detail::result_type_for<Iter>::underlying_type>(result - pattern::offset)
+            : nullptr;
+    }
+
+    /// Perform a signature scan for a signature literal on a specific section of the process module or a specified
+    /// module
+    template<fixed_string str, scan_alignment alignment = scan_alignment::X1>
+    scan_result find_pattern(
+        const std::string_view  section,
+        const process::module_t mod = process::get_process_module()
+    ) {
+        const auto data = process::get_section_data(mod, section);
+        if (data.empty()) {
+            return nullptr;
+        }
+        return find_pattern<str, alignment>(data.begin(), data.end());
+    }
+}
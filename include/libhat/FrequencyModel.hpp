@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace hat {
+
+    /// Relative frequencies of every byte pair in some kind of data. Scans anchor on the byte pair of the signature that
+    /// is the least frequent according to the model, minimizing the number of candidates that have to be verified.
+    class frequency_model {
+    public:
+        /// Counts every byte pair in the given data
+        [[nodiscard]] static frequency_model from_data(std::span<const std::byte> data);
+
+        /// Counts the byte pairs in evenly spaced blocks of the given data, which bounds the cost for large inputs
+        [[nodiscard]] static frequency_model sample(std::span<const std::byte> data);
+
+        /// Returns the model of x86-64 machine code that is built into the library
+        [[nodiscard]] static const frequency_model& x86_64();
+
+        /// Returns a sampled model of the given data. The model is cached by the address and size of the data, so
+        /// repeated scans of the same range, such as a module section, only sample it once.
+        [[nodiscard]] static std::shared_ptr<const frequency_model> measure(std::span<const std::byte> data);
+
+        /// Returns the number of occurrences of the byte pair, relative to the other pairs in the model
+        [[nodiscard]] uint32_t count(const std::byte first, const std::byte second) const {
+            return this->counts[static_cast<size_t>(first) << 8 | static_cast<size_t>(second)];
+        }
+
+        /// Returns the number of pairs beginning with the byte, relative to the other bytes in the model
+        [[nodiscard]] uint64_t count(const std::byte value) const {
+            return this->byteCounts[static_cast<size_t>(value)];
+        }
+
+        /// Returns the sum of the counts of all byte pairs in the model
+        [[nodiscard]] uint64_t total() const {
+            return this->pairTotal;
+        }
+
+        /// Returns whether the counts were measured from data. The built-in models only rank the most common pairs, so
+        /// their counts don't say how often the other pairs, or the individual bytes, occur.
+        [[nodiscard]] bool is_measured() const {
+            return this->measured;
+        }
+    private:
+        frequency_model() : counts(256 * 256) {}
+
+        void add(std::span<const std::byte> data);
+        void update_totals();
+
+        std::vector<uint32_t> counts;
+        std::array<uint64_t, 256> byteCounts{};
+        uint64_t pairTotal{};
+        bool measured{true};
+    };
+}
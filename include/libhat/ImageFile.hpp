@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "MemoryProtector.hpp"
+#include "Scanner.hpp"
+#include "Signature.hpp"
+
+namespace hat {
+
+    /// A section of an image file, located both in the file and in the image's virtual address space
+    struct image_section {
+        std::string name{};
+        std::span<const std::byte> data{};  // Contents of the section in the file, which may be smaller than its virtual size
+        uintptr_t rva{};                    // Address of the section relative to the image base
+        size_t virtualSize{};
+        protection flags{};
+    };
+
+    /// A PE or ELF image file which is mapped into memory read-only, without loading it as a module. The sections are
+    /// parsed from the raw file layout, so scanning a section only costs the page faults of reading it from disk.
+    class image_file {
+    public:
+        enum class format {
+            PE,
+            ELF
+        };
+
+        /// Maps the image file at the given path. If the file can't be mapped or isn't a PE or ELF image, std::nullopt
+        /// is returned instead
+        [[nodiscard]] static std::optional<image_file> open(const std::filesystem::path& path);
+
+        image_file(const image_file&) = delete;
+        image_file& operator=(const image_file&) = delete;
+        image_file(image_file&& other) noexcept;
+        image_file& operator=(image_file&& other) noexcept;
+        ~image_file();
+
+        [[nodiscard]] format type() const noexcept {
+            return this->fileFormat;
+        }
+
+        /// Returns the contents of the entire file
+        [[nodiscard]] std::span<const std::byte> data() const noexcept {
+            return {this->view, this->size};
+        }
+
+        /// Returns the preferred base address of the image
+        [[nodiscard]] uint64_t image_base() const noexcept {
+            return this->preferredBase;
+        }
+
+        [[nodiscard]] std::span<const image_section> sections() const noexcept {
+            return this->sectionList;
+        }
+
+        /// Returns the contents of a named section in the file, or an empty span if the section doesn't exist
+        [[nodiscard]] std::span<const std::byte> get_section_data(std::string_view name) const;
+
+        /// Translates an address relative to the image base to an offset into the file
+        [[nodiscard]] std::optional<size_t> rva_to_offset(uintptr_t rva) const;
+
+        /// Translates an offset into the file to an address relative to the image base
+        [[nodiscard]] std::optional<uintptr_t> offset_to_rva(size_t offset) const;
+
+        /// Returns a pointer into the file for an address relative to the image base, or nullptr if the address isn't
+        /// backed by the file
+        [[nodiscard]] const std::byte* at_rva(const uintptr_t rva) const {
+            const auto offset = this->rva_to_offset(rva);
+            return offset ? this->view + *offset : nullptr;
+        }
+
+        /// Returns the address relative to the image base of a pointer into the file
+        [[nodiscard]] std::optional<uintptr_t> rva_of(const std::byte* address) const {
+            if (address < this->view || address >= this->view + this->size) {
+                return {};
+            }
+            return this->offset_to_rva(static_cast<size_t>(address - this->view));
+        }
+
+        /// Resolve the relative address located at an offset from the scan result, like scan_result::rel. Sections
+        /// aren't laid out in the file like they are in memory, so the address is resolved in the image's virtual
+        /// address space and translated back into the file. Returns nullptr if the target isn't backed by the file.
+        [[nodiscard]] const std::byte* rel(const const_scan_result result, const size_t offset) const {
+            if (!result.has_result()) {
+                return nullptr;
+            }
+            const auto rva = this->rva_of(result.get() + offset);
+            if (!rva) {
+                return nullptr;
+            }
+            const auto target = *rva + sizeof(int32_t) + static_cast<uintptr_t>(static_cast<intptr_t>(result.read<int32_t>(offset)));
+            return this->at_rva(target);
+        }
+
+        /// Perform a signature scan on a named section of the file. The contents of sections are aligned in the file
+        /// like they are in memory, so aligned scans see the alignment of the loaded image.
+        template<scan_alignment alignment = scan_alignment::X1>
+        [[nodiscard]] const_scan_result find_pattern(
+            const signature_view   signature,
+            const std::string_view section,
+            const scan_hint        hints = scan_hint::none
+        ) const {
+            const auto data = this->get_section_data(section);
+            if (data.empty()) {
+                return nullptr;
+            }
+            return hat::find_pattern<alignment>(data.begin(), data.end(), signature, hints);
+        }
+    private:
+        // A range of the image's virtual address space which is backed by the file
+        struct mapped_range {
+            uintptr_t rva;
+            size_t offset;
+            size_t size;
+        };
+
+        image_file() = default;
+
+        bool parse();
+        bool parse_pe();
+        template<typename Traits>
+        bool parse_elf();
+
+        const std::byte* view{};
+        size_t size{};
+        intptr_t handle{};   // File mapping HANDLE on Windows, unused on Linux
+        format fileFormat{};
+        uint64_t preferredBase{};
+        std::vector<image_section> sectionList{};
+        std::vector<mapped_range> ranges{};
+    };
+}
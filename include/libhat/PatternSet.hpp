@@ -0,0 +1,215 @@
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <span>
+#include <vector>
+
+#include "Concepts.hpp"
+#include "Defines.hpp"
+#include "Process.hpp"
+#include "Scanner.hpp"
+#include "Signature.hpp"
+
+namespace hat {
+
+    namespace detail {
+
+        struct pattern_set_context;
+
+        using pattern_set_scan_function_t = const std::byte*(*)(const std::byte* begin, const std::byte* end, const pattern_set_context& context);
+
+        /// Nibble lookup tables describing a set of bytes, allowing the set membership of 16/32/64 bytes to be tested
+        /// at once with a vector shuffle. For a byte with high nibble h and low nibble n, bit (h % 8) of lo[n] (h < 8)
+        /// or hi[n] (h >= 8) is set if the byte is in the set.
+        struct byte_set_table {
+            alignas(16) std::array<uint8_t, 16> lo{};
+            alignas(16) std::array<uint8_t, 16> hi{};
+
+            constexpr void insert(const std::byte value) {
+                const auto h = static_cast<size_t>(value) >> 4;
+                const auto n = static_cast<size_t>(value) & 0xFu;
+                (h < 8 ? lo[n] : hi[n]) |= static_cast<uint8_t>(1u << (h % 8));
+            }
+        };
+
+        struct pattern_set_context {
+            byte_set_table first{};          // Set of all first anchor bytes
+            byte_set_table second{};         // Set of all second anchor bytes
+            std::bitset<256 * 256> pairs{};  // Set of all anchor pairs, indexed by (first | second << 8)
+            std::bitset<256> singles{};      // Anchor bytes at the end of a signature, which may match the last byte
+            std::array<std::byte, 16> firstBytes{}; // Distinct first anchor bytes, padded by repetition, if there are at most 16
+            size_t firstCount{};                    // Number of distinct first anchor bytes
+            pattern_set_scan_function_t scanner{};
+
+            /// Returns whether the anchor byte (pair) at the given position is present in the set
+            [[nodiscard]] LIBHAT_FORCEINLINE bool is_candidate(const std::byte* ptr, const std::byte* end) const {
+                if (end - ptr > 1) LIBHAT_LIKELY {
+                    return this->pairs[static_cast<size_t>(ptr[0]) | static_cast<size_t>(ptr[1]) << 8];
+                }
+                return this->singles[static_cast<size_t>(ptr[0])];
+            }
+
+            /// Returns the first candidate position in the given range, or end if there is none
+            [[nodiscard]] const std::byte* scan(const std::byte* begin, const std::byte* end) const {
+                return this->scanner(begin, end, *this);
+            }
+
+            void auto_resolve_scanner();
+        };
+
+        struct pattern_set_entry {
+            size_t index{};   // Index of the signature in the span the pattern_set was created with
+            size_t offset{};  // Number of leading wildcards truncated from the signature
+            size_t anchor{};  // Index of the anchor byte in the truncated signature
+            size_t data{};    // Offset of the truncated signature in the pattern_set storage
+            size_t size{};    // Size of the truncated signature
+        };
+
+        template<scan_mode>
+        pattern_set_scan_function_t resolve_pattern_set_scanner(const pattern_set_context&);
+
+        inline const std::byte* find_candidate_single(const std::byte* begin, const std::byte* end, const pattern_set_context& context) {
+            for (auto i = begin; i != end; i++) {
+                if (context.is_candidate(i, end)) {
+                    return i;
+                }
+            }
+            return end;
+        }
+
+        template<>
+        inline pattern_set_scan_function_t resolve_pattern_set_scanner<scan_mode::Single>(const pattern_set_context&) {
+            return &find_candidate_single;
+        }
+    }
+
+    /// A set of signatures that is searched for in a single pass over the input. Every signature is anchored on a byte
+    /// (pair), and all anchors are combined into one lookup table, so the cost of a scan grows with the size of the
+    /// input rather than with the number of signatures times the size of the input. Signatures without any fully
+    /// specified byte can't be anchored, and never match.
+    class pattern_set {
+    public:
+        explicit pattern_set(
+            std::span<const signature_view> signatures,
+            scan_alignment                  alignment = scan_alignment::X1,
+            scan_hint                       hints = scan_hint::none
+        );
+
+        /// Returns the number of signatures in the set
+        [[nodiscard]] size_t size() const noexcept {
+            return this->count;
+        }
+
+        /// Finds the first match for every signature in the set. The returned vector has one element per signature,
+        /// in the order the signatures were provided, and contains nullptr for signatures without a match.
+        template<detail::byte_input_iterator Iter>
+        [[nodiscard]] auto find_first(const Iter beginIt, const Iter endIt) const -> std::vector<detail::result_type_for<Iter>> {
+            using result_t = detail::result_type_for<Iter>;
+            std::vector<result_t> results(this->count);
+            size_t remaining = this->matchable;
+            if (!remaining) {
+                return results;
+            }
+
+            this->scan(std::to_address(beginIt), std::to_address(endIt), [&](const size_t index, const std::byte* match) {
+                if (!results[index].has_result()) {
+                    results[index] = const_cast<typename result_t::underlying_type>(match);
+                    remaining--;
+                }
+                return remaining != 0;
+            });
+            return results;
+        }
+
+        /// Invokes the callback with the signature index and address of every match for every signature in the set.
+        /// The matches of each individual signature are reported in ascending address order. If the callback returns
+        /// a value convertible to bool, returning false stops the scan.
+        template<detail::byte_input_iterator Iter, typename Fn>
+        void find_all(const Iter beginIt, const Iter endIt, Fn&& callback) const {
+            using result_t = detail::result_type_for<Iter>;
+
+            this->scan(std::to_address(beginIt), std::to_address(endIt), [&](const size_t index, const std::byte* match) {
+                const result_t result = const_cast<typename result_t::underlying_type>(match);
+                if constexpr (std::is_convertible_v<std::invoke_result_t<Fn&, size_t, result_t>, bool>) {
+                    return static_cast<bool>(callback(index, result));
+                } else {
+                    callback(index, result);
+                    return true;
+                }
+            });
+        }
+    private:
+        template<typename Fn>
+        void scan(const std::byte* begin, const std::byte* end, Fn&& report) const {
+            const auto stride = static_cast<size_t>(this->alignment);
+
+            for (auto i = begin; i < end; i++) {
+                i = this->context.scan(i, end);
+                if (i == end) {
+                    break;
+                }
+
+                const auto [first, last] = this->buckets[static_cast<size_t>(*i)];
+                for (size_t e = first; e != last; e++) {
+                    const auto& entry = this->entries[e];
+                    if (static_cast<size_t>(i - begin) < entry.offset + entry.anchor) {
+                        continue;
+                    }
+
+                    const auto start = i - entry.anchor;
+                    if (static_cast<size_t>(end - start) < entry.size) {
+                        continue;
+                    }
+                    if (stride != 1 && reinterpret_cast<uintptr_t>(start) % stride != 0) {
+                        continue;
+                    }
+
+                    const signature_view signature{this->storage.data() + entry.data, entry.size};
+                    const auto match = std::equal(signature.begin(), signature.end(), start, [](auto opt, auto byte) {
+                        return opt.matches(byte);
+                    });
+                    if (match && !report(entry.index, start - entry.offset)) {
+                        return;
+                    }
+                }
+            }
+        }
+
+        size_t count{};
+        size_t matchable{};
+        scan_alignment alignment{};
+        std::vector<signature_element> storage{};
+        std::vector<detail::pattern_set_entry> entries{};
+        std::array<std::pair<size_t, size_t>, 256> buckets{}; // Range of entries anchored on each byte value
+        detail::pattern_set_context context{};
+    };
+
+    /// Finds the first match for each of the given signatures in a single pass over the input range. The returned
+    /// vector has one element per signature, containing nullptr for signatures without a match.
+    template<scan_alignment alignment = scan_alignment::X1, detail::byte_input_iterator Iter>
+    auto find_patterns(
+        const Iter                            beginIt,
+        const Iter                            endIt,
+        const std::span<const signature_view> signatures,
+        const scan_hint                       hints = scan_hint::none
+    ) -> std::vector<detail::result_type_for<Iter>> {
+        return pattern_set{signatures, alignment, hints}.find_first(beginIt, endIt);
+    }
+
+    /// Finds the first match for each of the given signatures in a specific section of the process module or a
+    /// specified module
+    template<scan_alignment alignment = scan_alignment::X1>
+    std::vector<scan_result> find_patterns(
+        const std::span<const signature_view> signatures,
+        const std::string_view                section,
+        const process::module_t               mod = process::get_process_module(),
+        const scan_hint                       hints = scan_hint::none
+    ) {
+        const auto data = process::get_section_data(mod, section);
+        if (data.empty()) {
+            return std::vector<scan_result>(signatures.size());
+        }
+        return find_patterns<alignment>(data.begin(), data.end(), signatures, hints);
+    }
+}
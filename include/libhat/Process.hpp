@@ -5,6 +5,9 @@
 #include <string>
 #include <string_view>
 #include <iostream>
+#include <vector>
+
+#include "MemoryProtector.hpp"
 
 namespace hat::process {
 
@@ -27,5 +30,12 @@ namespace hat::process {
     [[nodiscard]] std::span<std::byte> get_module_data(module_t mod);
 
     /// Returns the memory region for a named section in the given module
+    /// On Linux, if the section headers of the module's file are unavailable, the PE section names ".text", ".rdata",
+    /// and ".data" are mapped onto the loadable segment with the corresponding permissions
     [[nodiscard]] std::span<std::byte> get_section_data(module_t mod, std::string_view name);
+
+    /// Returns the committed memory regions of the given module which have at least the given protection flags, in
+    /// ascending address order. Adjacent regions are merged, and guard pages are never included.
+    /// On Windows, the regions are limited to the module's sections, so the headers and any padding are skipped
+    [[nodiscard]] std::vector<std::span<std::byte>> module_regions(module_t mod, protection flags = protection::Read);
 }
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Process.hpp"
+#include "Scanner.hpp"
+#include "Signature.hpp"
+
+namespace hat {
+
+    /// A range of memory in the address space of a remote process
+    struct remote_region {
+        uintptr_t address{};
+        size_t size{};
+
+        [[nodiscard]] constexpr bool empty() const noexcept {
+            return this->size == 0;
+        }
+
+        [[nodiscard]] constexpr uintptr_t end() const noexcept {
+            return this->address + this->size;
+        }
+    };
+
+    /// A handle to another process which allows reading and scanning its memory. The modules of the remote process are
+    /// identified by their base address within the remote process.
+    class remote_process {
+    public:
+        /// Opens the process with the given id for reading. If the process can't be opened, std::nullopt is returned
+        /// instead
+        [[nodiscard]] static std::optional<remote_process> open(uint32_t pid);
+
+        remote_process(const remote_process&) = delete;
+        remote_process& operator=(const remote_process&) = delete;
+        remote_process(remote_process&& other) noexcept;
+        remote_process& operator=(remote_process&& other) noexcept;
+        ~remote_process();
+
+        [[nodiscard]] uint32_t pid() const noexcept {
+            return this->id;
+        }
+
+        /// Reads the memory at the given address into the buffer. Returns false if any part of it couldn't be read.
+        bool read(uintptr_t address, std::span<std::byte> buffer) const;
+
+        /// Returns the module for the remote process's base executable
+        [[nodiscard]] std::optional<process::module_t> get_process_module() const;
+
+        /// Returns an optional containing the module with the given name in the remote process
+        /// If the module is not found, std::nullopt is returned instead
+        [[nodiscard]] std::optional<process::module_t> get_module(const std::string& name) const;
+
+        /// Returns the complete memory region for the given module. This may include portions which are uncommitted.
+        [[nodiscard]] remote_region get_module_data(process::module_t mod) const;
+
+        /// Returns the memory region for a named section in the given module
+        [[nodiscard]] remote_region get_section_data(process::module_t mod, std::string_view name) const;
+
+        /// Perform a signature scan on a region of the remote process. The region is read in fixed size windows into
+        /// two buffers, such that one window is scanned while the next one is read. Windows which can't be read are
+        /// skipped. The data is never available in its entirety, so scan_hint::measure has no effect.
+        template<scan_alignment alignment = scan_alignment::X1>
+        [[nodiscard]] std::optional<uintptr_t> find_pattern(
+            remote_region  region,
+            signature_view signature,
+            scan_hint      hints = scan_hint::none
+        ) const;
+
+        /// Perform a signature scan on a specific section of a module in the remote process
+        template<scan_alignment alignment = scan_alignment::X1>
+        [[nodiscard]] std::optional<uintptr_t> find_pattern(
+            signature_view    signature,
+            std::string_view  section,
+            process::module_t mod,
+            scan_hint         hints = scan_hint::none
+        ) const;
+
+        /// Finds all of the matches for the signature in a region of the remote process, in ascending address order
+        template<scan_alignment alignment = scan_alignment::X1>
+        [[nodiscard]] std::vector<uintptr_t> find_all_pattern(
+            remote_region  region,
+            signature_view signature,
+            scan_hint      hints = scan_hint::none
+        ) const;
+    private:
+        remote_process(uint32_t pid, intptr_t handle) : id(pid), handle(handle) {}
+
+        uint32_t id{};
+        intptr_t handle{}; // HANDLE on Windows, file descriptor of the process's memory on Linux
+    };
+
+    namespace detail {
+
+        /// Scans the remote range in windows, and returns the address of the first match
+        std::optional<uintptr_t> find_pattern_remote(const remote_process& process, uintptr_t begin, uintptr_t end, const scan_context& context);
+
+        /// Scans the remote range in windows, and returns the addresses of all matches in ascending order
+        std::vector<uintptr_t> find_all_pattern_remote(const remote_process& process, uintptr_t begin, uintptr_t end, const scan_context& context);
+    }
+
+    template<scan_alignment alignment>
+    std::optional<uintptr_t> remote_process::find_pattern(const remote_region region, const signature_view signature, const scan_hint hints) const {
+        const auto [offset, trunc] = detail::truncate(signature);
+        const auto begin = region.address + offset;
+        const auto end = region.end();
+
+        if (trunc.empty() || begin >= end || trunc.size() > end - begin) {
+            return {};
+        }
+
+        const auto context = detail::scan_context::create(trunc, alignment, hints);
+        if (const auto result = detail::find_pattern_remote(*this, begin, end, context); result.has_value()) {
+            return *result - offset;
+        }
+        return {};
+    }
+
+    template<scan_alignment alignment>
+    std::optional<uintptr_t> remote_process::find_pattern(const signature_view signature, const std::string_view section, const process::module_t mod, const scan_hint hints) const {
+        const auto region = this->get_section_data(mod, section);
+        if (region.empty()) {
+            return {};
+        }
+        return this->find_pattern<alignment>(region, signature, hints);
+    }
+
+    template<scan_alignment alignment>
+    std::vector<uintptr_t> remote_process::find_all_pattern(const remote_region region, const signature_view signature, const scan_hint hints) const {
+        const auto [offset, trunc] = detail::truncate(signature);
+        const auto begin = region.address + offset;
+        const auto end = region.end();
+
+        if (trunc.empty() || begin >= end || trunc.size() > end - begin) {
+            return {};
+        }
+
+        const auto context = detail::scan_context::create(trunc, alignment, hints);
+        auto results = detail::find_all_pattern_remote(*this, begin, end, context);
+        for (auto& result : results) {
+            result -= offset;
+        }
+        return results;
+    }
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Process.hpp"
+#include "Scanner.hpp"
+#include "Signature.hpp"
+
+namespace hat {
+
+    /// Remembers where signatures were found in a module across runs of a program. Each match is recorded as an
+    /// address relative to the module base, keyed by the signature, the section, and the alignment, as well as the
+    /// identity of the module. The identity combines the PE TimeDateStamp and CheckSum with a hash of the section's
+    /// contents, so a cached match is only ever used for the exact same binary. Cached matches are still verified
+    /// against the signature before they are returned, and a full scan is performed whenever verification fails or the
+    /// signature isn't cached. The cache isn't thread safe.
+    class resolution_cache {
+    public:
+        resolution_cache() = default;
+
+        /// Loads a cache from the file at the given path. If the file doesn't exist or isn't a valid cache, the
+        /// returned cache is empty.
+        [[nodiscard]] static resolution_cache load(const std::filesystem::path& path);
+
+        /// Writes the cache to the file at the given path, and returns whether it succeeded
+        bool save(const std::filesystem::path& path) const;
+
+        /// Perform a signature scan on a specific section of the process module or a specified module, unless the
+        /// cache holds a match for the signature in the same binary
+        template<scan_alignment alignment = scan_alignment::X1>
+        scan_result find_pattern(
+            const signature_view    signature,
+            const std::string_view  section,
+            const process::module_t mod = process::get_process_module(),
+            const scan_hint         hints = scan_hint::none
+        ) {
+            const auto data = process::get_section_data(mod, section);
+            if (data.empty()) {
+                return nullptr;
+            }
+
+            auto* const base = reinterpret_cast<std::byte*>(mod);
+            const auto key = signature_key(signature, section, alignment);
+            const auto image = this->image_key(mod, section, data);
+
+            if (const auto rva = this->lookup(key, image); rva.has_value()) {
+                const auto offset = static_cast<size_t>(base + *rva - data.data());
+                if (base + *rva >= data.data() && offset < data.size() && data.size() - offset >= signature.size()) {
+                    const auto match = std::equal(signature.begin(), signature.end(), data.data() + offset, [](auto opt, auto byte) {
+                        return opt.matches(byte);
+                    });
+                    if (match) {
+                        return data.data() + offset;
+                    }
+                }
+            }
+
+            const auto result = hat::find_pattern<alignment>(data.begin(), data.end(), signature, hints);
+            if (result.has_result()) {
+                this->insert(key, image, static_cast<uint64_t>(result.get() - base));
+            }
+            return result;
+        }
+
+        /// Returns the number of cached matches
+        [[nodiscard]] size_t size() const noexcept {
+            return this->entries.size();
+        }
+
+        /// Removes every cached match
+        void clear() noexcept {
+            this->entries.clear();
+            this->images.clear();
+        }
+    private:
+        // Layout of the records in the cache file, which are sorted by the signature and image keys
+        struct entry {
+            uint64_t signature;
+            uint64_t image;
+            uint64_t rva;
+        };
+
+        // Identity of a section of a module, which is only computed once per cache instance
+        struct image_identity {
+            process::module_t mod;
+            std::string section;
+            uint64_t key;
+        };
+
+        static uint64_t signature_key(signature_view signature, std::string_view section, scan_alignment alignment);
+        uint64_t image_key(process::module_t mod, std::string_view section, std::span<const std::byte> data);
+        [[nodiscard]] std::optional<uint64_t> lookup(uint64_t signature, uint64_t image) const;
+        void insert(uint64_t signature, uint64_t image, uint64_t rva);
+
+        std::vector<entry> entries{};
+        std::vector<image_identity> images{};
+    };
+}
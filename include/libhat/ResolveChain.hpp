@@ -0,0 +1,105 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "Process.hpp"
+#include "Scanner.hpp"
+#include "Signature.hpp"
+
+namespace hat {
+
+    enum class resolve_op : uint8_t {
+        rel,   // Resolve the 32-bit relative address at the offset, like scan_result::rel
+        deref, // Read the pointer at the offset
+        add    // Add the operand to the address
+    };
+
+    struct resolve_step {
+        resolve_op op{};
+        int64_t operand{};
+    };
+
+    /// Maximum number of steps in a resolve_chain
+    inline constexpr size_t max_resolve_steps = 8;
+
+    /// A sequence of steps which turns a signature match into the address it refers to, e.g. "match, rel32 at +3, deref,
+    /// add 0x10" is written as resolve_chain{}.rel(3).deref().add(0x10). The steps are stored inline, so that chains can
+    /// be declared constexpr next to their signatures and resolved in batch without any allocation or callback. Every
+    /// read and the final address are validated against the bounds given when resolving, typically the module.
+    class resolve_chain {
+    public:
+        constexpr resolve_chain() = default;
+
+        /// Resolves the 32-bit relative address located at an offset from the current address
+        constexpr resolve_chain& rel(const size_t offset) {
+            return this->push({resolve_op::rel, static_cast<int64_t>(offset)});
+        }
+
+        /// Reads the pointer located at an offset from the current address
+        constexpr resolve_chain& deref(const size_t offset = 0) {
+            return this->push({resolve_op::deref, static_cast<int64_t>(offset)});
+        }
+
+        /// Adds a displacement to the current address
+        constexpr resolve_chain& add(const ptrdiff_t value) {
+            return this->push({resolve_op::add, static_cast<int64_t>(value)});
+        }
+
+        /// Returns whether the chain fits in max_resolve_steps. A chain with more steps never resolves.
+        [[nodiscard]] constexpr bool valid() const noexcept {
+            return this->count <= max_resolve_steps;
+        }
+
+        [[nodiscard]] constexpr std::span<const resolve_step> steps() const noexcept {
+            return {this->data.data(), this->valid() ? this->count : 0};
+        }
+
+        /// Applies the chain to a match. Returns nullptr if the match is nullptr, if any step reads memory outside of
+        /// the bounds, or if the resolved address lies outside of the bounds.
+        [[nodiscard]] scan_result resolve(scan_result match, std::span<std::byte> bounds) const;
+    private:
+        constexpr resolve_chain& push(const resolve_step step) {
+            if (this->count < max_resolve_steps) {
+                this->data[this->count] = step;
+            }
+            this->count += this->count <= max_resolve_steps;
+            return *this;
+        }
+
+        std::array<resolve_step, max_resolve_steps> data{};
+        size_t count{};
+    };
+
+    /// Applies each chain to the match at the same index. The returned vector has one element per match, matches
+    /// without a chain are returned as they are.
+    [[nodiscard]] std::vector<scan_result> resolve_all(
+        std::span<const scan_result>   matches,
+        std::span<const resolve_chain> chains,
+        std::span<std::byte>           bounds
+    );
+
+    /// Finds the first match for each of the signatures in a single pass over the range, and applies the chain at the
+    /// same index to it. The reads and the resolved addresses are validated against the bounds.
+    [[nodiscard]] std::vector<scan_result> find_and_resolve(
+        std::span<const signature_view> signatures,
+        std::span<const resolve_chain>  chains,
+        std::span<std::byte>            range,
+        std::span<std::byte>            bounds,
+        scan_alignment                  alignment = scan_alignment::X1
+    );
+
+    /// Finds the first match for each of the signatures in a specific section of the process module or a specified
+    /// module, and applies the chain at the same index to it. The resolved addresses must lie within the module.
+    [[nodiscard]] std::vector<scan_result> find_and_resolve(
+        std::span<const signature_view> signatures,
+        std::span<const resolve_chain>  chains,
+        std::string_view                section,
+        process::module_t               mod = process::get_process_module(),
+        scan_alignment                  alignment = scan_alignment::X1
+    );
+}
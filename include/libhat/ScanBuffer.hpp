@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+namespace hat {
+
+    struct scan_buffer_options {
+        bool largePages = true;         // Back the buffer with large pages, if the system allows it
+        std::optional<uint32_t> node{}; // The NUMA node to place the buffer on, or any node
+    };
+
+    /// A buffer for data that is copied in to be scanned, such as a memory dump. Scanning reads every byte once at the
+    /// throughput of the vectorized scanners, so with 4 KiB pages a noticeable part of the time goes to TLB misses, and
+    /// on a multi-socket system reading the memory of another node halves the throughput. The buffer is backed by large
+    /// pages where possible, and can be placed on a given NUMA node. The parallel scanners schedule each chunk of the
+    /// input on the node which owns its memory, whether or not it is a scan_buffer.
+    class scan_buffer {
+    public:
+        /// Allocates a zero-initialized buffer of the given size. Large pages are a best-effort request, the buffer
+        /// falls back to regular pages if they aren't available. If the requested node doesn't exist or the memory
+        /// can't be placed on it, or the allocation itself fails, std::nullopt is returned instead.
+        [[nodiscard]] static std::optional<scan_buffer> allocate(size_t size, const scan_buffer_options& options = {});
+
+        scan_buffer(const scan_buffer&) = delete;
+        scan_buffer& operator=(const scan_buffer&) = delete;
+        scan_buffer(scan_buffer&& other) noexcept;
+        scan_buffer& operator=(scan_buffer&& other) noexcept;
+        ~scan_buffer();
+
+        [[nodiscard]] std::byte* data() const noexcept {
+            return this->memory;
+        }
+
+        [[nodiscard]] size_t size() const noexcept {
+            return this->length;
+        }
+
+        [[nodiscard]] std::byte* begin() const noexcept {
+            return this->memory;
+        }
+
+        [[nodiscard]] std::byte* end() const noexcept {
+            return this->memory + this->length;
+        }
+
+        [[nodiscard]] std::span<std::byte> span() const noexcept {
+            return {this->memory, this->length};
+        }
+
+        /// Returns whether large pages were granted for the buffer. On Linux, this means that the kernel accepted the
+        /// advice to use transparent huge pages for the buffer.
+        [[nodiscard]] bool large_pages() const noexcept {
+            return this->largePages;
+        }
+
+        /// Returns the NUMA node the buffer was placed on, if one was requested
+        [[nodiscard]] std::optional<uint32_t> node() const noexcept {
+            return this->numaNode;
+        }
+    private:
+        scan_buffer() = default;
+
+        void release() noexcept;
+
+        std::byte* memory{};
+        size_t length{};
+        std::byte* mapping{}; // The allocation containing the buffer, which may begin before it
+        size_t mappingSize{};
+        bool largePages{};
+        std::optional<uint32_t> numaNode{};
+    };
+
+    /// Returns the number of NUMA nodes of the system, which is 1 for a system that isn't NUMA
+    [[nodiscard]] size_t numa_node_count();
+
+    /// Returns the NUMA node which owns the memory at the address, or std::nullopt if it can't be determined
+    [[nodiscard]] std::optional<uint32_t> numa_node_of(const void* address);
+}
+
+namespace hat::detail {
+
+    /// Restricts the current thread to the processors of the NUMA node. Returns whether the affinity was changed.
+    bool bind_thread_to_node(uint32_t node);
+
+    /// Pins the number of NUMA nodes the parallel scanners schedule the chunks for, so that the NUMA scheduling can be
+    /// used on a system with a single node or processor. std::nullopt unpins the count.
+    void pin_numa_node_count(std::optional<size_t> count);
+
+    /// Returns the pinned NUMA node count, if one is pinned
+    [[nodiscard]] std::optional<size_t> pinned_numa_node_count();
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <coroutine>
+#include <functional>
+#include <future>
+#include <memory>
+#include <span>
+#include <string_view>
+
+#include "Process.hpp"
+#include "Scanner.hpp"
+#include "Signature.hpp"
+
+namespace hat {
+
+    namespace detail {
+        struct scan_scheduler_state;
+    }
+
+    class scan_awaitable;
+
+    /// Runs signature scans on a fixed pool of worker threads, e.g. to resolve the signatures of several modules during
+    /// startup without blocking the calling thread or creating a thread per scan. Jobs which target the same range with
+    /// the same alignment and are pending at the same time are combined into a single pattern_set pass. Every pass is
+    /// split into chunks which are queued on the worker that started it, and idle workers steal chunks from the others,
+    /// so that a few large sections are still spread across all workers.
+    class scan_scheduler {
+    public:
+        /// Creates the worker pool, using one thread per hardware thread if the count is zero
+        explicit scan_scheduler(size_t threads = 0);
+
+        scan_scheduler(const scan_scheduler&) = delete;
+        scan_scheduler& operator=(const scan_scheduler&) = delete;
+
+        /// Completes every job that was submitted, then stops the workers
+        ~scan_scheduler();
+
+        /// Returns the number of worker threads
+        [[nodiscard]] size_t size() const noexcept;
+
+        /// Queues a scan for the first match of the signature in the range. The signature is copied, but the range must
+        /// stay valid until the job is completed. The callback is invoked on a worker thread.
+        void submit(
+            signature_view                   signature,
+            std::span<std::byte>             range,
+            scan_alignment                   alignment,
+            std::function<void(scan_result)> callback
+        );
+
+        /// Queues a scan for the first match of the signature in the range, and returns a future for its result
+        [[nodiscard]] std::future<scan_result> submit(
+            signature_view       signature,
+            std::span<std::byte> range,
+            scan_alignment       alignment = scan_alignment::X1
+        );
+
+        /// Queues a scan for the first match of the signature in a specific section of the process module or a
+        /// specified module, and returns a future for its result
+        [[nodiscard]] std::future<scan_result> submit(
+            signature_view    signature,
+            std::string_view  section,
+            process::module_t mod = process::get_process_module(),
+            scan_alignment    alignment = scan_alignment::X1
+        );
+
+        /// Queues a scan for each of the signatures in the range, which are guaranteed to be scanned in a single pass.
+        /// The returned vector has one future per signature, in the order the signatures were provided.
+        [[nodiscard]] std::vector<std::future<scan_result>> submit(
+            std::span<const signature_view> signatures,
+            std::span<std::byte>            range,
+            scan_alignment                  alignment = scan_alignment::X1
+        );
+
+        /// Returns an awaitable which queues a scan for the first match of the signature in the range when it is
+        /// awaited. The awaiting coroutine is resumed on a worker thread.
+        [[nodiscard]] scan_awaitable schedule(
+            signature_view       signature,
+            std::span<std::byte> range,
+            scan_alignment       alignment = scan_alignment::X1
+        );
+
+        /// Returns an awaitable which queues a scan for the first match of the signature in a specific section of the
+        /// process module or a specified module when it is awaited
+        [[nodiscard]] scan_awaitable schedule(
+            signature_view    signature,
+            std::string_view  section,
+            process::module_t mod = process::get_process_module(),
+            scan_alignment    alignment = scan_alignment::X1
+        );
+    private:
+        std::unique_ptr<detail::scan_scheduler_state> state;
+    };
+
+    class scan_awaitable {
+    public:
+        [[nodiscard]] bool await_ready() const noexcept {
+            return false;
+        }
+
+        void await_suspend(const std::coroutine_handle<> handle) {
+            this->scheduler->submit(this->pattern, this->range, this->alignment, [this, handle](const scan_result result) {
+                this->result = result;
+                handle.resume();
+            });
+        }
+
+        [[nodiscard]] scan_result await_resume() const noexcept {
+            return this->result;
+        }
+    private:
+        friend class scan_scheduler;
+
+        scan_awaitable(scan_scheduler& scheduler, const signature_view signature, const std::span<std::byte> range, const scan_alignment alignment)
+            : scheduler(&scheduler), pattern(signature.begin(), signature.end()), range(range), alignment(alignment) {}
+
+        scan_scheduler* scheduler;
+        signature pattern;
+        std::span<std::byte> range;
+        scan_alignment alignment;
+        scan_result result{};
+    };
+
+    inline scan_awaitable scan_scheduler::schedule(const signature_view signature, const std::span<std::byte> range, const scan_alignment alignment) {
+        return {*this, signature, range, alignment};
+    }
+
+    inline scan_awaitable scan_scheduler::schedule(
+        const signature_view    signature,
+        const std::string_view  section,
+        const process::module_t mod,
+        const scan_alignment    alignment
+    ) {
+        return {*this, signature, process::get_section_data(mod, section), alignment};
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "Scanner.hpp"
+
+namespace hat {
+
+    /// Whether libhat was built with LIBHAT_SCAN_STATS. Without it, the scanners aren't instrumented at all, and no
+    /// statistics are ever collected or reported to the trace hook.
+    inline constexpr bool scan_stats_enabled =
+#if defined(LIBHAT_SCAN_STATS)
+        true;
+#else
+        false;
+#endif
+
+    /// Describes a single scan of a signature over a contiguous range
+    struct scan_stats {
+        scan_mode             mode{};           // The mode of the scanner which performed the scan
+        scan_alignment        alignment{};
+        size_t                signatureSize{};  // Size of the signature, excluding leading wildcards
+        std::optional<size_t> anchorOffset{};   // Offset of the byte pair the scan was anchored on, if any
+        size_t                anchorDistance{}; // Distance between the two bytes of the anchor pair
+        size_t                bytesScanned{};   // Size of the range up to the end of the match the scan stopped at
+        size_t                candidates{};     // Positions which were compared against the full signature
+        size_t                verifyFailures{}; // Candidates which didn't match the signature
+        size_t                matches{};
+        std::chrono::nanoseconds elapsed{};
+    };
+
+    /// Receives the statistics of every scan on any thread, after the scan has finished
+    using scan_trace_hook = void(*)(const scan_stats& stats, void* user);
+
+    /// Installs a hook that receives the statistics of every scan, or removes it if nullptr is given. The hook is
+    /// invoked on the thread which performed the scan, so it has to be thread safe if scans run concurrently.
+    void set_scan_trace_hook(scan_trace_hook hook, void* user = nullptr);
+
+    /// Collects the statistics of every scan which is performed on the constructing thread while the collector is
+    /// alive. Parallel scans are split into scans of their chunks, which are only collected when they are performed
+    /// on this thread. If collectors are nested, only the innermost receives the statistics.
+    class scan_stats_collector {
+    public:
+        scan_stats_collector();
+        ~scan_stats_collector();
+
+        scan_stats_collector(const scan_stats_collector&) = delete;
+        scan_stats_collector& operator=(const scan_stats_collector&) = delete;
+
+        /// Returns the statistics of the collected scans, in the order they finished
+        [[nodiscard]] std::span<const scan_stats> scans() const noexcept {
+            return this->records;
+        }
+
+        void clear() noexcept {
+            this->records.clear();
+        }
+    private:
+        friend const_scan_result detail::traced_scan(const detail::scan_context&, const std::byte*, const std::byte*, detail::match_sink*);
+
+        scan_stats_collector* previous{};
+        std::vector<scan_stats> records{};
+    };
+}
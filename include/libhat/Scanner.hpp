@@ -2,11 +2,17 @@
 
 #include <algorithm>
 #include <array>
+#include <chrono>
+#include <concepts>
 #include <execution>
+#include <optional>
+#include <span>
+#include <type_traits>
 #include <utility>
 
 #include "Concepts.hpp"
 #include "Defines.hpp"
+#include "FrequencyModel.hpp"
 #include "Process.hpp"
 #include "Signature.hpp"
 
@@ -61,13 +67,23 @@ namespace hat {
 
     enum class scan_alignment {
         X1 = 1,
-        X16 = 16
+        X2 = 2,
+        X4 = 4,
+        X8 = 8,
+        X16 = 16,
+        X32 = 32,
+        X64 = 64
     };
 
+    /// The alignment of pointers on the target platform, for scanning for pointers stored in data sections
+    inline constexpr scan_alignment pointer_alignment = sizeof(void*) == 8 ? scan_alignment::X8 : scan_alignment::X4;
+
     enum class scan_hint : uint64_t {
         none   = 0,      // no hints
         x86_64 = 1 << 0, // The data being scanned is x86_64 machine code
         pair0  = 1 << 1, // Only utilize byte pair based scanning if the signature starts with a byte pair
+        measure = 1 << 2, // Measure the byte pair frequencies of the data being scanned to select the rarest byte pair
+        streaming = 1 << 3, // The data is much larger than the cache and scanned once, prefetch ahead of the scan
     };
 
     constexpr scan_hint operator|(scan_hint lhs, scan_hint rhs) {
@@ -80,14 +96,98 @@ namespace hat {
         return static_cast<scan_hint>(static_cast<U>(lhs) & static_cast<U>(rhs));
     }
 
+    enum class scan_mode {
+        Single, // std::find + std::equal
+        SSE,    // x86 SSE 4.1
+        AVX2,   // x86 AVX2
+        AVX512, // x86 AVX512
+        NEON,   // ARM NEON
+        SVE2,   // ARM SVE2
+    };
+
+    /// Returns whether the scanner for the mode is compiled in and supported by the current system
+    [[nodiscard]] bool is_scan_mode_supported(scan_mode mode);
+
+    /// Pins the scan mode used by scans which are resolved from now on, or removes the pin if std::nullopt is given.
+    /// A pinned mode that isn't supported by the current system, or that has been disabled, is ignored.
+    void pin_scan_mode(std::optional<scan_mode> mode);
+
+    /// Excludes a scan mode from being selected at runtime, or allows it again. Unless a mode is pinned, the fastest
+    /// supported mode that hasn't been disabled is used. scan_mode::Single can't be disabled.
+    void set_scan_mode_enabled(scan_mode mode, bool enabled);
+
+    /// Returns the scan mode which is used by scans that don't request a specific mode
+    [[nodiscard]] scan_mode selected_scan_mode();
+
+    /// Times a scan in every supported and enabled mode on a generated buffer, then pins the fastest of them. This
+    /// takes in the order of a few milliseconds, and is meant to be called once at startup on systems where the widest
+    /// vectors aren't the fastest, e.g. due to AVX512 frequency licensing.
+    scan_mode calibrate_scan_mode();
+
+    /// Sets how far ahead of the scan position, in bytes, the AVX2 and AVX512 scanners of scans resolved with
+    /// scan_hint::streaming from now on prefetch. A distance of 0 disables the prefetching.
+    void set_prefetch_distance(size_t distance);
+
+    /// Returns the distance that scans with scan_hint::streaming prefetch ahead of the scan position
+    [[nodiscard]] size_t prefetch_distance();
+
     namespace detail {
 
         class scan_context;
 
-        using scan_function_t = const_scan_result(*)(const std::byte* begin, const std::byte* end, const scan_context& context);
+        /// Receives the matches reported by a scanner in all matches mode, in ascending address order. If there is a
+        /// buffer, matches are written into it until it is full. Otherwise, matches are passed to the callback until it
+        /// returns false, or only counted if there is no callback either.
+        struct match_sink {
+            const_scan_result* buffer{};
+            size_t capacity{};
+            bool (*callback)(void* user, const std::byte* match){};
+            void* user{};
+            size_t count{};
+
+            /// Records a match, and returns whether the scanner should continue
+            constexpr bool push(const std::byte* match) {
+                if (this->buffer) {
+                    this->buffer[this->count++] = match;
+                    return this->count < this->capacity;
+                }
+                this->count++;
+                return !this->callback || this->callback(this->user, match);
+            }
+        };
+
+        /// Returns whether a scanner should stop at a match. Without a sink, the scanner only looks for the first match.
+        LIBHAT_FORCEINLINE constexpr bool stop_at(match_sink* sink, const std::byte* match) {
+            return !sink || !sink->push(match);
+        }
+
+#if defined(LIBHAT_SCAN_STATS)
+        /// The number of candidates the scanners on the current thread have compared against a signature, which is
+        /// attributed to the scan in progress by traced_scan
+        inline thread_local size_t candidateCount{};
+#endif
+
+        /// Records that a scanner compares a candidate against the full signature, if scan statistics are compiled in
+        LIBHAT_FORCEINLINE constexpr void count_candidate() {
+#if defined(LIBHAT_SCAN_STATS)
+            if LIBHAT_IF_CONSTEVAL {
+                return;
+            } else {
+                candidateCount++;
+            }
+#endif
+        }
+
+        /// Runs the scanner of the context while collecting scan_stats for it, see ScanStats.hpp
+        const_scan_result traced_scan(const scan_context& context, const std::byte* begin, const std::byte* end, match_sink* sink);
+
+        /// Scans the range for the signature of the context. Without a sink, returns the first match. With a sink, every
+        /// match is reported to it in a single pass, and the match at which the sink stopped the scan is returned.
+        using scan_function_t = const_scan_result(*)(const std::byte* begin, const std::byte* end, const scan_context& context, match_sink* sink);
 
         struct scanner_context {
             size_t vectorSize{};
+            bool farPairs{}; // Whether the scanner compares a pair at any offset, rather than only in the first vector
         };
 
         class scan_context {
@@ -97,26 +197,99 @@ namespace hat {
             scan_alignment alignment{};
             scan_hint hints{};
             std::optional<size_t> pairIndex{};
+            size_t pairDistance{1}; // Distance from the first to the second byte of the pair, which may not be adjacent
+            size_t prefetchDistance{}; // Distance ahead of the scan position that is prefetched, only with streaming
+
+            // Byte pair frequencies used for selecting the pair index, only referenced while resolving the scanner
+            const frequency_model* model{};
+
+            // The scan mode requested for this context, which takes precedence over the global selection if it is
+            // supported by the current system
+            std::optional<scan_mode> mode{};
+
+            // The scan mode of the resolved scanner, which falls back to a narrower mode than the selected one for
+            // signatures that the selected mode can't scan
+            scan_mode resolvedMode{};
+
+            // Length of the signature up to its last solid element. Trailing wildcards are never compared, but a match
+            // still requires the entire signature to fit into the range, so that reading them stays in bounds.
+            size_t verifyLength{};
+
+            // Bit i is set if any of the preloaded bytes [16 * i, 16 * i + 16) has to match, so that verifying a sparse
+            // signature only compares the vectors covering its solid segments
+            uint16_t solidBlocks{};
+
+            // The leading signature bytes and the mask of the bits in each of them that have to match, loaded by the
+            // vectorized scanners. Signatures longer than a single vector are compared in multiple vectors.
+            alignas(64) std::array<std::byte, 256> vectorBytes{};
+            alignas(64) std::array<std::byte, 256> vectorMask{};
 
             [[nodiscard]] constexpr const_scan_result scan(const std::byte* begin, const std::byte* end) const {
-                return this->scanner(begin, end, *this);
+#if defined(LIBHAT_SCAN_STATS)
+                if LIBHAT_IF_CONSTEVAL {
+                    return this->scanner(begin, end, *this, nullptr);
+                } else {
+                    return traced_scan(*this, begin, end, nullptr);
+                }
+#else
+                return this->scanner(begin, end, *this, nullptr);
+#endif
             }
 
-            void auto_resolve_scanner();
-            void apply_hints(const scanner_context&);
+            /// Returns the number of bytes the vectorized scanners compare at each candidate, the preloaded part of the
+            /// signature rounded up to whole vectors
+            [[nodiscard]] constexpr size_t verify_size(const size_t vectorSize) const {
+                const auto preloaded = std::min(this->verifyLength, this->vectorBytes.size());
+                return (preloaded + vectorSize - 1) / vectorSize * vectorSize;
+            }
+
+            /// Returns whether any of the preloaded bytes [offset, offset + size) has to match, for a multiple of 16
+            [[nodiscard]] constexpr bool is_solid(const size_t offset, const size_t size) const {
+                const auto blocks = static_cast<uint32_t>((1u << (size / 16)) - 1) << (offset / 16);
+                return (this->solidBlocks & blocks) != 0;
+            }
+
+            /// Compares the part of the signature that wasn't preloaded, if any, against a candidate
+            [[nodiscard]] bool verify_tail(const std::byte* candidate) const {
+                const auto preloaded = std::min(this->verifyLength, this->vectorBytes.size());
+                return std::equal(this->signature.begin() + preloaded, this->signature.begin() + this->verifyLength, candidate + preloaded, [](auto opt, auto byte) {
+                    return opt.matches(byte);
+                });
+            }
+
+            /// Reports every match in the range to the sink. Returns the match at which the sink stopped the scan, or
+            /// nullptr if the entire range was scanned.
+            constexpr const_scan_result scan_all(const std::byte* begin, const std::byte* end, match_sink& sink) const {
+#if defined(LIBHAT_SCAN_STATS)
+                if LIBHAT_IF_CONSTEVAL {
+                    return this->scanner(begin, end, *this, &sink);
+                } else {
+                    return traced_scan(*this, begin, end, &sink);
+                }
+#else
+                return this->scanner(begin, end, *this, &sink);
+#endif
+            }
 
-            static constexpr scan_context create(signature_view signature, scan_alignment alignment, scan_hint hints);
+            void auto_resolve_scanner(std::span<const std::byte> data = {});
+            void apply_hints(const scanner_context&);
+            constexpr void preload_vectors();
+
+            /// Creates the context for scanning for the signature. The data that is going to be scanned is measured if
+            /// scan_hint::measure is specified, otherwise the given model is used, if any. If a mode is given, the
+            /// scanner of that mode is used instead of the one selected for the system, as long as it is supported.
+            static constexpr scan_context create(
+                signature_view             signature,
+                scan_alignment             alignment,
+                scan_hint                  hints,
+                std::span<const std::byte> data = {},
+                const frequency_model*     model = nullptr,
+                std::optional<scan_mode>   mode = std::nullopt
+            );
         private:
             scan_context() = default;
         };
 
-        enum class scan_mode {
-            Single, // std::find + std::equal
-            SSE,    // x86 SSE 4.1
-            AVX2,   // x86 AVX2
-            AVX512, // x86 AVX512
-        };
-
         template<scan_alignment alignment>
         inline constexpr auto alignment_stride = static_cast<std::underlying_type_t<scan_alignment>>(alignment);
 
@@ -150,20 +323,25 @@ namespace hat {
             return std::assume_aligned<stride>(ptr - mod);
         }
 
-        template<typename Type>
-        LIBHAT_FORCEINLINE const std::byte* align_pointer_as(const std::byte* ptr) {
-            constexpr size_t alignment = alignof(Type);
+        template<size_t alignment>
+        LIBHAT_FORCEINLINE const std::byte* align_pointer_to(const std::byte* ptr) {
             const uintptr_t mod = reinterpret_cast<uintptr_t>(ptr) % alignment;
             ptr += mod ? alignment - mod : 0;
             return std::assume_aligned<alignment>(ptr);
         }
 
+        /// Splits the range into the parts before and after the aligned vectors, which are scanned per byte, and the
+        /// vectors themselves. Every vector is followed by at least max(signatureSize, readSize) bytes, so that reading
+        /// readSize bytes from any candidate compared within the vectors stays in bounds. The vectors are aligned to
+        /// their size rather than to alignof(Vector), which is only 16 for the intrinsic types of instruction sets
+        /// that are enabled with LIBHAT_TARGET_BEGIN instead of for the entire translation unit.
         template<typename Vector>
         LIBHAT_FORCEINLINE auto segment_scan(
             const std::byte* begin,
             const std::byte* end,
             const size_t signatureSize,
-            const size_t cmpOffset
+            const size_t cmpOffset,
+            const size_t readSize = 0
         ) -> std::tuple<std::span<const std::byte>, std::span<const Vector>, std::span<const std::byte>> {
             auto validateRange = [signatureSize](const std::byte* b, const std::byte* e) -> std::span<const std::byte> {
                 if (b <= e && static_cast<size_t>(e - b) >= signatureSize) {
@@ -178,10 +356,21 @@ namespace hat {
             }
 
             const auto preBegin = begin;
-            const auto vecBegin = reinterpret_cast<const Vector*>(align_pointer_as<Vector>(preBegin + cmpOffset));
-            const auto vecEnd = vecBegin + (static_cast<size_t>(end - reinterpret_cast<const std::byte*>(vecBegin)) - signatureSize) / sizeof(Vector);
-            const auto preEnd = reinterpret_cast<const std::byte*>(vecBegin) - cmpOffset + signatureSize;
-            const auto postBegin = reinterpret_cast<const std::byte*>(vecEnd);
+            const auto vecBegin = reinterpret_cast<const Vector*>(align_pointer_to<sizeof(Vector)>(preBegin + cmpOffset));
+
+            // The remaining range after the first aligned vector is too small for the signature
+            const auto reserve = std::max(signatureSize, readSize);
+            if (const auto vecStart = reinterpret_cast<const std::byte*>(vecBegin); vecStart > end || static_cast<size_t>(end - vecStart) < reserve) {
+                return {validateRange(begin, end), {}, {}};
+            }
+
+            const auto vecEnd = vecBegin + (static_cast<size_t>(end - reinterpret_cast<const std::byte*>(vecBegin)) - reserve) / sizeof(Vector);
+            // The first vector compares the candidate beginning at vecBegin - cmpOffset, which is excluded from "pre" so
+            // that every candidate is only compared once
+            const auto preEnd = reinterpret_cast<const std::byte*>(vecBegin) - cmpOffset + signatureSize - 1;
+            // The last vector compares the byte at cmpOffset of each candidate, so the candidates beginning in the
+            // last cmpOffset bytes of the vectorized range still have to be scanned
+            const auto postBegin = reinterpret_cast<const std::byte*>(vecEnd) - cmpOffset;
             const auto postEnd = end;
 
             return {
@@ -191,18 +380,44 @@ namespace hat {
             };
         }
 
+        /// Returns the fastest scan_mode supported by the current system that hasn't been disabled, or the pinned mode.
+        /// The selection is computed once, and again only after it has been changed.
+        [[nodiscard]] scan_mode best_scan_mode();
+
+        /// Returns the requested mode if it is supported by the current system, and best_scan_mode() otherwise
+        [[nodiscard]] scan_mode select_scan_mode(std::optional<scan_mode> requested);
+
+        /// Selects the index of the byte pair in the signature to be used for pair based comparisons
+        [[nodiscard]] std::optional<size_t> select_pair(signature_view signature, scan_hint hints, const frequency_model* model = nullptr);
+
         template<scan_mode>
         scan_function_t resolve_scanner(scan_context&);
 
         template<scan_alignment>
-        const_scan_result find_pattern_single(const std::byte* begin, const std::byte* end, const scan_context&);
+        const_scan_result find_pattern_single(const std::byte* begin, const std::byte* end, const scan_context&, match_sink* sink = nullptr);
 
         template<>
-        constexpr const_scan_result find_pattern_single<scan_alignment::X1>(const std::byte* begin, const std::byte* end, const scan_context& context) {
+        constexpr const_scan_result find_pattern_single<scan_alignment::X1>(const std::byte* begin, const std::byte* end, const scan_context& context, match_sink* sink) {
             const auto signature = context.signature;
-            const auto firstByte = *signature[0];
             const auto scanEnd = end - signature.size() + 1;
+            const auto solid = signature.first(context.verifyLength);
+
+            // The first element is never a wildcard, but it may only specify some bits of the byte, which std::find
+            // can't search for
+            if (!signature[0].has_value()) {
+                for (auto i = begin; i != scanEnd; i++) {
+                    count_candidate();
+                    auto match = std::equal(solid.begin(), solid.end(), i, [](auto opt, auto byte) {
+                        return opt.matches(byte);
+                    });
+                    if (match && stop_at(sink, i)) LIBHAT_UNLIKELY {
+                        return i;
+                    }
+                }
+                return nullptr;
+            }
 
+            const auto firstByte = *signature[0];
             for (auto i = begin; i != scanEnd; i++) {
                 // Use std::find to efficiently find the first byte
                 if LIBHAT_IF_CONSTEVAL {
@@ -214,34 +429,39 @@ namespace hat {
                     break;
                 }
                 // Compare everything after the first byte
-                auto match = std::equal(signature.begin() + 1, signature.end(), i + 1, [](auto opt, auto byte) {
-                    return !opt.has_value() || *opt == byte;
+                count_candidate();
+                auto match = std::equal(solid.begin() + 1, solid.end(), i + 1, [](auto opt, auto byte) {
+                    return opt.matches(byte);
                 });
-                if (match) LIBHAT_UNLIKELY {
+                if (match && stop_at(sink, i)) LIBHAT_UNLIKELY {
                     return i;
                 }
             }
             return nullptr;
         }
 
-        template<>
-        inline const_scan_result find_pattern_single<scan_alignment::X16>(const std::byte* begin, const std::byte* end, const scan_context& context) {
+        template<scan_alignment alignment>
+        const_scan_result find_pattern_single(const std::byte* begin, const std::byte* end, const scan_context& context, match_sink* sink) {
+            constexpr auto stride = alignment_stride<alignment>;
             const auto signature = context.signature;
-            const auto firstByte = *signature[0];
+            const auto solid = signature.first(context.verifyLength);
+            const auto first = signature[0];
 
-            const auto scanBegin = next_boundary_align<scan_alignment::X16>(begin);
-            const auto scanEnd = prev_boundary_align<scan_alignment::X16>(end - signature.size() + 1);
-            if (scanBegin >= scanEnd) {
+            const auto scanBegin = next_boundary_align<alignment>(begin);
+            if (scanBegin >= end || static_cast<size_t>(end - scanBegin) < signature.size()) {
                 return nullptr;
             }
+            // The last aligned position at which the signature still fits into the range
+            const auto scanLast = prev_boundary_align<alignment>(end - signature.size());
 
-            for (auto i = scanBegin; i != scanEnd; i += 16) {
-                if (*i == firstByte) {
+            for (auto i = scanBegin; i <= scanLast; i += stride) {
+                if (first.matches(*i)) {
                     // Compare everything after the first byte
-                    auto match = std::equal(signature.begin() + 1, signature.end(), i + 1, [](auto opt, auto byte) {
-                        return !opt.has_value() || *opt == byte;
+                    count_candidate();
+                    auto match = std::equal(solid.begin() + 1, solid.end(), i + 1, [](auto opt, auto byte) {
+                        return opt.matches(byte);
                     });
-                    if (match) LIBHAT_UNLIKELY {
+                    if (match && stop_at(sink, i)) LIBHAT_UNLIKELY {
                         return i;
                     }
                 }
@@ -251,9 +471,15 @@ namespace hat {
 
         template<>
         constexpr scan_function_t resolve_scanner<scan_mode::Single>(scan_context& context) {
+            context.resolvedMode = scan_mode::Single;
             switch (context.alignment) {
-                case scan_alignment::X1: return &find_pattern_single<scan_alignment::X1>;
+                case scan_alignment::X1:  return &find_pattern_single<scan_alignment::X1>;
+                case scan_alignment::X2:  return &find_pattern_single<scan_alignment::X2>;
+                case scan_alignment::X4:  return &find_pattern_single<scan_alignment::X4>;
+                case scan_alignment::X8:  return &find_pattern_single<scan_alignment::X8>;
                 case scan_alignment::X16: return &find_pattern_single<scan_alignment::X16>;
+                case scan_alignment::X32: return &find_pattern_single<scan_alignment::X32>;
+                case scan_alignment::X64: return &find_pattern_single<scan_alignment::X64>;
             }
             LIBHAT_UNREACHABLE();
         }
@@ -262,7 +488,7 @@ namespace hat {
             // Truncate the leading wildcards from the signature
             size_t offset = 0;
             for (const auto& elem : signature) {
-                if (elem.has_value()) {
+                if (!elem.is_wildcard()) {
                     break;
                 }
                 offset++;
@@ -274,21 +500,84 @@ namespace hat {
         using result_type_for = std::conditional_t<std::is_const_v<std::remove_reference_t<std::iter_reference_t<T>>>,
             const_scan_result, scan_result>;
 
-        constexpr scan_context scan_context::create(const signature_view signature, const scan_alignment alignment, const scan_hint hints) {
+        constexpr scan_context scan_context::create(
+            const signature_view             signature,
+            const scan_alignment             alignment,
+            const scan_hint                  hints,
+            const std::span<const std::byte> data,
+            const frequency_model*           model,
+            const std::optional<scan_mode>   mode
+        ) {
             scan_context ctx{};
             ctx.signature = signature;
             ctx.alignment = alignment;
             ctx.hints = hints;
+            ctx.mode = mode;
+            ctx.verifyLength = signature.size();
+            while (ctx.verifyLength && signature[ctx.verifyLength - 1].is_wildcard()) {
+                ctx.verifyLength--;
+            }
             if LIBHAT_IF_CONSTEVAL {
                 ctx.scanner = resolve_scanner<scan_mode::Single>(ctx);
             } else {
-                ctx.auto_resolve_scanner();
+                ctx.model = model;
+                ctx.preload_vectors();
+                ctx.auto_resolve_scanner(data);
+                ctx.model = nullptr;
             }
             return ctx;
         }
+
+        constexpr void scan_context::preload_vectors() {
+            const auto count = std::min(this->verifyLength, this->vectorBytes.size());
+            for (size_t i = 0; i < count; i++) {
+                if (const auto e = this->signature[i]; !e.is_wildcard()) {
+                    this->vectorBytes[i] = e.value();
+                    this->vectorMask[i] = e.mask();
+                    this->solidBlocks |= static_cast<uint16_t>(1u << (i / 16));
+                }
+            }
+        }
+
+        /// Invokes fn with every match in the range in ascending order until it returns false. Returns the match at which
+        /// fn stopped the scan, or nullptr if the entire range was scanned.
+        template<typename Fn>
+        constexpr const_scan_result for_each_match(const scan_context& context, const std::byte* begin, const std::byte* end, Fn fn) {
+            const auto signatureSize = context.signature.size();
+            if LIBHAT_IF_CONSTEVAL {
+                // The callback of a match_sink can't be invoked in constant evaluation, so the scan is restarted after
+                // every match instead
+                const auto stride = static_cast<size_t>(context.alignment);
+                for (auto i = begin; i < end && signatureSize <= static_cast<size_t>(end - i);) {
+                    const auto result = context.scan(i, end);
+                    if (!result.has_result()) {
+                        break;
+                    }
+                    if (!fn(result.get())) {
+                        return result;
+                    }
+                    i = result.get() + stride;
+                }
+                return nullptr;
+            } else {
+                if (begin >= end || signatureSize > static_cast<size_t>(end - begin)) {
+                    return nullptr;
+                }
+                match_sink sink{
+                    .callback = [](void* user, const std::byte* match) {
+                        return static_cast<bool>((*static_cast<Fn*>(user))(match));
+                    },
+                    .user = &fn
+                };
+                return context.scan_all(begin, end, sink);
+            }
+        }
     }
 
-    /// Perform a signature scan on the entirety of the process module or a specified module
+    /// A list of disjoint memory regions, such as the committed regions of a module given by process::module_regions
+    using region_list = std::span<const std::span<std::byte>>;
+
+    /// Perform a signature scan on the committed and readable memory of the process module or a specified module
     template<scan_alignment alignment = scan_alignment::X1>
     [[deprecated]] scan_result find_pattern(
         signature_view      signature,
@@ -304,6 +593,42 @@ namespace hat {
         scan_hint           hints = scan_hint::none
     );
 
+    /// Perform a signature scan on each of the regions in order, returning the first match. The regions are scanned
+    /// separately, so a match which would extend past the end of the region it begins in is not found.
+    template<scan_alignment alignment = scan_alignment::X1>
+    scan_result find_pattern(
+        region_list         regions,
+        signature_view      signature,
+        scan_hint           hints = scan_hint::none
+    );
+
+    /// Finds all of the matches for the signature in each of the regions in order, and writes the results into the
+    /// output iterator. Returns the number of matches that were found.
+    template<scan_alignment alignment = scan_alignment::X1, std::output_iterator<scan_result> Out>
+    size_t find_all_pattern(
+        region_list         regions,
+        Out                 out,
+        signature_view      signature,
+        scan_hint           hints = scan_hint::none
+    );
+
+    /// Wrapper around find_all_pattern for a region list that returns a std::vector of the results
+    template<scan_alignment alignment = scan_alignment::X1>
+    std::vector<scan_result> find_all_pattern(
+        region_list         regions,
+        signature_view      signature,
+        scan_hint           hints = scan_hint::none
+    );
+
+    /// Counts the matches for the signature in a specific section of the process module or a specified module
+    template<scan_alignment alignment = scan_alignment::X1>
+    size_t count_pattern(
+        signature_view      signature,
+        std::string_view    section,
+        process::module_t   mod = process::get_process_module(),
+        scan_hint           hints = scan_hint::none
+    );
+
     /// Root implementation of find_pattern
     template<scan_alignment alignment = scan_alignment::X1, detail::byte_input_iterator Iter>
     constexpr auto find_pattern(
@@ -320,7 +645,7 @@ namespace hat {
             return {nullptr};
         }
 
-        const auto context = detail::scan_context::create(trunc, alignment, hints);
+        const auto context = detail::scan_context::create(trunc, alignment, hints, {begin, end});
         const const_scan_result result = context.scan(begin, end);
         return result.has_result()
             ? const_cast<typename detail::result_type_for<Iter>::underlying_type>(result.get() - offset)
@@ -341,29 +666,151 @@ namespace hat {
         const scan_hint       hints = scan_hint::none
     ) -> std::pair<In, Out> {
         const auto [offset, trunc] = detail::truncate(signature);
-        const auto begin = std::to_address(beginIn) + offset;
+        const auto first = std::to_address(beginIn);
+        const auto begin = first + offset;
         const auto end = std::to_address(endIn);
 
-        auto i = begin;
         auto out = beginOut;
+        if (out == endOut) {
+            return std::make_pair(beginIn, out);
+        }
+        if (begin >= end || trunc.size() > static_cast<size_t>(std::distance(begin, end))) {
+            return std::make_pair(endIn, out);
+        }
+
+        const auto context = detail::scan_context::create(trunc, alignment, hints, {begin, end});
+        const auto stopped = detail::for_each_match(context, begin, end, [&](const std::byte* match) {
+            *out++ = const_cast<typename detail::result_type_for<In>::underlying_type>(match - offset);
+            return out != endOut;
+        });
+        if (!stopped.has_result()) {
+            return std::make_pair(endIn, out);
+        }
+
+        // The search resumes at the next aligned position after the last match that was written
+        const auto resume = std::min(stopped.get() - offset + detail::alignment_stride<alignment>, end);
+        return std::make_pair(std::next(beginIn, resume - first), out);
+    }
+
+    /// A stop condition for an interruptible scan, which requests a stop once the deadline has passed
+    struct scan_deadline {
+        std::chrono::steady_clock::time_point time;
 
-        const auto context = detail::scan_context::create(trunc, alignment, hints);
+        /// Returns a deadline the given duration from now
+        template<typename Rep, typename Period>
+        [[nodiscard]] static scan_deadline after(const std::chrono::duration<Rep, Period> budget) {
+            return {std::chrono::steady_clock::now() + budget};
+        }
+
+        [[nodiscard]] bool stop_requested() const noexcept {
+            return std::chrono::steady_clock::now() >= this->time;
+        }
+    };
 
-        while (i < end && out != endOut && trunc.size() <= static_cast<size_t>(std::distance(i, end))) {
-            const auto result = context.scan(i, end);
-            if (!result.has_result()) {
-                i = end;
-                break;
+    namespace detail {
+
+        /// The number of bytes an interruptible scan covers between polls of its stop condition
+        inline constexpr size_t scan_slice_size = 64 * 1024;
+
+        /// Invokes fn with consecutive slices of the range until it returns false. The slices overlap by the signature
+        /// size minus one, so every match starts in exactly one slice. The stop condition is polled before each slice
+        /// after the first, so that every call makes progress. Returns the start of the first slice that was not
+        /// scanned when the stop condition was met, or end otherwise.
+        template<stop_condition Stop, typename Fn>
+        const std::byte* for_each_slice(const std::byte* begin, const std::byte* end, const size_t signatureSize, const Stop& stop, Fn&& fn) {
+            for (auto i = begin; static_cast<size_t>(end - i) >= signatureSize; i += scan_slice_size) {
+                if (i != begin && stop.stop_requested()) {
+                    return i;
+                }
+                const auto remaining = static_cast<size_t>(end - i);
+                const auto sliceEnd = remaining > scan_slice_size + signatureSize - 1
+                    ? i + scan_slice_size + signatureSize - 1
+                    : end;
+                if (!fn(i, sliceEnd) || sliceEnd == end) {
+                    break;
+                }
             }
-            const auto addr = const_cast<typename detail::result_type_for<In>::underlying_type>(result.get() - offset);
-            *out++ = addr;
-            i = addr + detail::alignment_stride<alignment>;
+            return end;
+        }
+    }
+
+    /// Interruptible implementation of find_pattern. The input range is scanned in slices of detail::scan_slice_size
+    /// bytes, and the stop condition, e.g. a std::stop_token or a hat::scan_deadline, is polled between them. The first
+    /// element of the returned pair is an iterator into the input range at which the scan can be resumed: the next
+    /// aligned position after the match if one was found, the position at which the scan was interrupted, or the end
+    /// of the input range if it was scanned entirely. The second element is the match, if any.
+    template<scan_alignment alignment = scan_alignment::X1, detail::byte_input_iterator Iter, detail::stop_condition Stop>
+    auto find_pattern(
+        const Iter            beginIt,
+        const Iter            endIt,
+        const signature_view  signature,
+        const Stop&           stop,
+        const scan_hint       hints = scan_hint::none
+    ) -> std::pair<Iter, detail::result_type_for<Iter>> {
+        using result_t = detail::result_type_for<Iter>;
+
+        const auto [offset, trunc] = detail::truncate(signature);
+        const auto first = std::to_address(beginIt);
+        const auto begin = first + offset;
+        const auto end = std::to_address(endIt);
+
+        if (begin >= end || trunc.size() > static_cast<size_t>(std::distance(begin, end))) {
+            return std::make_pair(endIt, result_t{nullptr});
         }
 
-        return std::make_pair(std::next(beginIn, i - begin), out);
+        const auto context = detail::scan_context::create(trunc, alignment, hints, {begin, end});
+        const_scan_result result{};
+        const auto stopped = detail::for_each_slice(begin, end, trunc.size(), stop, [&](const std::byte* sliceBegin, const std::byte* sliceEnd) {
+            result = context.scan(sliceBegin, sliceEnd);
+            return !result.has_result();
+        });
+
+        if (result.has_result()) {
+            const auto resume = std::min<const std::byte*>(result.get() - offset + detail::alignment_stride<alignment>, end);
+            return std::make_pair(
+                std::next(beginIt, resume - first),
+                result_t{const_cast<typename result_t::underlying_type>(result.get() - offset)}
+            );
+        }
+        return std::make_pair(stopped == end ? endIt : std::next(beginIt, stopped - begin), result_t{nullptr});
     }
 
-    /// Root implementation of find_all_pattern
+    /// Interruptible implementation of find_all_pattern. Every match is written to the output iterator, and the input
+    /// range is scanned in slices between which the stop condition is polled, as with the interruptible find_pattern.
+    /// The first element of the returned pair is an iterator into the input range at which the scan can be resumed,
+    /// which is the end of the input range if it was scanned entirely. The second element of the pair is an end
+    /// iterator into the output range in which the matched results stop.
+    template<scan_alignment alignment = scan_alignment::X1, detail::byte_input_iterator In, std::output_iterator<detail::result_type_for<In>> Out, detail::stop_condition Stop>
+    auto find_all_pattern(
+        const In              beginIn,
+        const In              endIn,
+        const Out             outIn,
+        const signature_view  signature,
+        const Stop&           stop,
+        const scan_hint       hints = scan_hint::none
+    ) -> std::pair<In, Out> {
+        const auto [offset, trunc] = detail::truncate(signature);
+        const auto begin = std::to_address(beginIn) + offset;
+        const auto end = std::to_address(endIn);
+
+        auto out = outIn;
+        if (begin >= end || trunc.size() > static_cast<size_t>(std::distance(begin, end))) {
+            return std::make_pair(endIn, out);
+        }
+
+        const auto context = detail::scan_context::create(trunc, alignment, hints, {begin, end});
+        const auto stopped = detail::for_each_slice(begin, end, trunc.size(), stop, [&](const std::byte* sliceBegin, const std::byte* sliceEnd) {
+            detail::for_each_match(context, sliceBegin, sliceEnd, [&](const std::byte* match) {
+                *out++ = const_cast<typename detail::result_type_for<In>::underlying_type>(match - offset);
+                return true;
+            });
+            return true;
+        });
+        return std::make_pair(stopped == end ? endIn : std::next(beginIn, stopped - begin), out);
+    }
+
+    /// Root implementation of find_all_pattern. Every match is found in a single pass over the input range, rather than
+    /// restarting the scan after each one.
     template<scan_alignment alignment = scan_alignment::X1, detail::byte_input_iterator In, std::output_iterator<detail::result_type_for<In>> Out>
     constexpr size_t find_all_pattern(
         const In              beginIn,
@@ -376,35 +823,269 @@ namespace hat {
         const auto begin = std::to_address(beginIn) + offset;
         const auto end = std::to_address(endIn);
 
-        auto i = begin;
+        if (begin >= end || trunc.size() > static_cast<size_t>(std::distance(begin, end))) {
+            return 0;
+        }
+
         auto out = outIn;
         size_t matches{};
 
-        const auto context = detail::scan_context::create(trunc, alignment, hints);
+        const auto context = detail::scan_context::create(trunc, alignment, hints, {begin, end});
+        detail::for_each_match(context, begin, end, [&](const std::byte* match) {
+            *out++ = const_cast<typename detail::result_type_for<In>::underlying_type>(match - offset);
+            matches++;
+            return true;
+        });
+        return matches;
+    }
 
-        while (begin < end && trunc.size() <= static_cast<size_t>(std::distance(i, end))) {
-            const auto result = context.scan(i, end);
-            if (!result.has_result()) {
-                break;
+    /// Finds the matches for the given signature in the input range, and writes them into the output span without
+    /// allocating. The scan stops once the span is full. Returns the number of matches that were written.
+    template<scan_alignment alignment = scan_alignment::X1, detail::byte_input_iterator In>
+    constexpr size_t find_all_pattern(
+        const In                                       beginIn,
+        const In                                       endIn,
+        const std::span<detail::result_type_for<In>>   out,
+        const signature_view                           signature,
+        const scan_hint                                hints = scan_hint::none
+    ) {
+        const auto [offset, trunc] = detail::truncate(signature);
+        const auto begin = std::to_address(beginIn) + offset;
+        const auto end = std::to_address(endIn);
+
+        if (out.empty() || begin >= end || trunc.size() > static_cast<size_t>(std::distance(begin, end))) {
+            return 0;
+        }
+
+        const auto context = detail::scan_context::create(trunc, alignment, hints, {begin, end});
+        if constexpr (std::is_same_v<detail::result_type_for<In>, const_scan_result>) {
+            // The scanner writes directly into the span, and the results are moved back by the truncated offset after
+            detail::match_sink sink{.buffer = out.data(), .capacity = out.size()};
+            context.scan_all(begin, end, sink);
+            if (offset) {
+                for (auto& result : out.first(sink.count)) {
+                    result = result.get() - offset;
+                }
             }
-            const auto addr = const_cast<typename detail::result_type_for<In>::underlying_type>(result.get() - offset);
-            *out++ = addr;
-            i = addr + detail::alignment_stride<alignment>;
-            matches++;
+            return sink.count;
+        } else {
+            size_t matches{};
+            detail::for_each_match(context, begin, end, [&](const std::byte* match) {
+                out[matches++] = const_cast<std::byte*>(match - offset);
+                return matches < out.size();
+            });
+            return matches;
+        }
+    }
+
+    /// Invokes the callback with every match for the given signature in the input range, in ascending order. If the
+    /// callback returns a value convertible to bool, returning false stops the scan. Returns the number of matches the
+    /// callback was invoked with.
+    template<scan_alignment alignment = scan_alignment::X1, detail::byte_input_iterator In, typename Fn>
+        requires std::invocable<Fn&, detail::result_type_for<In>>
+    constexpr size_t find_all_pattern(
+        const In              beginIn,
+        const In              endIn,
+        Fn&&                  callback,
+        const signature_view  signature,
+        const scan_hint       hints = scan_hint::none
+    ) {
+        const auto [offset, trunc] = detail::truncate(signature);
+        const auto begin = std::to_address(beginIn) + offset;
+        const auto end = std::to_address(endIn);
+
+        if (begin >= end || trunc.size() > static_cast<size_t>(std::distance(begin, end))) {
+            return 0;
         }
 
+        size_t matches{};
+        const auto context = detail::scan_context::create(trunc, alignment, hints, {begin, end});
+        detail::for_each_match(context, begin, end, [&](const std::byte* match) {
+            const auto result = const_cast<typename detail::result_type_for<In>::underlying_type>(match - offset);
+            matches++;
+            if constexpr (std::is_convertible_v<std::invoke_result_t<Fn&, detail::result_type_for<In>>, bool>) {
+                return static_cast<bool>(callback(detail::result_type_for<In>{result}));
+            } else {
+                callback(detail::result_type_for<In>{result});
+                return true;
+            }
+        });
         return matches;
     }
 
+    /// Counts the matches for the given signature in the input range, without materializing their addresses
+    template<scan_alignment alignment = scan_alignment::X1, detail::byte_input_iterator In>
+    constexpr size_t count_pattern(
+        const In              beginIn,
+        const In              endIn,
+        const signature_view  signature,
+        const scan_hint       hints = scan_hint::none
+    ) {
+        const auto [offset, trunc] = detail::truncate(signature);
+        const auto begin = std::to_address(beginIn) + offset;
+        const auto end = std::to_address(endIn);
+
+        if (begin >= end || trunc.size() > static_cast<size_t>(std::distance(begin, end))) {
+            return 0;
+        }
+
+        const auto context = detail::scan_context::create(trunc, alignment, hints, {begin, end});
+        detail::match_sink sink{};
+        context.scan_all(begin, end, sink);
+        return sink.count;
+    }
+
     /// Wrapper around the root find_all_pattern implementation that returns a std::vector of the results
     template<scan_alignment alignment = scan_alignment::X1, detail::byte_input_iterator In>
     constexpr auto find_all_pattern(
         const In             beginIt,
         const In             endIt,
-        const signature_view signature
+        const signature_view signature,
+        const scan_hint      hints = scan_hint::none
+    ) -> std::vector<detail::result_type_for<In>> {
+        std::vector<detail::result_type_for<In>> results{};
+        find_all_pattern<alignment>(beginIt, endIt, std::back_inserter(results), signature, hints);
+        return results;
+    }
+
+    namespace detail {
+
+        template<typename ExecutionPolicy>
+        inline constexpr bool is_parallel_policy_v =
+            std::is_same_v<std::remove_cvref_t<ExecutionPolicy>, std::execution::parallel_policy> ||
+            std::is_same_v<std::remove_cvref_t<ExecutionPolicy>, std::execution::parallel_unsequenced_policy>;
+
+        /// Scans the range in chunks on multiple threads, and returns the match with the lowest address
+        const_scan_result find_pattern_parallel(const std::byte* begin, const std::byte* end, const scan_context& context);
+
+        /// Scans the range in chunks on multiple threads, and returns all matches in ascending address order
+        std::vector<const_scan_result> find_all_pattern_parallel(const std::byte* begin, const std::byte* end, const scan_context& context);
+    }
+
+    /// Perform a signature scan on a specific section of the process module or a specified module, using the given
+    /// execution policy
+    template<scan_alignment alignment = scan_alignment::X1, typename ExecutionPolicy>
+        requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+    scan_result find_pattern(
+        ExecutionPolicy&&   policy,
+        signature_view      signature,
+        std::string_view    section,
+        process::module_t   mod = process::get_process_module(),
+        scan_hint           hints = scan_hint::none
+    );
+
+    /// Perform a signature scan on each of the regions in order using the given execution policy, returning the first
+    /// match. With a parallel policy, each region is split into chunks which are scanned on multiple threads.
+    template<scan_alignment alignment = scan_alignment::X1, typename ExecutionPolicy>
+        requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+    scan_result find_pattern(
+        ExecutionPolicy&&   policy,
+        region_list         regions,
+        signature_view      signature,
+        scan_hint           hints = scan_hint::none
+    );
+
+    /// Finds all of the matches for the signature in each of the regions in order using the given execution policy,
+    /// and writes the results into the output iterator. Returns the number of matches that were found.
+    template<scan_alignment alignment = scan_alignment::X1, typename ExecutionPolicy, std::output_iterator<scan_result> Out>
+        requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+    size_t find_all_pattern(
+        ExecutionPolicy&&   policy,
+        region_list         regions,
+        Out                 out,
+        signature_view      signature,
+        scan_hint           hints = scan_hint::none
+    );
+
+    /// Wrapper around find_all_pattern for a region list using the given execution policy that returns a std::vector
+    /// of the results
+    template<scan_alignment alignment = scan_alignment::X1, typename ExecutionPolicy>
+        requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+    std::vector<scan_result> find_all_pattern(
+        ExecutionPolicy&&   policy,
+        region_list         regions,
+        signature_view      signature,
+        scan_hint           hints = scan_hint::none
+    );
+
+    /// Implementation of find_pattern using the given execution policy. With a parallel policy, the input range is
+    /// split into chunks which overlap by the signature size, and the chunks are scanned on multiple threads. Chunks
+    /// after the one containing the first match are not scanned.
+    template<scan_alignment alignment = scan_alignment::X1, typename ExecutionPolicy, detail::byte_input_iterator Iter>
+        requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+    auto find_pattern(
+        ExecutionPolicy&&,
+        const Iter            beginIt,
+        const Iter            endIt,
+        const signature_view  signature,
+        const scan_hint       hints = scan_hint::none
+    ) -> detail::result_type_for<Iter> {
+        if constexpr (!detail::is_parallel_policy_v<ExecutionPolicy>) {
+            return find_pattern<alignment>(beginIt, endIt, signature, hints);
+        } else {
+            const auto [offset, trunc] = detail::truncate(signature);
+            const auto begin = std::to_address(beginIt) + offset;
+            const auto end = std::to_address(endIt);
+
+            if (begin >= end || trunc.size() > static_cast<size_t>(std::distance(begin, end))) {
+                return {nullptr};
+            }
+
+            const auto context = detail::scan_context::create(trunc, alignment, hints, {begin, end});
+            const const_scan_result result = detail::find_pattern_parallel(begin, end, context);
+            return result.has_result()
+                ? const_cast<typename detail::result_type_for<Iter>::underlying_type>(result.get() - offset)
+                : nullptr;
+        }
+    }
+
+    /// Implementation of find_all_pattern using the given execution policy. With a parallel policy, the input range
+    /// is split into chunks which are scanned on multiple threads, and the results of every chunk are merged back in
+    /// ascending address order.
+    template<scan_alignment alignment = scan_alignment::X1, typename ExecutionPolicy, detail::byte_input_iterator In, std::output_iterator<detail::result_type_for<In>> Out>
+        requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+    size_t find_all_pattern(
+        ExecutionPolicy&&,
+        const In              beginIn,
+        const In              endIn,
+        const Out             outIn,
+        const signature_view  signature,
+        const scan_hint       hints = scan_hint::none
+    ) {
+        if constexpr (!detail::is_parallel_policy_v<ExecutionPolicy>) {
+            return find_all_pattern<alignment>(beginIn, endIn, outIn, signature, hints);
+        } else {
+            const auto [offset, trunc] = detail::truncate(signature);
+            const auto begin = std::to_address(beginIn) + offset;
+            const auto end = std::to_address(endIn);
+
+            if (begin >= end || trunc.size() > static_cast<size_t>(std::distance(begin, end))) {
+                return 0;
+            }
+
+            const auto context = detail::scan_context::create(trunc, alignment, hints, {begin, end});
+            const auto results = detail::find_all_pattern_parallel(begin, end, context);
+
+            auto out = outIn;
+            for (const auto& result : results) {
+                *out++ = const_cast<typename detail::result_type_for<In>::underlying_type>(result.get() - offset);
+            }
+            return results.size();
+        }
+    }
+
+    /// Wrapper around find_all_pattern using the given execution policy that returns a std::vector of the results
+    template<scan_alignment alignment = scan_alignment::X1, typename ExecutionPolicy, detail::byte_input_iterator In>
+        requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+    auto find_all_pattern(
+        ExecutionPolicy&&    policy,
+        const In             beginIt,
+        const In             endIt,
+        const signature_view signature,
+        const scan_hint      hints = scan_hint::none
     ) -> std::vector<detail::result_type_for<In>> {
         std::vector<detail::result_type_for<In>> results{};
-        find_all_pattern<alignment>(beginIt, endIt, std::back_inserter(results), signature);
+        find_all_pattern<alignment>(std::forward<ExecutionPolicy>(policy), beginIt, endIt, std::back_inserter(results), signature, hints);
         return results;
     }
 }
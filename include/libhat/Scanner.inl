@@ -4,19 +4,94 @@ namespace hat {
 
     template<scan_alignment alignment>
     scan_result find_pattern(const signature_view signature, const hat::process::module_t mod) {
-        const auto data = hat::process::get_module_data(mod);
+        // Only the committed pages are scanned, the module may contain reserved ranges and guard pages
+        const auto regions = hat::process::module_regions(mod, protection::Read);
+        return find_pattern<alignment>(regions, signature);
+    }
+
+    template<scan_alignment alignment>
+    scan_result find_pattern(const signature_view signature, const std::string_view section, const hat::process::module_t mod, const scan_hint hints) {
+        const auto data = hat::process::get_section_data(mod, section);
         if (data.empty()) {
             return nullptr;
         }
-        return find_pattern<alignment>(data.begin(), data.end(), signature);
+        return find_pattern<alignment>(data.begin(), data.end(), signature, hints);
     }
 
     template<scan_alignment alignment>
-    scan_result find_pattern(const signature_view signature, const std::string_view section, const hat::process::module_t mod, const scan_hint hints) {
+    size_t count_pattern(const signature_view signature, const std::string_view section, const hat::process::module_t mod, const scan_hint hints) {
+        const auto data = hat::process::get_section_data(mod, section);
+        return count_pattern<alignment>(data.begin(), data.end(), signature, hints);
+    }
+
+    template<scan_alignment alignment>
+    scan_result find_pattern(const region_list regions, const signature_view signature, const scan_hint hints) {
+        for (const auto region : regions) {
+            if (const auto result = find_pattern<alignment>(region.begin(), region.end(), signature, hints); result.has_result()) {
+                return result;
+            }
+        }
+        return nullptr;
+    }
+
+    template<scan_alignment alignment, std::output_iterator<scan_result> Out>
+    size_t find_all_pattern(const region_list regions, Out out, const signature_view signature, const scan_hint hints) {
+        size_t matches{};
+        for (const auto region : regions) {
+            const auto count = find_all_pattern<alignment>(region.begin(), region.end(), out, signature, hints);
+            // The output iterator is taken by value, so it has to be moved past the results written for the region
+            std::ranges::advance(out, static_cast<std::iter_difference_t<Out>>(count));
+            matches += count;
+        }
+        return matches;
+    }
+
+    template<scan_alignment alignment>
+    std::vector<scan_result> find_all_pattern(const region_list regions, const signature_view signature, const scan_hint hints) {
+        std::vector<scan_result> results{};
+        find_all_pattern<alignment>(regions, std::back_inserter(results), signature, hints);
+        return results;
+    }
+
+    template<scan_alignment alignment, typename ExecutionPolicy>
+        requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+    scan_result find_pattern(ExecutionPolicy&& policy, const region_list regions, const signature_view signature, const scan_hint hints) {
+        for (const auto region : regions) {
+            if (const auto result = find_pattern<alignment>(policy, region.begin(), region.end(), signature, hints); result.has_result()) {
+                return result;
+            }
+        }
+        return nullptr;
+    }
+
+    template<scan_alignment alignment, typename ExecutionPolicy, std::output_iterator<scan_result> Out>
+        requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+    size_t find_all_pattern(ExecutionPolicy&& policy, const region_list regions, Out out, const signature_view signature, const scan_hint hints) {
+        size_t matches{};
+        for (const auto region : regions) {
+            const auto count = find_all_pattern<alignment>(policy, region.begin(), region.end(), out, signature, hints);
+            // The output iterator is taken by value, so it has to be moved past the results written for the region
+            std::ranges::advance(out, static_cast<std::iter_difference_t<Out>>(count));
+            matches += count;
+        }
+        return matches;
+    }
+
+    template<scan_alignment alignment, typename ExecutionPolicy>
+        requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+    std::vector<scan_result> find_all_pattern(ExecutionPolicy&& policy, const region_list regions, const signature_view signature, const scan_hint hints) {
+        std::vector<scan_result> results{};
+        find_all_pattern<alignment>(std::forward<ExecutionPolicy>(policy), regions, std::back_inserter(results), signature, hints);
+        return results;
+    }
+
+    template<scan_alignment alignment, typename ExecutionPolicy>
+        requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+    scan_result find_pattern(ExecutionPolicy&& policy, const signature_view signature, const std::string_view section, const hat::process::module_t mod, const scan_hint hints) {
         const auto data = hat::process::get_section_data(mod, section);
         if (data.empty()) {
             return nullptr;
         }
-        return find_pattern<alignment>(data.begin(), data.end(), signature, hints);
+        return find_pattern<alignment>(std::forward<ExecutionPolicy>(policy), data.begin(), data.end(), signature, hints);
     }
 }
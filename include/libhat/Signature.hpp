@@ -1,10 +1,12 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <bit>
 #include <optional>
 #include <ranges>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 #include "CompileTime.hpp"
@@ -13,11 +15,16 @@
 namespace hat {
 
     /// Effectively std::optional<std::byte>, but with the added flexibility of being able to use std::bit_cast on
-    /// instances of the class in constant expressions.
+    /// instances of the class in constant expressions. An element may also specify only some of the bits of a byte,
+    /// such as a single nibble, in which case the remaining bits match any value.
     struct signature_element {
         constexpr signature_element() noexcept {}
         constexpr signature_element(std::nullopt_t) noexcept {}
-        constexpr signature_element(const std::byte valueIn) noexcept : val(valueIn), present(true) {}
+        constexpr signature_element(const std::byte valueIn) noexcept : val(valueIn), msk(std::byte{0xFFu}) {}
+
+        /// Creates an element which only matches the bits of the value that are set in the mask
+        constexpr signature_element(const std::byte valueIn, const std::byte maskIn) noexcept
+            : val(valueIn & maskIn), msk(maskIn) {}
 
         constexpr signature_element& operator=(std::nullopt_t) noexcept {
             return *this = signature_element{};
@@ -31,14 +38,30 @@ namespace hat {
             *this = std::nullopt;
         }
 
+        /// Returns whether the element matches exactly one byte value
         [[nodiscard]] constexpr bool has_value() const noexcept {
-            return this->present;
+            return this->msk == std::byte{0xFF};
+        }
+
+        /// Returns whether the element matches any byte value
+        [[nodiscard]] constexpr bool is_wildcard() const noexcept {
+            return this->msk == std::byte{};
         }
 
+        /// Returns the bits of the value which are set in the mask
         [[nodiscard]] constexpr std::byte value() const noexcept {
             return this->val;
         }
 
+        /// Returns the bits of a byte which have to match the value
+        [[nodiscard]] constexpr std::byte mask() const noexcept {
+            return this->msk;
+        }
+
+        [[nodiscard]] constexpr bool matches(const std::byte byte) const noexcept {
+            return (byte & this->msk) == this->val;
+        }
+
         [[nodiscard]] constexpr operator bool() const noexcept {
             return this->has_value();
         }
@@ -48,7 +71,7 @@ namespace hat {
         }
     private:
         std::byte val{};
-        bool present = false;
+        std::byte msk{};
     };
 
     using signature = std::vector<signature_element>;
@@ -90,31 +113,207 @@ namespace hat {
         empty_signature,
     };
 
+    namespace detail {
+
+        [[nodiscard]] constexpr std::optional<signature_element> parse_element(const std::string_view word) {
+            // A full wildcard, "?" or "??"
+            if (word.find_first_not_of('?') == std::string_view::npos) {
+                return signature_element{};
+            }
+            // A byte with bits masked out, "VV&MM". Not found with string_view::find, which GCC can't constant evaluate
+            // on a signature literal when the build is instrumented with -fsanitize=undefined.
+            if (const auto amp = static_cast<size_t>(std::ranges::find(word, '&') - word.begin()); amp != word.size()) {
+                const auto value = parse_int<uint8_t>(word.substr(0, amp), 16);
+                const auto mask = parse_int<uint8_t>(word.substr(amp + 1), 16);
+                if (amp == 0 || amp + 1 == word.size() || !value.has_value() || !mask.has_value()) {
+                    return std::nullopt;
+                }
+                return signature_element{static_cast<std::byte>(value.value()), static_cast<std::byte>(mask.value())};
+            }
+            // A byte with one of its nibbles masked out, "4?" or "?B"
+            if (word.size() == 2 && (word[0] == '?') != (word[1] == '?')) {
+                const bool high = word[1] == '?';
+                const auto nibble = parse_int<uint8_t>(word.substr(high ? 0 : 1, 1), 16);
+                if (!nibble.has_value()) {
+                    return std::nullopt;
+                }
+                return high
+                    ? signature_element{static_cast<std::byte>(nibble.value() << 4), std::byte{0xF0}}
+                    : signature_element{static_cast<std::byte>(nibble.value()), std::byte{0x0F}};
+            }
+            const auto parsed = parse_int<uint8_t>(word, 16);
+            if (!parsed.has_value()) {
+                return std::nullopt;
+            }
+            return signature_element{static_cast<std::byte>(parsed.value())};
+        }
+    }
+
+    namespace detail {
+
+        /// Returns the number of space separated words in the string, which is the number of elements a signature
+        /// parsed from it has
+        [[nodiscard]] constexpr size_t count_elements(const std::string_view str) noexcept {
+            size_t count = 0;
+            bool word = false;
+            for (const char c : str) {
+                count += !word && c != ' ';
+                word = c != ' ';
+            }
+            return count;
+        }
+
+        /// Parses the elements of a signature string and passes each of them to the sink, in order. Returns the error
+        /// if the string isn't a valid signature, in which case some of the elements may have been passed already.
+        template<typename Sink>
+        [[nodiscard]] constexpr std::optional<signature_parse_error> parse_elements(const std::string_view str, Sink&& sink) {
+            bool containsElement = false;
+            bool containsByte = false;
+            for (const auto& word : str | std::views::split(' ')) {
+                if (word.empty()) {
+                    continue;
+                }
+                const auto element = parse_element(std::string_view{word.begin(), word.end()});
+                if (!element.has_value()) {
+                    return signature_parse_error::parse_error;
+                }
+                sink(element.value());
+                containsElement = true;
+                containsByte |= !element->is_wildcard();
+            }
+            if (!containsElement) {
+                return signature_parse_error::empty_signature;
+            }
+            if (!containsByte) {
+                return signature_parse_error::missing_byte;
+            }
+            return std::nullopt;
+        }
+    }
+
+    /// Parses a signature from its string representation, a list of space separated elements. Each element is either
+    /// a byte in hex ("8B"), a wildcard ("?" or "??"), a byte with one nibble masked out ("4?" or "?B"), or a byte with
+    /// an arbitrary bit mask applied ("40&F8", which matches 40 through 47).
     [[nodiscard]] constexpr result<signature, signature_parse_error> parse_signature(std::string_view str) {
         signature sig{};
-        bool containsByte = false;
-        for (const auto& word : str | std::views::split(' ')) {
-            if (word.empty()) {
-                continue;
+        sig.reserve(detail::count_elements(str));
+        if (const auto error = detail::parse_elements(str, [&](const signature_element element) { sig.push_back(element); })) {
+            return result_error{error.value()};
+        }
+        return sig;
+    }
+
+    /// A signature which stores up to N elements inline, and only allocates once it grows larger than that. Most
+    /// signatures are short enough to never allocate, which avoids the allocation for every signature that is built
+    /// at runtime, e.g. from a configuration file or from the bytes of an object.
+    template<size_t N>
+    class small_signature {
+    public:
+        constexpr small_signature() = default;
+
+        constexpr explicit small_signature(const signature_view elements) {
+            this->append(elements);
+        }
+
+        constexpr small_signature(const small_signature&) = default;
+        constexpr small_signature& operator=(const small_signature&) = default;
+
+        constexpr small_signature(small_signature&& other) noexcept
+            : local(other.local), heap(std::move(other.heap)), count(std::exchange(other.count, 0)) {}
+
+        constexpr small_signature& operator=(small_signature&& other) noexcept {
+            this->local = other.local;
+            this->heap = std::move(other.heap);
+            this->count = std::exchange(other.count, 0);
+            return *this;
+        }
+
+        constexpr void push_back(const signature_element element) {
+            if (this->count == N) {
+                this->heap.reserve(N * 2);
+                this->heap.assign(this->local.begin(), this->local.end());
             }
-            if (word[0] == '?') {
-                sig.emplace_back(std::nullopt);
+            if (this->count >= N) {
+                this->heap.push_back(element);
             } else {
-                const auto sv = std::string_view{word.begin(), word.end()};
-                const auto parsed = parse_int<uint8_t>(sv, 16);
-                if (parsed.has_value()) {
-                    sig.emplace_back(static_cast<std::byte>(parsed.value()));
-                } else {
-                    return result_error{signature_parse_error::parse_error};
+                this->local[this->count] = element;
+            }
+            this->count++;
+        }
+
+        /// Appends a range of elements, or of bytes which have to match exactly
+        template<std::ranges::input_range R> requires std::convertible_to<std::ranges::range_value_t<R>, signature_element>
+        constexpr void append(const R& elements) {
+            if constexpr (std::ranges::sized_range<R>) {
+                if (const auto size = this->count + std::ranges::size(elements); size > N) {
+                    this->heap.reserve(size);
                 }
-                containsByte = true;
             }
+            for (const auto element : elements) {
+                this->push_back(element);
+            }
+        }
+
+        /// Returns whether the elements are stored inline
+        [[nodiscard]] constexpr bool is_inline() const noexcept {
+            return this->count <= N;
+        }
+
+        [[nodiscard]] constexpr signature_element* data() noexcept {
+            return this->is_inline() ? this->local.data() : this->heap.data();
+        }
+
+        [[nodiscard]] constexpr const signature_element* data() const noexcept {
+            return this->is_inline() ? this->local.data() : this->heap.data();
+        }
+
+        [[nodiscard]] constexpr size_t size() const noexcept {
+            return this->count;
+        }
+
+        [[nodiscard]] constexpr bool empty() const noexcept {
+            return this->count == 0;
+        }
+
+        [[nodiscard]] constexpr signature_element* begin() noexcept {
+            return this->data();
+        }
+
+        [[nodiscard]] constexpr signature_element* end() noexcept {
+            return this->data() + this->count;
+        }
+
+        [[nodiscard]] constexpr const signature_element* begin() const noexcept {
+            return this->data();
+        }
+
+        [[nodiscard]] constexpr const signature_element* end() const noexcept {
+            return this->data() + this->count;
         }
-        if (sig.empty()) {
-            return result_error{signature_parse_error::empty_signature};
+
+        [[nodiscard]] constexpr signature_element& operator[](const size_t index) noexcept {
+            return this->data()[index];
         }
-        if (!containsByte) {
-            return result_error{signature_parse_error::missing_byte};
+
+        [[nodiscard]] constexpr const signature_element& operator[](const size_t index) const noexcept {
+            return this->data()[index];
+        }
+
+        [[nodiscard]] constexpr operator signature_view() const noexcept {
+            return {this->data(), this->count};
+        }
+    private:
+        std::array<signature_element, N> local{};
+        signature heap{}; // Holds every element once there are more than N
+        size_t count{};
+    };
+
+    /// Parses a signature like parse_signature, into a small_signature
+    template<size_t N = 32>
+    [[nodiscard]] constexpr result<small_signature<N>, signature_parse_error> parse_small_signature(std::string_view str) {
+        small_signature<N> sig{};
+        if (const auto error = detail::parse_elements(str, [&](const signature_element element) { sig.push_back(element); })) {
+            return result_error{error.value()};
         }
         return sig;
     }
@@ -133,16 +332,26 @@ namespace hat {
         constexpr std::string_view hex{"0123456789ABCDEF"};
         std::string ret;
         ret.reserve(signature.size() * 3);
+        auto digits = [&](const std::byte byte) {
+            ret += hex[static_cast<size_t>(byte >> 4) & 0xFu];
+            ret += hex[static_cast<size_t>(byte >> 0) & 0xFu];
+        };
         for (auto& element : signature) {
-            if (element.has_value()) {
-                ret += {
-                    hex[static_cast<size_t>(element.value() >> 4) & 0xFu],
-                    hex[static_cast<size_t>(element.value() >> 0) & 0xFu],
-                    ' '
-                };
+            const auto value = static_cast<size_t>(element.value());
+            if (element.is_wildcard()) {
+                ret += "?";
+            } else if (element.mask() == std::byte{0xF0}) {
+                ret += {hex[value >> 4], '?'};
+            } else if (element.mask() == std::byte{0x0F}) {
+                ret += {'?', hex[value & 0xFu]};
             } else {
-                ret += "? ";
+                digits(element.value());
+                if (!element.has_value()) {
+                    ret += '&';
+                    digits(element.mask());
+                }
             }
+            ret += ' ';
         }
         ret.pop_back();
         return ret;
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "Result.hpp"
+#include "Signature.hpp"
+
+namespace hat {
+
+    /// Stores the elements of many signatures in a few large blocks, for parsing a large number of signatures at once,
+    /// e.g. a database of signatures loaded at startup. Parsing into an arena allocates once per block instead of once
+    /// per signature, and keeps the signatures next to each other in memory. The returned views remain valid until the
+    /// arena is cleared or destroyed.
+    class signature_arena {
+    public:
+        /// Creates an arena which allocates blocks of at least the given number of elements
+        explicit signature_arena(size_t blockSize = 4096);
+
+        signature_arena(signature_arena&&) noexcept = default;
+        signature_arena& operator=(signature_arena&&) noexcept = default;
+
+        /// Parses a signature like parse_signature, and stores its elements in the arena. Nothing is stored if the
+        /// signature isn't valid.
+        [[nodiscard]] result<signature_view, signature_parse_error> parse(std::string_view str);
+
+        /// Stores a copy of the signature in the arena
+        signature_view store(signature_view signature);
+
+        /// Returns the number of elements stored in the arena
+        [[nodiscard]] size_t size() const noexcept {
+            return this->elements;
+        }
+
+        /// Removes every signature from the arena, invalidating the views of them. The first block is kept for reuse.
+        void clear() noexcept;
+    private:
+        struct block {
+            std::unique_ptr<signature_element[]> data;
+            size_t capacity;
+        };
+
+        // Returns space for count elements at the end of the last block, allocating a new block if it doesn't fit.
+        // The space is only taken once commit is called.
+        [[nodiscard]] signature_element* reserve(size_t count);
+        signature_view commit(size_t count);
+
+        size_t blockSize;
+        std::vector<block> blocks{};
+        size_t used{}; // Number of elements used in the last block
+        size_t elements{};
+    };
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "CompiledPattern.hpp"
+#include "Scanner.hpp"
+#include "Signature.hpp"
+
+namespace hat {
+
+    /// Scans a stream of data which is not contiguous in memory, such as a network capture or a decompressed file,
+    /// for a signature. The stream is fed to the scanner in successive chunks of any size, and matches are reported as
+    /// offsets from the start of the stream. Only the last signature.size() - 1 bytes of the stream are retained
+    /// between chunks, so that matches spanning chunk boundaries are found without concatenating the chunks.
+    class stream_scanner {
+    public:
+        /// Creates a scanner for the signature. Like for the other scans, the alignment applies to the first element of
+        /// a match that isn't a wildcard, but to its stream offset, which is independent of the address of the chunk
+        /// containing it.
+        explicit stream_scanner(
+            const signature_view signature,
+            const scan_alignment alignment = scan_alignment::X1,
+            const scan_hint      hints = scan_hint::none
+        ) : pattern(signature, scan_alignment::X1, hints),
+            lead(detail::truncate(signature).first),
+            stride(static_cast<size_t>(alignment)) {
+            this->tail.reserve(this->pattern.size());
+            this->scratch.reserve(this->pattern.size() * 2);
+        }
+
+        /// Scans the next chunk of the stream, and invokes the callback with the stream offset of every match which
+        /// ends within the chunk, in ascending order. If the callback returns a value convertible to bool, returning
+        /// false stops reporting matches for the rest of the chunk. The chunk is consumed either way.
+        template<typename Fn>
+        void feed(const std::span<const std::byte> chunk, Fn&& callback) {
+            bool reporting = true;
+            auto report = [&](const uint64_t offset) {
+                if (!reporting || (offset + this->lead) % this->stride != 0) {
+                    return;
+                }
+                if constexpr (std::is_convertible_v<std::invoke_result_t<Fn&, uint64_t>, bool>) {
+                    reporting = static_cast<bool>(callback(offset));
+                } else {
+                    callback(offset);
+                }
+            };
+
+            const auto overlap = this->pattern.size() ? this->pattern.size() - 1 : 0;
+            const auto tailOffset = this->consumed - this->tail.size();
+
+            // Matches beginning in the retained bytes may end within the first size - 1 bytes of the chunk
+            if (!this->tail.empty()) {
+                const auto head = chunk.first(std::min(chunk.size(), overlap));
+                this->scratch.assign(this->tail.begin(), this->tail.end());
+                this->scratch.insert(this->scratch.end(), head.begin(), head.end());
+                this->scan(this->scratch, this->tail.size(), [&](const size_t index) {
+                    report(tailOffset + index);
+                });
+            }
+
+            this->scan(chunk, chunk.size(), [&](const size_t index) {
+                report(this->consumed + index);
+            });
+
+            // Retain the last size - 1 bytes of the stream, these are the only positions at which a match may begin
+            // without having been reported yet
+            const auto retained = std::min<size_t>(overlap, this->tail.size() + chunk.size());
+            if (chunk.size() >= retained) {
+                this->tail.assign(chunk.end() - static_cast<ptrdiff_t>(retained), chunk.end());
+            } else {
+                this->tail.erase(this->tail.begin(), this->tail.end() - static_cast<ptrdiff_t>(retained - chunk.size()));
+                this->tail.insert(this->tail.end(), chunk.begin(), chunk.end());
+            }
+            this->consumed += chunk.size();
+        }
+
+        /// Scans the next chunk of the stream, and returns the stream offsets of the matches which end within it
+        std::vector<uint64_t> feed(const std::span<const std::byte> chunk) {
+            std::vector<uint64_t> results{};
+            this->feed(chunk, [&](const uint64_t offset) {
+                results.push_back(offset);
+            });
+            return results;
+        }
+
+        /// Returns the number of bytes that have been fed to the scanner
+        [[nodiscard]] uint64_t offset() const noexcept {
+            return this->consumed;
+        }
+
+        /// Discards the retained bytes, and starts a new stream at offset 0
+        void reset() noexcept {
+            this->tail.clear();
+            this->consumed = 0;
+        }
+    private:
+        // Invokes fn with the index of every match in data which begins before the limit, in a single pass
+        template<typename Fn>
+        void scan(const std::span<const std::byte> data, const size_t limit, Fn&& fn) const {
+            const auto begin = data.data();
+            const auto last = begin + limit;
+            this->pattern.find_all(begin, begin + data.size(), [&](const const_scan_result result) {
+                if (result.get() >= last) {
+                    return false;
+                }
+                fn(static_cast<size_t>(result.get() - begin));
+                return true;
+            });
+        }
+
+        compiled_pattern pattern;
+        size_t lead{};   // Number of leading wildcards of the signature
+        size_t stride{};
+        std::vector<std::byte> tail{};
+        std::vector<std::byte> scratch{};
+        uint64_t consumed{};
+    };
+}
@@ -38,10 +38,16 @@ namespace hat {
 namespace hat {
 
     struct system_info_arm {
+        struct {
+            bool neon;
+            bool sve;
+            bool sve2;
+        } extensions{};
+
         system_info_arm(const system_info_arm&) = delete;
         system_info_arm& operator=(const system_info_arm&) = delete;
     private:
-        system_info_arm() = default;
+        system_info_arm();
         friend const system_info_arm& get_system();
         static const system_info_arm instance;
     };
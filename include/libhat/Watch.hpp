@@ -0,0 +1,63 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "PatternSet.hpp"
+#include "Scanner.hpp"
+#include "Signature.hpp"
+
+namespace hat {
+
+    /// Size of the pages a watch hashes the range in, independent of the page size of the system
+    inline constexpr size_t watch_page_size = 4096;
+
+    struct watch_update {
+        size_t pages{};   // Number of pages which were rescanned
+        size_t added{};   // Number of matches which were found in the rescanned pages
+        size_t removed{}; // Number of matches which no longer match
+    };
+
+    /// Keeps the matches of a set of signatures in a range up to date, e.g. to detect code being patched or reloaded by
+    /// running the same integrity scan periodically. The range is scanned in full once, and a hash of every page of it
+    /// is kept. Every update only rescans the pages whose hash changed, extended by the longest signature on either
+    /// side, so an update of an unchanged range costs a single hashing pass instead of a scan for every signature.
+    class watch {
+    public:
+        watch(std::span<std::byte> range, std::span<const signature_view> signatures, scan_alignment alignment = scan_alignment::X1);
+
+        /// Returns the watched range
+        [[nodiscard]] std::span<std::byte> range() const noexcept {
+            return this->data;
+        }
+
+        /// Returns the number of signatures
+        [[nodiscard]] size_t size() const noexcept {
+            return this->results.size();
+        }
+
+        /// Returns the current matches of the signature at the given index, in ascending address order
+        [[nodiscard]] std::span<const scan_result> matches(const size_t index) const noexcept {
+            return this->results[index];
+        }
+
+        /// Rehashes every page of the range, and rescans the pages which changed since the last update
+        watch_update update();
+
+        /// Rescans the given regions of the range without hashing any other page, for callers which track changes
+        /// themselves, e.g. through GetWriteWatch on a buffer allocated with MEM_WRITE_WATCH. The hashes of the pages
+        /// overlapping the regions are refreshed as well.
+        watch_update update(std::span<const std::span<std::byte>> changed);
+    private:
+        [[nodiscard]] uint64_t hash_page(size_t page) const;
+
+        // Rescans the sorted and disjoint page ranges [first, last)
+        watch_update rescan(std::span<const std::pair<size_t, size_t>> pages);
+
+        std::span<std::byte> data;
+        pattern_set set;
+        size_t margin{}; // Size of the longest signature minus one
+        std::vector<uint64_t> hashes{};
+        std::vector<std::vector<scan_result>> results{};
+    };
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "Process.hpp"
+#include "Scanner.hpp"
+
+namespace hat {
+
+    enum class xref_kind : uint8_t {
+        none         = 0,
+        pointer      = 1 << 0, // A naturally aligned absolute pointer
+        relative     = 1 << 1, // The rel32 operand of an x86 call, jmp, or RIP-relative mov or lea
+        image_offset = 1 << 2, // A 32-bit aligned offset from the module base, as used by MSVC RTTI on x86-64
+        all          = pointer | relative | image_offset
+    };
+
+    constexpr xref_kind operator|(xref_kind lhs, xref_kind rhs) {
+        using U = std::underlying_type_t<xref_kind>;
+        return static_cast<xref_kind>(static_cast<U>(lhs) | static_cast<U>(rhs));
+    }
+
+    constexpr xref_kind operator&(xref_kind lhs, xref_kind rhs) {
+        using U = std::underlying_type_t<xref_kind>;
+        return static_cast<xref_kind>(static_cast<U>(lhs) & static_cast<U>(rhs));
+    }
+
+    /// A reference from one address in a module to another address in the same module
+    struct xref {
+        std::byte* target;
+        std::byte* source; // Address of the pointer, offset, or instruction operand which refers to the target
+        xref_kind  kind;
+    };
+
+    /// Every cross-reference within a module, collected in a single pass over its memory so that finding the references
+    /// to an address is a binary search instead of a scan. Only values which refer into the module are recorded. Like
+    /// a signature scan, the index is a superset of the real references: any aligned value that happens to look like an
+    /// address, and any byte sequence that looks like a call, jmp, mov, or lea, is included. The index is a snapshot, it
+    /// has to be rebuilt if the module is modified or relocated.
+    class xref_index {
+    public:
+        xref_index() = default;
+
+        /// Collects the references of the given kinds in the readable memory of the module. Relative references are
+        /// only collected from executable memory, and only on x86.
+        [[nodiscard]] static xref_index build(
+            process::module_t mod = process::get_process_module(),
+            xref_kind         kinds = xref_kind::pointer | xref_kind::relative
+        );
+
+        /// Returns every reference to the target, grouped by kind, and in ascending order of source address per kind
+        [[nodiscard]] std::span<const xref> references(const void* target) const;
+
+        /// Returns the lowest source address of a reference of any of the given kinds to the target
+        [[nodiscard]] scan_result find(const void* target, xref_kind kinds = xref_kind::all) const;
+
+        /// Returns the lowest source address within the range of a reference of any of the given kinds to the target
+        [[nodiscard]] scan_result find(const void* target, xref_kind kinds, std::span<const std::byte> range) const;
+
+        /// Returns the number of references in the index
+        [[nodiscard]] size_t size() const noexcept {
+            return this->entries.size();
+        }
+
+        [[nodiscard]] bool empty() const noexcept {
+            return this->entries.empty();
+        }
+    private:
+        std::vector<xref> entries{};
+    };
+}
+
+namespace hat::experimental {
+
+    /// Gets the VTable address for a class by its mangled name, resolving the references between the RTTI structures
+    /// through an index of the module instead of scanning its sections for each of them. The index has to contain the
+    /// pointers of the module, and for MSVC also the image offsets.
+    template<compiler_type compiler>
+    scan_result find_vtable(
+        const std::string&  className,
+        const xref_index&   index,
+        process::module_t   mod = process::get_process_module()
+    );
+}
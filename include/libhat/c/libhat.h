@@ -1,8 +1,12 @@
 #pragma once
 
 #if defined(LIBHAT_BUILD_SHARED_LIB)
-    #define LIBHAT_API __declspec(dllexport)
-#elif defined(LIBHAT_USE_SHARED_LIB)
+    #if defined(_WIN32)
+        #define LIBHAT_API __declspec(dllexport)
+    #else
+        #define LIBHAT_API __attribute__((visibility("default")))
+    #endif
+#elif defined(LIBHAT_USE_SHARED_LIB) && defined(_WIN32)
     #define LIBHAT_API __declspec(dllimport)
 #else
     #define LIBHAT_API
@@ -22,9 +26,15 @@ typedef enum libhat_status_t {
     libhat_err_sig_nobyte,  // The signature did not contain a present byte, only wildcards
 } libhat_status_t;
 
+// The values of the existing alignments are part of the ABI, new alignments are only ever appended
 typedef enum scan_alignment {
     scan_alignment_x1,
     scan_alignment_x16,
+    scan_alignment_x2,
+    scan_alignment_x4,
+    scan_alignment_x8,
+    scan_alignment_x32,
+    scan_alignment_x64,
 } scan_alignment_t;
 
 typedef struct signature {
@@ -32,6 +42,9 @@ typedef struct signature {
     size_t count;
 } signature_t;
 
+// Opaque handle to a signature with a pre-resolved scanner
+typedef struct compiled_pattern compiled_pattern_t;
+
 LIBHAT_API libhat_status_t libhat_parse_signature(
     const char*   signatureStr,
     signature_t** signatureOut
@@ -48,16 +61,92 @@ LIBHAT_API const void* libhat_find_pattern(
     const signature_t*  signature,
     const void*         buffer,
     size_t              size,
-    scan_alignment      align
+    scan_alignment_t    align
 );
 
 LIBHAT_API const void* libhat_find_pattern_mod(
     const signature_t*  signature,
     const void*         module,
     const char*         section,
-    scan_alignment      align
+    scan_alignment_t    align
+);
+
+// Writes at most `capacity` matches into `resultsOut`, and returns the number of matches that were written. The scan
+// stops once the buffer is full, so a return value equal to `capacity` may indicate that there were more matches.
+LIBHAT_API size_t libhat_find_all_pattern(
+    const signature_t*  signature,
+    const void*         buffer,
+    size_t              size,
+    scan_alignment_t    align,
+    const void**        resultsOut,
+    size_t              capacity
+);
+
+LIBHAT_API size_t libhat_find_all_pattern_mod(
+    const signature_t*  signature,
+    const void*         module,
+    const char*         section,
+    scan_alignment_t    align,
+    const void**        resultsOut,
+    size_t              capacity
+);
+
+// Finds the first match for each of the `count` signatures in a single pass over the buffer. `resultsOut` must have
+// room for `count` results, and receives NULL for each signature without a match.
+LIBHAT_API libhat_status_t libhat_find_patterns(
+    const signature_t* const*  signatures,
+    size_t                     count,
+    const void*                buffer,
+    size_t                     size,
+    scan_alignment_t           align,
+    const void**               resultsOut
 );
 
+LIBHAT_API libhat_status_t libhat_find_patterns_mod(
+    const signature_t* const*  signatures,
+    size_t                     count,
+    const void*                module,
+    const char*                section,
+    scan_alignment_t           align,
+    const void**               resultsOut
+);
+
+LIBHAT_API libhat_status_t libhat_compile_pattern(
+    const signature_t*    signature,
+    scan_alignment_t      align,
+    compiled_pattern_t**  patternOut
+);
+
+LIBHAT_API const void* libhat_find_compiled_pattern(
+    const compiled_pattern_t*  pattern,
+    const void*                buffer,
+    size_t                     size
+);
+
+LIBHAT_API const void* libhat_find_compiled_pattern_mod(
+    const compiled_pattern_t*  pattern,
+    const void*                module,
+    const char*                section
+);
+
+LIBHAT_API size_t libhat_find_all_compiled_pattern(
+    const compiled_pattern_t*  pattern,
+    const void*                buffer,
+    size_t                     size,
+    const void**               resultsOut,
+    size_t                     capacity
+);
+
+LIBHAT_API size_t libhat_find_all_compiled_pattern_mod(
+    const compiled_pattern_t*  pattern,
+    const void*                module,
+    const char*                section,
+    const void**               resultsOut,
+    size_t                     capacity
+);
+
+LIBHAT_API void libhat_free_compiled_pattern(compiled_pattern_t* pattern);
+
 LIBHAT_API const void* libhat_get_module(const char* name);
 
 LIBHAT_API void libhat_free(void* mem);
@@ -0,0 +1,99 @@
+#include <libhat/FrequencyModel.hpp>
+
+#include <algorithm>
+#include <array>
+#include <mutex>
+#include <utility>
+
+#include "arch/x86/Frequency.hpp"
+
+namespace hat {
+
+    // Sampling reads at most sample_blocks * sample_block_size bytes, spread evenly across the data
+    static constexpr size_t sample_blocks = 256;
+    static constexpr size_t sample_block_size = 4096;
+
+    // Number of measured models kept around for reuse
+    static constexpr size_t measure_cache_size = 8;
+
+    void frequency_model::add(const std::span<const std::byte> data) {
+        for (size_t i = 1; i < data.size(); i++) {
+            this->counts[static_cast<size_t>(data[i - 1]) << 8 | static_cast<size_t>(data[i])]++;
+        }
+        this->update_totals();
+    }
+
+    void frequency_model::update_totals() {
+        this->byteCounts.fill(0);
+        for (size_t pair = 0; pair < this->counts.size(); pair++) {
+            this->byteCounts[pair >> 8] += this->counts[pair];
+        }
+        this->pairTotal = 0;
+        for (const auto count : this->byteCounts) {
+            this->pairTotal += count;
+        }
+    }
+
+    frequency_model frequency_model::from_data(const std::span<const std::byte> data) {
+        frequency_model model{};
+        model.add(data);
+        return model;
+    }
+
+    frequency_model frequency_model::sample(const std::span<const std::byte> data) {
+        if (data.size() <= sample_blocks * sample_block_size) {
+            return from_data(data);
+        }
+
+        frequency_model model{};
+        const auto stride = data.size() / sample_blocks;
+        for (size_t i = 0; i < sample_blocks; i++) {
+            model.add(data.subspan(i * stride, sample_block_size));
+        }
+        return model;
+    }
+
+    const frequency_model& frequency_model::x86_64() {
+        // Only the ranking of the most common pairs is known, so each one is weighted by its rank, and all of the
+        // remaining pairs are considered equally rare
+        static const frequency_model model = [] {
+            frequency_model m{};
+            constexpr auto& pairs = detail::x86_64::pairs_x1;
+            for (size_t rank = 0; rank < pairs.size(); rank++) {
+                const auto [a, b] = pairs[rank];
+                m.counts[static_cast<size_t>(a) << 8 | static_cast<size_t>(b)] = static_cast<uint32_t>(pairs.size() - rank);
+            }
+            m.update_totals();
+            m.measured = false;
+            return m;
+        }();
+        return model;
+    }
+
+    std::shared_ptr<const frequency_model> frequency_model::measure(const std::span<const std::byte> data) {
+        using key_type = std::pair<const std::byte*, size_t>;
+        static std::mutex mutex{};
+        static std::vector<std::pair<key_type, std::shared_ptr<const frequency_model>>> cache{};
+
+        const key_type key{data.data(), data.size()};
+        {
+            std::lock_guard lock{mutex};
+            const auto it = std::ranges::find(cache, key, &decltype(cache)::value_type::first);
+            if (it != cache.end()) {
+                // Move the entry to the front, so that the least recently used entry is evicted first
+                std::rotate(cache.begin(), it, it + 1);
+                return cache.front().second;
+            }
+        }
+
+        // Sample outside of the lock, two threads measuring the same data at once just results in duplicate work
+        auto model = std::make_shared<const frequency_model>(sample(data));
+
+        std::lock_guard lock{mutex};
+        if (cache.size() == measure_cache_size) {
+            cache.pop_back();
+        }
+        cache.emplace(cache.begin(), key, model);
+        return model;
+    }
+}
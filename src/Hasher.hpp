@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+namespace hat::detail {
+
+    // Hashes 32 bytes per iteration in four independent lanes, so that hashing a section runs at close to the speed of
+    // reading it. This only needs to detect changed data, it isn't meant to withstand deliberate collisions.
+    class hasher {
+    public:
+        void update(const std::span<const std::byte> data) {
+            auto it = data.data();
+            const auto end = it + data.size();
+            for (; end - it >= 32; it += 32) {
+                for (size_t lane = 0; lane < 4; lane++) {
+                    uint64_t word;
+                    std::memcpy(&word, it + lane * 8, sizeof(word));
+                    this->lanes[lane] = mix(this->lanes[lane] ^ word);
+                }
+            }
+            for (; it != end; it++) {
+                this->lanes[0] = mix(this->lanes[0] ^ static_cast<uint64_t>(*it));
+            }
+            this->length += data.size();
+        }
+
+        template<typename T> requires std::is_trivially_copyable_v<T>
+        void update(const T& value) {
+            this->update(std::as_bytes(std::span{&value, 1}));
+        }
+
+        [[nodiscard]] uint64_t digest() const {
+            uint64_t h = this->length;
+            for (const auto lane : this->lanes) {
+                h = mix(h ^ lane);
+            }
+            return h;
+        }
+    private:
+        static constexpr uint64_t mix(uint64_t h) {
+            h *= 0x9E3779B97F4A7C15;
+            return h ^ (h >> 32);
+        }
+
+        uint64_t lanes[4]{0x243F6A8885A308D3, 0x13198A2E03707344, 0xA4093822299F31D0, 0x082EFA98EC4E6C89};
+        uint64_t length{};
+    };
+}
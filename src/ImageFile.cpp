@@ -0,0 +1,341 @@
+#include <libhat/ImageFile.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace hat {
+
+    // The headers are parsed from the file with these definitions rather than the ones provided by the platform, so
+    // that images of any format can be opened on every platform. All fields are little endian.
+    namespace pe {
+
+        struct file_header {
+            uint16_t machine;
+            uint16_t numberOfSections;
+            uint32_t timeDateStamp;
+            uint32_t pointerToSymbolTable;
+            uint32_t numberOfSymbols;
+            uint16_t sizeOfOptionalHeader;
+            uint16_t characteristics;
+        };
+
+        struct section_header {
+            char     name[8];
+            uint32_t virtualSize;
+            uint32_t virtualAddress;
+            uint32_t sizeOfRawData;
+            uint32_t pointerToRawData;
+            uint32_t pointerToRelocations;
+            uint32_t pointerToLinenumbers;
+            uint16_t numberOfRelocations;
+            uint16_t numberOfLinenumbers;
+            uint32_t characteristics;
+        };
+
+        static constexpr uint16_t dos_signature = 0x5A4D;     // "MZ"
+        static constexpr uint32_t nt_signature = 0x00004550;  // "PE\0\0"
+        static constexpr uint16_t pe32_magic = 0x10B;
+        static constexpr uint16_t pe32plus_magic = 0x20B;
+
+        static constexpr uint32_t scn_mem_execute = 0x20000000;
+        static constexpr uint32_t scn_mem_read = 0x40000000;
+        static constexpr uint32_t scn_mem_write = 0x80000000;
+    }
+
+    namespace elf {
+
+        struct elf64 {
+            struct header {
+                uint8_t  ident[16];
+                uint16_t type;
+                uint16_t machine;
+                uint32_t version;
+                uint64_t entry;
+                uint64_t phoff;
+                uint64_t shoff;
+                uint32_t flags;
+                uint16_t ehsize;
+                uint16_t phentsize;
+                uint16_t phnum;
+                uint16_t shentsize;
+                uint16_t shnum;
+                uint16_t shstrndx;
+            };
+
+            struct program_header {
+                uint32_t type;
+                uint32_t flags;
+                uint64_t offset;
+                uint64_t vaddr;
+                uint64_t paddr;
+                uint64_t filesz;
+                uint64_t memsz;
+                uint64_t align;
+            };
+
+            struct section_header {
+                uint32_t name;
+                uint32_t type;
+                uint64_t flags;
+                uint64_t addr;
+                uint64_t offset;
+                uint64_t size;
+                uint32_t link;
+                uint32_t info;
+                uint64_t addralign;
+                uint64_t entsize;
+            };
+        };
+
+        struct elf32 {
+            struct header {
+                uint8_t  ident[16];
+                uint16_t type;
+                uint16_t machine;
+                uint32_t version;
+                uint32_t entry;
+                uint32_t phoff;
+                uint32_t shoff;
+                uint32_t flags;
+                uint16_t ehsize;
+                uint16_t phentsize;
+                uint16_t phnum;
+                uint16_t shentsize;
+                uint16_t shnum;
+                uint16_t shstrndx;
+            };
+
+            struct program_header {
+                uint32_t type;
+                uint32_t offset;
+                uint32_t vaddr;
+                uint32_t paddr;
+                uint32_t filesz;
+                uint32_t memsz;
+                uint32_t flags;
+                uint32_t align;
+            };
+
+            struct section_header {
+                uint32_t name;
+                uint32_t type;
+                uint32_t flags;
+                uint32_t addr;
+                uint32_t offset;
+                uint32_t size;
+                uint32_t link;
+                uint32_t info;
+                uint32_t addralign;
+                uint32_t entsize;
+            };
+        };
+
+        static constexpr uint8_t magic[4]{0x7F, 'E', 'L', 'F'};
+        static constexpr uint8_t class32 = 1;
+        static constexpr uint8_t class64 = 2;
+
+        static constexpr uint32_t pt_load = 1;
+
+        static constexpr uint32_t sht_nobits = 8;
+        static constexpr uint64_t shf_write = 0x1;
+        static constexpr uint64_t shf_alloc = 0x2;
+        static constexpr uint64_t shf_execinstr = 0x4;
+    }
+
+    // Reads an object of the given type at the offset into the file, if it fits
+    template<typename T>
+    static std::optional<T> readAt(const std::span<const std::byte> file, const size_t offset) {
+        if (offset > file.size() || file.size() - offset < sizeof(T)) {
+            return {};
+        }
+        T object;
+        std::memcpy(&object, file.data() + offset, sizeof(T));
+        return object;
+    }
+
+    // Returns the part of [offset, offset + size) which is contained in the file
+    static std::span<const std::byte> clampToFile(const std::span<const std::byte> file, const uint64_t offset, const uint64_t size) {
+        if (offset >= file.size()) {
+            return {};
+        }
+        return file.subspan(static_cast<size_t>(offset), static_cast<size_t>(std::min<uint64_t>(size, file.size() - offset)));
+    }
+
+    bool image_file::parse() {
+        const auto file = this->data();
+        if (const auto dosSignature = readAt<uint16_t>(file, 0); dosSignature == pe::dos_signature) {
+            this->fileFormat = format::PE;
+            return this->parse_pe();
+        }
+        if (file.size() >= 16 && std::memcmp(file.data(), elf::magic, sizeof(elf::magic)) == 0) {
+            this->fileFormat = format::ELF;
+            switch (static_cast<uint8_t>(file[4])) {
+                case elf::class32: return this->parse_elf<elf::elf32>();
+                case elf::class64: return this->parse_elf<elf::elf64>();
+                default:           return false;
+            }
+        }
+        return false;
+    }
+
+    bool image_file::parse_pe() {
+        const auto file = this->data();
+
+        // e_lfanew, the offset of the NT headers, is the last field of the DOS header
+        const auto ntOffset = readAt<uint32_t>(file, 0x3C);
+        if (!ntOffset || readAt<uint32_t>(file, *ntOffset) != pe::nt_signature) {
+            return false;
+        }
+        const auto fileHeader = readAt<pe::file_header>(file, *ntOffset + 4);
+        if (!fileHeader) {
+            return false;
+        }
+
+        // The optional header starts with the magic, and the offset of SizeOfHeaders is shared by both formats
+        const auto optionalOffset = *ntOffset + 4 + sizeof(pe::file_header);
+        const auto magic = readAt<uint16_t>(file, optionalOffset);
+        if (magic == pe::pe32_magic) {
+            this->preferredBase = readAt<uint32_t>(file, optionalOffset + 28).value_or(0);
+        } else if (magic == pe::pe32plus_magic) {
+            this->preferredBase = readAt<uint64_t>(file, optionalOffset + 24).value_or(0);
+        } else {
+            return false;
+        }
+        const auto sizeOfHeaders = readAt<uint32_t>(file, optionalOffset + 60).value_or(0);
+        this->ranges.push_back({0, 0, std::min<size_t>(sizeOfHeaders, file.size())});
+
+        const auto sectionTable = optionalOffset + fileHeader->sizeOfOptionalHeader;
+        for (size_t i = 0; i < fileHeader->numberOfSections; i++) {
+            const auto header = readAt<pe::section_header>(file, sectionTable + i * sizeof(pe::section_header));
+            if (!header) {
+                return false;
+            }
+
+            protection flags{};
+            if (header->characteristics & pe::scn_mem_read)    flags = flags | protection::Read;
+            if (header->characteristics & pe::scn_mem_write)   flags = flags | protection::Write;
+            if (header->characteristics & pe::scn_mem_execute) flags = flags | protection::Execute;
+
+            // The raw data is padded to the file alignment, which may exceed the size of the section in memory
+            const auto virtualSize = header->virtualSize ? header->virtualSize : header->sizeOfRawData;
+            const auto data = clampToFile(file, header->pointerToRawData, std::min(header->sizeOfRawData, virtualSize));
+
+            this->sectionList.push_back({
+                .name = std::string{header->name, strnlen(header->name, sizeof(header->name))},
+                .data = data,
+                .rva = header->virtualAddress,
+                .virtualSize = virtualSize,
+                .flags = flags
+            });
+            if (!data.empty()) {
+                this->ranges.push_back({header->virtualAddress, static_cast<size_t>(data.data() - file.data()), data.size()});
+            }
+        }
+        return true;
+    }
+
+    template<typename Traits>
+    bool image_file::parse_elf() {
+        using header_t = typename Traits::header;
+        using program_header_t = typename Traits::program_header;
+        using section_header_t = typename Traits::section_header;
+
+        const auto file = this->data();
+        const auto header = readAt<header_t>(file, 0);
+        if (!header) {
+            return false;
+        }
+        if ((header->phnum && header->phentsize != sizeof(program_header_t)) || (header->shnum && header->shentsize != sizeof(section_header_t))) {
+            return false;
+        }
+
+        // The image base is where the first loadable segment would be mapped along with the file headers
+        bool foundLoad = false;
+        std::vector<program_header_t> segments{};
+        for (size_t i = 0; i < header->phnum; i++) {
+            const auto phdr = readAt<program_header_t>(file, static_cast<size_t>(header->phoff) + i * header->phentsize);
+            if (!phdr) {
+                return false;
+            }
+            if (phdr->type != elf::pt_load) {
+                continue;
+            }
+            if (!foundLoad) {
+                this->preferredBase = phdr->vaddr - phdr->offset;
+                foundLoad = true;
+            }
+            segments.push_back(*phdr);
+        }
+
+        for (const auto& segment : segments) {
+            const auto data = clampToFile(file, segment.offset, segment.filesz);
+            if (!data.empty()) {
+                this->ranges.push_back({
+                    static_cast<uintptr_t>(segment.vaddr - this->preferredBase),
+                    static_cast<size_t>(segment.offset),
+                    data.size()
+                });
+            }
+        }
+
+        if (header->shoff == 0 || header->shstrndx >= header->shnum) {
+            return true;
+        }
+        const auto sectionAt = [&](const size_t index) {
+            return readAt<section_header_t>(file, static_cast<size_t>(header->shoff) + index * header->shentsize);
+        };
+
+        const auto strtab = sectionAt(header->shstrndx);
+        if (!strtab) {
+            return false;
+        }
+        const auto names = clampToFile(file, strtab->offset, strtab->size);
+
+        for (size_t i = 0; i < header->shnum; i++) {
+            const auto section = sectionAt(i);
+            if (!section) {
+                return false;
+            }
+            if (section->name >= names.size() || !(section->flags & elf::shf_alloc)) {
+                continue;
+            }
+
+            const auto* name = reinterpret_cast<const char*>(names.data() + section->name);
+            protection flags = protection::Read;
+            if (section->flags & elf::shf_write)     flags = flags | protection::Write;
+            if (section->flags & elf::shf_execinstr) flags = flags | protection::Execute;
+
+            this->sectionList.push_back({
+                .name = std::string{name, strnlen(name, names.size() - section->name)},
+                .data = section->type == elf::sht_nobits ? std::span<const std::byte>{} : clampToFile(file, section->offset, section->size),
+                .rva = static_cast<uintptr_t>(section->addr - this->preferredBase),
+                .virtualSize = static_cast<size_t>(section->size),
+                .flags = flags
+            });
+        }
+        return true;
+    }
+
+    std::span<const std::byte> image_file::get_section_data(const std::string_view name) const {
+        const auto section = std::ranges::find(this->sectionList, name, &image_section::name);
+        return section != this->sectionList.end() ? section->data : std::span<const std::byte>{};
+    }
+
+    std::optional<size_t> image_file::rva_to_offset(const uintptr_t rva) const {
+        for (const auto& range : this->ranges) {
+            if (rva >= range.rva && rva - range.rva < range.size) {
+                return range.offset + (rva - range.rva);
+            }
+        }
+        return {};
+    }
+
+    std::optional<uintptr_t> image_file::offset_to_rva(const size_t offset) const {
+        for (const auto& range : this->ranges) {
+            if (offset >= range.offset && offset - range.offset < range.size) {
+                return range.rva + (offset - range.offset);
+            }
+        }
+        return {};
+    }
+}
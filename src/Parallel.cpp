@@ -0,0 +1,187 @@
+#include <libhat/ScanBuffer.hpp>
+#include <libhat/Scanner.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace hat::detail {
+
+    // Size of the chunks the input is divided into. Small enough to allow cancellation shortly after the first match
+    // is found, and large enough to keep the per-chunk overhead negligible relative to the scan itself.
+    static constexpr size_t parallel_chunk_size = 1 << 20; // 1 MiB
+
+    // Returns the bounds of a chunk. Chunks overlap by the signature size, so that matches on a chunk boundary are found
+    // in the first of the two chunks. Only matches beginning within [chunkBegin, chunkEnd) are accepted by each chunk.
+    static std::tuple<const std::byte*, const std::byte*, const std::byte*> chunk_bounds(
+        const std::byte* begin,
+        const std::byte* end,
+        const size_t signatureSize,
+        const size_t chunk
+    ) {
+        const auto size = static_cast<size_t>(end - begin);
+        const auto chunkBegin = begin + chunk * parallel_chunk_size;
+        const auto chunkEnd = begin + std::min(size, (chunk + 1) * parallel_chunk_size);
+        const auto scanEnd = end - chunkEnd >= static_cast<ptrdiff_t>(signatureSize - 1)
+            ? chunkEnd + (signatureSize - 1)
+            : end;
+        return {chunkBegin, chunkEnd, scanEnd};
+    }
+
+    // On a NUMA system, every chunk is queued on the node which owns its memory, and each node gets its share of the
+    // threads bound to its processors. A thread that runs out of chunks on its own node helps the other nodes, so an
+    // input that lives on a single node still uses every thread, at the cost of remote reads for the helpers.
+    template<typename Fn>
+    static void for_each_chunk_numa(
+        const std::byte* begin,
+        const std::byte* end,
+        const size_t signatureSize,
+        const size_t chunks,
+        const size_t threads,
+        const size_t nodes,
+        Fn& fn
+    ) {
+        struct chunk_queue {
+            std::vector<size_t> chunks{};
+            std::atomic<size_t> next{};
+        };
+
+        std::vector<chunk_queue> queues(nodes);
+        for (size_t chunk = 0; chunk < chunks; chunk++) {
+            const auto node = numa_node_of(begin + chunk * parallel_chunk_size).value_or(0);
+            queues[std::min<size_t>(node, nodes - 1)].chunks.push_back(chunk);
+        }
+
+        auto worker = [&](const size_t home) {
+            for (size_t i = 0; i < nodes; i++) {
+                auto& queue = queues[(home + i) % nodes];
+                for (size_t next = queue.next++; next < queue.chunks.size(); next = queue.next++) {
+                    const auto chunk = queue.chunks[next];
+                    const auto [chunkBegin, chunkEnd, scanEnd] = chunk_bounds(begin, end, signatureSize, chunk);
+                    // Chunks are only in address order within a queue, but every queue has threads of its own to scan
+                    // the chunks before the rejected one
+                    if (!fn(chunk, chunkBegin, chunkEnd, scanEnd)) {
+                        return;
+                    }
+                }
+            }
+        };
+
+        // Hand out the threads to the nodes with chunks in proportion to them, at least one each
+        std::vector<std::jthread> pool{};
+        pool.reserve(threads);
+        for (size_t node = 0; node < nodes; node++) {
+            const auto share = queues[node].chunks.size() * threads / chunks;
+            for (size_t i = 0; i < std::max<size_t>(share, !queues[node].chunks.empty()); i++) {
+                pool.emplace_back([&, node] {
+                    bind_thread_to_node(static_cast<uint32_t>(node));
+                    worker(node);
+                });
+            }
+        }
+    }
+
+    template<typename Fn>
+    static void for_each_chunk(const std::byte* begin, const std::byte* end, const size_t signatureSize, Fn&& fn) {
+        const auto size = static_cast<size_t>(end - begin);
+        const auto chunks = (size + parallel_chunk_size - 1) / parallel_chunk_size;
+        const auto threads = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u), chunks);
+
+        // A pinned node count uses the NUMA scheduling even with a single thread
+        const auto pinned = pinned_numa_node_count();
+        if (const auto nodes = pinned.value_or(numa_node_count()); nodes > 1 && (threads > 1 || pinned)) {
+            for_each_chunk_numa(begin, end, signatureSize, chunks, threads, nodes, fn);
+            return;
+        }
+
+        std::atomic<size_t> next{};
+        auto worker = [&] {
+            for (size_t chunk = next++; chunk < chunks; chunk = next++) {
+                const auto [chunkBegin, chunkEnd, scanEnd] = chunk_bounds(begin, end, signatureSize, chunk);
+                if (!fn(chunk, chunkBegin, chunkEnd, scanEnd)) {
+                    break;
+                }
+            }
+        };
+
+        std::vector<std::jthread> pool{};
+        pool.reserve(threads - 1);
+        for (size_t i = 1; i < threads; i++) {
+            pool.emplace_back(worker);
+        }
+        worker();
+    }
+
+    const_scan_result find_pattern_parallel(const std::byte* begin, const std::byte* end, const scan_context& context) {
+        const auto size = static_cast<size_t>(end - begin);
+        if (size <= parallel_chunk_size) {
+            return context.scan(begin, end);
+        }
+
+        std::vector<const_scan_result> results(size / parallel_chunk_size + 1);
+        std::atomic<size_t> first{results.size()};
+
+        for_each_chunk(begin, end, context.signature.size(), [&](const size_t chunk, const std::byte* chunkBegin, const std::byte*, const std::byte* scanEnd) {
+            // A match has already been found in an earlier chunk
+            if (chunk > first.load(std::memory_order_relaxed)) {
+                return false;
+            }
+            if (static_cast<size_t>(scanEnd - chunkBegin) < context.signature.size()) {
+                return true;
+            }
+
+            const auto result = context.scan(chunkBegin, scanEnd);
+            if (result.has_result()) {
+                results[chunk] = result;
+                size_t expected = first.load(std::memory_order_relaxed);
+                while (chunk < expected && !first.compare_exchange_weak(expected, chunk, std::memory_order_relaxed));
+            }
+            return true;
+        });
+
+        const auto chunk = first.load(std::memory_order_relaxed);
+        return chunk < results.size() ? results[chunk] : nullptr;
+    }
+
+    std::vector<const_scan_result> find_all_pattern_parallel(const std::byte* begin, const std::byte* end, const scan_context& context) {
+        const auto signatureSize = context.signature.size();
+
+        auto scanChunk = [&](std::vector<const_scan_result>& out, const std::byte* chunkBegin, const std::byte* chunkEnd, const std::byte* scanEnd) {
+            for_each_match(context, chunkBegin, scanEnd, [&](const std::byte* match) {
+                if (match >= chunkEnd) {
+                    return false;
+                }
+                out.push_back(match);
+                return true;
+            });
+        };
+
+        const auto size = static_cast<size_t>(end - begin);
+        if (size <= parallel_chunk_size) {
+            std::vector<const_scan_result> results{};
+            scanChunk(results, begin, end, end);
+            return results;
+        }
+
+        std::vector<std::vector<const_scan_result>> chunkResults(size / parallel_chunk_size + 1);
+        for_each_chunk(begin, end, signatureSize, [&](const size_t chunk, const std::byte* chunkBegin, const std::byte* chunkEnd, const std::byte* scanEnd) {
+            scanChunk(chunkResults[chunk], chunkBegin, chunkEnd, scanEnd);
+            return true;
+        });
+
+        // Every chunk only reports matches beginning within itself, so concatenating the chunks preserves address order
+        size_t total{};
+        for (const auto& results : chunkResults) {
+            total += results.size();
+        }
+
+        std::vector<const_scan_result> results{};
+        results.reserve(total);
+        for (const auto& chunk : chunkResults) {
+            results.insert(results.end(), chunk.begin(), chunk.end());
+        }
+        return results;
+    }
+}
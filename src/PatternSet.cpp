@@ -0,0 +1,119 @@
+#include <libhat/PatternSet.hpp>
+
+#include <libhat/Defines.hpp>
+
+#include <algorithm>
+#include <array>
+
+namespace hat {
+
+    pattern_set::pattern_set(const std::span<const signature_view> signatures, const scan_alignment alignment, const scan_hint hints)
+        : count(signatures.size()), alignment(alignment) {
+
+        size_t totalSize{};
+        for (const auto& signature : signatures) {
+            totalSize += signature.size();
+        }
+        this->storage.reserve(totalSize);
+        this->entries.reserve(signatures.size());
+
+        for (size_t index = 0; index < signatures.size(); index++) {
+            const auto [offset, trunc] = detail::truncate(signatures[index]);
+
+            // The anchor has to match exactly one byte value, the first such byte is used if there is no pair
+            const auto exact = std::ranges::find_if(trunc, &signature_element::has_value);
+            if (exact == trunc.end()) {
+                continue;
+            }
+
+            const auto anchor = detail::select_pair(trunc, hints).value_or(static_cast<size_t>(exact - trunc.begin()));
+            this->entries.push_back({
+                .index = index,
+                .offset = offset,
+                .anchor = anchor,
+                .data = this->storage.size(),
+                .size = trunc.size()
+            });
+            this->storage.insert(this->storage.end(), trunc.begin(), trunc.end());
+
+            // Register the anchor bytes with the candidate lookup tables
+            auto& ctx = this->context;
+            const auto a = trunc[anchor].value();
+            ctx.first.insert(a);
+            if (anchor + 1 < trunc.size() && trunc[anchor + 1].has_value()) {
+                const auto b = trunc[anchor + 1].value();
+                ctx.second.insert(b);
+                ctx.pairs.set(static_cast<size_t>(a) | static_cast<size_t>(b) << 8);
+            } else {
+                // The anchor is a single byte, so it may be followed by anything
+                for (size_t b = 0; b < 256; b++) {
+                    ctx.second.insert(static_cast<std::byte>(b));
+                    ctx.pairs.set(static_cast<size_t>(a) | b << 8);
+                }
+                // An anchor at the end of the signature may be the last byte of the input
+                if (anchor + 1 == trunc.size()) {
+                    ctx.singles.set(static_cast<size_t>(a));
+                }
+            }
+        }
+        this->matchable = this->entries.size();
+
+        // Group the entries by their first anchor byte
+        const auto anchorByte = [this](const detail::pattern_set_entry& entry) {
+            return static_cast<size_t>(this->storage[entry.data + entry.anchor].value());
+        };
+        std::ranges::stable_sort(this->entries, {}, anchorByte);
+
+        auto& ctx = this->context;
+        size_t e = 0;
+        for (size_t byte = 0; byte < 256; byte++) {
+            const auto first = e;
+            while (e != this->entries.size() && anchorByte(this->entries[e]) == byte) {
+                e++;
+            }
+            this->buckets[byte] = {first, e};
+
+            if (first != e) {
+                if (ctx.firstCount < ctx.firstBytes.size()) {
+                    ctx.firstBytes[ctx.firstCount] = static_cast<std::byte>(byte);
+                }
+                ctx.firstCount++;
+            }
+        }
+
+        // Scanners comparing against every first anchor byte at once expect all 16 bytes to be part of the set
+        for (size_t i = ctx.firstCount; i != 0 && i < ctx.firstBytes.size(); i++) {
+            ctx.firstBytes[i] = ctx.firstBytes[i % ctx.firstCount];
+        }
+
+        ctx.auto_resolve_scanner();
+    }
+}
+
+namespace hat::detail {
+
+    // The resolvers of the modes indexed by their value, see the dispatch table of the signature scanners
+    static constexpr auto pattern_set_resolvers = [] {
+        std::array<pattern_set_scan_function_t(*)(const pattern_set_context&), 6> resolvers{};
+        resolvers.fill(&resolve_pattern_set_scanner<scan_mode::Single>);
+#if defined(LIBHAT_X86)
+#if !defined(LIBHAT_DISABLE_AVX512)
+        resolvers[static_cast<size_t>(scan_mode::AVX512)] = &resolve_pattern_set_scanner<scan_mode::AVX512>;
+#endif
+        resolvers[static_cast<size_t>(scan_mode::AVX2)] = &resolve_pattern_set_scanner<scan_mode::AVX2>;
+#if !defined(LIBHAT_DISABLE_SSE)
+        resolvers[static_cast<size_t>(scan_mode::SSE)] = &resolve_pattern_set_scanner<scan_mode::SSE>;
+#endif
+#elif defined(LIBHAT_ARM64) && defined(LIBHAT_ARM_SCANNERS)
+#if !defined(LIBHAT_DISABLE_SVE2)
+        resolvers[static_cast<size_t>(scan_mode::SVE2)] = &resolve_pattern_set_scanner<scan_mode::SVE2>;
+#endif
+        resolvers[static_cast<size_t>(scan_mode::NEON)] = &resolve_pattern_set_scanner<scan_mode::NEON>;
+#endif
+        return resolvers;
+    }();
+
+    void pattern_set_context::auto_resolve_scanner() {
+        this->scanner = pattern_set_resolvers[static_cast<size_t>(best_scan_mode())](*this);
+    }
+}
@@ -0,0 +1,165 @@
+#include <libhat/RemoteProcess.hpp>
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace hat::detail {
+
+    // Size of the windows the remote range is read in. Large enough to amortize the cost of a read, and small enough to
+    // keep both buffers in the cache hierarchy while one is scanned and the other is filled.
+    static constexpr size_t remote_window_size = 1 << 20; // 1 MiB
+
+    // The data of each window is placed at the same offset from a 64 byte boundary as its remote address, so that the
+    // aligned scanners see the alignment of the remote memory
+    static constexpr size_t remote_window_alignment = 64;
+
+    struct remote_window {
+        std::vector<std::byte> storage{};
+        std::byte* data{};
+        size_t size{};
+        bool valid{};
+    };
+
+    // Fills the windows of a scan. The reads are done on a single thread, which is started with the first request and
+    // kept alive for the whole scan, so that the next window is read while the current one is scanned.
+    class remote_reader {
+    public:
+        remote_reader(const remote_process& process, const uintptr_t end, const size_t overlap)
+            : process(process), end(end), overlap(overlap) {}
+
+        remote_reader(const remote_reader&) = delete;
+        remote_reader& operator=(const remote_reader&) = delete;
+
+        ~remote_reader() {
+            {
+                std::scoped_lock lock{this->mutex};
+                this->stopping = true;
+            }
+            this->wake.notify_all();
+        }
+
+        void read(remote_window& window, const uintptr_t address) const {
+            const auto base = reinterpret_cast<uintptr_t>(window.storage.data());
+            const auto aligned = (base + remote_window_alignment - 1) & ~(remote_window_alignment - 1);
+            window.data = reinterpret_cast<std::byte*>(aligned + address % remote_window_alignment);
+            window.size = static_cast<size_t>(std::min<uintptr_t>(this->end - address, remote_window_size + this->overlap));
+            window.valid = this->process.read(address, {window.data, window.size});
+        }
+
+        // Starts reading the window on the reader thread
+        void request(remote_window& window, const uintptr_t address) {
+            if (!this->thread.joinable()) {
+                this->thread = std::jthread{[this] { this->run(); }};
+            }
+            {
+                std::scoped_lock lock{this->mutex};
+                this->pending = &window;
+                this->address = address;
+            }
+            this->wake.notify_all();
+        }
+
+        // Waits until the requested window has been read
+        void wait() {
+            std::unique_lock lock{this->mutex};
+            this->wake.wait(lock, [&] { return this->pending == nullptr; });
+        }
+    private:
+        void run() {
+            std::unique_lock lock{this->mutex};
+            while (true) {
+                this->wake.wait(lock, [&] { return this->pending != nullptr || this->stopping; });
+                if (this->stopping) {
+                    return;
+                }
+                lock.unlock();
+                this->read(*this->pending, this->address);
+                lock.lock();
+                this->pending = nullptr;
+                this->wake.notify_all();
+            }
+        }
+
+        const remote_process& process;
+        uintptr_t end;
+        size_t overlap;
+
+        std::mutex mutex{};
+        std::condition_variable wake{};
+        remote_window* pending{}; // Window being read by the reader thread, if any
+        uintptr_t address{};
+        bool stopping{};
+        std::jthread thread{};    // Declared last, so that it is joined before the rest of the state is destroyed
+    };
+
+    template<typename Fn>
+    static void for_each_window(const remote_process& process, const uintptr_t begin, const uintptr_t end, const size_t signatureSize, Fn&& fn) {
+        // Windows overlap by the signature size, so that matches on a window boundary are found in the first of the two
+        // windows. Only matches beginning within the first remote_window_size bytes are accepted by each window.
+        const auto overlap = signatureSize - 1;
+
+        // Room for aligning the storage, and for the offset of the remote address from the alignment
+        std::array<remote_window, 2> windows{};
+        for (auto& window : windows) {
+            window.storage.resize(remote_window_size + overlap + 2 * remote_window_alignment);
+        }
+
+        remote_reader reader{process, end, overlap};
+
+        size_t current = 0;
+        reader.read(windows[current], begin);
+
+        for (auto address = begin; address < end; address += remote_window_size) {
+            // Read the next window on the reader thread while the current one is scanned
+            const auto next = address + remote_window_size;
+            const bool more = end - address > remote_window_size && end - next >= signatureSize;
+            if (more) {
+                reader.request(windows[current ^ 1], next);
+            }
+
+            const auto& window = windows[current];
+            if (window.valid && window.size >= signatureSize && !fn(address, window)) {
+                break;
+            }
+
+            if (!more) {
+                break;
+            }
+            reader.wait();
+            current ^= 1;
+        }
+    }
+
+    std::optional<uintptr_t> find_pattern_remote(const remote_process& process, const uintptr_t begin, const uintptr_t end, const scan_context& context) {
+        std::optional<uintptr_t> result{};
+        for_each_window(process, begin, end, context.signature.size(), [&](const uintptr_t address, const remote_window& window) {
+            // No earlier window contained a match, so the first match in the overlap is also the first match overall
+            if (const auto match = context.scan(window.data, window.data + window.size); match.has_result()) {
+                result = address + static_cast<uintptr_t>(match.get() - window.data);
+                return false;
+            }
+            return true;
+        });
+        return result;
+    }
+
+    std::vector<uintptr_t> find_all_pattern_remote(const remote_process& process, const uintptr_t begin, const uintptr_t end, const scan_context& context) {
+        std::vector<uintptr_t> results{};
+        for_each_window(process, begin, end, context.signature.size(), [&](const uintptr_t address, const remote_window& window) {
+            const auto windowEnd = window.data + std::min(window.size, remote_window_size);
+            for_each_match(context, window.data, window.data + window.size, [&](const std::byte* match) {
+                if (match >= windowEnd) {
+                    return false;
+                }
+                results.push_back(address + static_cast<uintptr_t>(match - window.data));
+                return true;
+            });
+            return true;
+        });
+        return results;
+    }
+}
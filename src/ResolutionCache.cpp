@@ -0,0 +1,141 @@
+#include <libhat/ResolutionCache.hpp>
+
+#include "Hasher.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <tuple>
+#include <type_traits>
+
+namespace hat {
+
+    // The cache file is a header followed by an array of fixed size records sorted by key, so that it may be mapped
+    // and searched in place. Values are stored in the native byte order, a file written on a machine of another byte
+    // order is rejected by the magic.
+    struct cache_file_header {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t count;
+    };
+
+    static constexpr uint32_t cache_magic = 0x43544148; // "HATC"
+    static constexpr uint32_t cache_version = 1;
+
+    // Reads the TimeDateStamp and CheckSum of a mapped PE module, both of which are 0 for other formats
+    static std::pair<uint32_t, uint32_t> pe_stamp(const process::module_t mod) {
+        const auto* base = reinterpret_cast<const std::byte*>(mod);
+        auto read = [&]<typename T>(std::type_identity<T>, const size_t offset) {
+            T value;
+            std::memcpy(&value, base + offset, sizeof(T));
+            return value;
+        };
+
+        if (read(std::type_identity<uint16_t>{}, 0) != 0x5A4D) { // "MZ"
+            return {};
+        }
+        const auto ntOffset = read(std::type_identity<uint32_t>{}, 0x3C);
+        if (read(std::type_identity<uint32_t>{}, ntOffset) != 0x00004550) { // "PE\0\0"
+            return {};
+        }
+        // The CheckSum is at the same offset into the optional header of both PE32 and PE32+ images
+        const auto timeDateStamp = read(std::type_identity<uint32_t>{}, ntOffset + 8);
+        const auto checkSum = read(std::type_identity<uint32_t>{}, ntOffset + 24 + 64);
+        return {timeDateStamp, checkSum};
+    }
+
+    resolution_cache resolution_cache::load(const std::filesystem::path& path) {
+        resolution_cache cache{};
+        std::ifstream file{path, std::ios::binary};
+        if (!file) {
+            return cache;
+        }
+
+        cache_file_header header{};
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))
+            || header.magic != cache_magic || header.version != cache_version) {
+            return cache;
+        }
+
+        // Don't trust the count of a truncated file
+        const auto start = file.tellg();
+        file.seekg(0, std::ios::end);
+        const auto available = static_cast<uint64_t>(file.tellg() - start);
+        if (header.count > available / sizeof(entry)) {
+            return cache;
+        }
+        file.seekg(start);
+
+        cache.entries.resize(static_cast<size_t>(header.count));
+        if (!file.read(reinterpret_cast<char*>(cache.entries.data()), static_cast<std::streamsize>(header.count * sizeof(entry)))) {
+            cache.entries.clear();
+            return cache;
+        }
+
+        const auto byKey = [](const entry& e) { return std::tie(e.signature, e.image); };
+        if (!std::ranges::is_sorted(cache.entries, {}, byKey)) {
+            std::ranges::sort(cache.entries, {}, byKey);
+        }
+        return cache;
+    }
+
+    bool resolution_cache::save(const std::filesystem::path& path) const {
+        std::ofstream file{path, std::ios::binary | std::ios::trunc};
+        if (!file) {
+            return false;
+        }
+        const cache_file_header header{cache_magic, cache_version, this->entries.size()};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(this->entries.data()), static_cast<std::streamsize>(this->entries.size() * sizeof(entry)));
+        return static_cast<bool>(file.flush());
+    }
+
+    uint64_t resolution_cache::signature_key(const signature_view signature, const std::string_view section, const scan_alignment alignment) {
+        detail::hasher h{};
+        for (const auto& element : signature) {
+            h.update(element.value());
+            h.update(element.mask());
+        }
+        h.update(std::as_bytes(std::span{section}));
+        h.update(static_cast<uint64_t>(alignment));
+        return h.digest();
+    }
+
+    uint64_t resolution_cache::image_key(const process::module_t mod, const std::string_view section, const std::span<const std::byte> data) {
+        for (const auto& identity : this->images) {
+            if (identity.mod == mod && identity.section == section) {
+                return identity.key;
+            }
+        }
+
+        const auto [timeDateStamp, checkSum] = pe_stamp(mod);
+        detail::hasher h{};
+        h.update(timeDateStamp);
+        h.update(checkSum);
+        h.update(data);
+
+        const auto key = h.digest();
+        this->images.push_back({mod, std::string{section}, key});
+        return key;
+    }
+
+    std::optional<uint64_t> resolution_cache::lookup(const uint64_t signature, const uint64_t image) const {
+        const auto it = std::ranges::lower_bound(this->entries, std::tie(signature, image), {}, [](const entry& e) {
+            return std::tie(e.signature, e.image);
+        });
+        if (it != this->entries.end() && it->signature == signature && it->image == image) {
+            return it->rva;
+        }
+        return std::nullopt;
+    }
+
+    void resolution_cache::insert(const uint64_t signature, const uint64_t image, const uint64_t rva) {
+        const auto it = std::ranges::lower_bound(this->entries, std::tie(signature, image), {}, [](const entry& e) {
+            return std::tie(e.signature, e.image);
+        });
+        if (it != this->entries.end() && it->signature == signature && it->image == image) {
+            it->rva = rva;
+        } else {
+            this->entries.insert(it, {signature, image, rva});
+        }
+    }
+}
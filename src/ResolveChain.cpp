@@ -0,0 +1,95 @@
+#include <libhat/ResolveChain.hpp>
+
+#include <libhat/PatternSet.hpp>
+
+#include <cstring>
+
+namespace hat {
+
+    // Addresses are tracked as integers, so that a step which leaves the bounds doesn't form an invalid pointer
+    template<typename T>
+    static bool read_bounded(const uintptr_t address, const uintptr_t begin, const uintptr_t end, T& value) {
+        if (address < begin || address > end || end - address < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, reinterpret_cast<const void*>(address), sizeof(T));
+        return true;
+    }
+
+    scan_result resolve_chain::resolve(const scan_result match, const std::span<std::byte> bounds) const {
+        if (!match.has_result() || !this->valid()) {
+            return nullptr;
+        }
+
+        const auto begin = reinterpret_cast<uintptr_t>(bounds.data());
+        const auto end = begin + bounds.size();
+        auto address = reinterpret_cast<uintptr_t>(match.get());
+
+        for (const auto& step : this->steps()) {
+            switch (step.op) {
+                case resolve_op::rel: {
+                    const auto offset = static_cast<uintptr_t>(step.operand);
+                    int32_t displacement;
+                    if (!read_bounded(address + offset, begin, end, displacement)) {
+                        return nullptr;
+                    }
+                    address += offset + sizeof(int32_t) + static_cast<uintptr_t>(static_cast<intptr_t>(displacement));
+                    break;
+                }
+                case resolve_op::deref: {
+                    uintptr_t pointer;
+                    if (!read_bounded(address + static_cast<uintptr_t>(step.operand), begin, end, pointer)) {
+                        return nullptr;
+                    }
+                    address = pointer;
+                    break;
+                }
+                case resolve_op::add:
+                    address += static_cast<uintptr_t>(step.operand);
+                    break;
+            }
+        }
+
+        if (address < begin || address >= end) {
+            return nullptr;
+        }
+        return reinterpret_cast<std::byte*>(address);
+    }
+
+    std::vector<scan_result> resolve_all(
+        const std::span<const scan_result>   matches,
+        const std::span<const resolve_chain> chains,
+        const std::span<std::byte>           bounds
+    ) {
+        std::vector<scan_result> results(matches.size());
+        for (size_t i = 0; i < matches.size(); i++) {
+            results[i] = i < chains.size() ? chains[i].resolve(matches[i], bounds) : matches[i];
+        }
+        return results;
+    }
+
+    std::vector<scan_result> find_and_resolve(
+        const std::span<const signature_view> signatures,
+        const std::span<const resolve_chain>  chains,
+        const std::span<std::byte>            range,
+        const std::span<std::byte>            bounds,
+        const scan_alignment                  alignment
+    ) {
+        const auto matches = pattern_set{signatures, alignment}.find_first(range.begin(), range.end());
+        return resolve_all(matches, chains, bounds);
+    }
+
+    std::vector<scan_result> find_and_resolve(
+        const std::span<const signature_view> signatures,
+        const std::span<const resolve_chain>  chains,
+        const std::string_view                section,
+        const process::module_t               mod,
+        const scan_alignment                  alignment
+    ) {
+        const auto data = process::get_section_data(mod, section);
+        if (data.empty()) {
+            return std::vector<scan_result>(signatures.size());
+        }
+        return find_and_resolve(signatures, chains, data, process::get_module_data(mod), alignment);
+    }
+}
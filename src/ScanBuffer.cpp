@@ -0,0 +1,49 @@
+#include <libhat/ScanBuffer.hpp>
+
+#include <atomic>
+#include <utility>
+
+namespace hat {
+
+    scan_buffer::scan_buffer(scan_buffer&& other) noexcept
+        : memory(std::exchange(other.memory, nullptr)),
+          length(std::exchange(other.length, 0)),
+          mapping(std::exchange(other.mapping, nullptr)),
+          mappingSize(std::exchange(other.mappingSize, 0)),
+          largePages(std::exchange(other.largePages, false)),
+          numaNode(std::exchange(other.numaNode, std::nullopt)) {}
+
+    scan_buffer& scan_buffer::operator=(scan_buffer&& other) noexcept {
+        if (this != &other) {
+            this->release();
+            this->memory = std::exchange(other.memory, nullptr);
+            this->length = std::exchange(other.length, 0);
+            this->mapping = std::exchange(other.mapping, nullptr);
+            this->mappingSize = std::exchange(other.mappingSize, 0);
+            this->largePages = std::exchange(other.largePages, false);
+            this->numaNode = std::exchange(other.numaNode, std::nullopt);
+        }
+        return *this;
+    }
+
+    scan_buffer::~scan_buffer() {
+        this->release();
+    }
+}
+
+namespace hat::detail {
+
+    // The pinned count is stored as is, so that 0 means no pin
+    static std::atomic<size_t> pinnedNodeCount{};
+
+    void pin_numa_node_count(const std::optional<size_t> count) {
+        pinnedNodeCount.store(count.value_or(0), std::memory_order_relaxed);
+    }
+
+    std::optional<size_t> pinned_numa_node_count() {
+        if (const auto count = pinnedNodeCount.load(std::memory_order_relaxed); count != 0) {
+            return count;
+        }
+        return std::nullopt;
+    }
+}
@@ -0,0 +1,283 @@
+#include <libhat/ScanScheduler.hpp>
+
+#include <libhat/PatternSet.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <iterator>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace hat::detail {
+
+    // Size of the chunks every pass is divided into, the same trade-off as for the parallel scanners: small enough to
+    // balance the load between workers and to skip the rest of a section once every signature was found, and large
+    // enough to keep the per-chunk overhead negligible.
+    static constexpr size_t scheduler_chunk_size = 1 << 20; // 1 MiB
+
+    static constexpr size_t no_chunk = std::numeric_limits<size_t>::max();
+
+    struct scan_job {
+        signature pattern;
+        std::function<void(scan_result)> callback;
+    };
+
+    // The jobs targeting one range, which are scanned in a single pass once a worker takes the batch. Jobs may only
+    // be added to the batch until then.
+    struct scan_batch {
+        std::span<std::byte> range{};
+        scan_alignment alignment{};
+        std::vector<scan_job> jobs{};
+
+        std::optional<pattern_set> set{};
+        size_t overlap{}; // Size of the longest signature minus one
+        size_t chunks{};
+        std::atomic<size_t> remaining{};
+
+        std::mutex mutex{};
+        std::vector<std::pair<size_t, scan_result>> first{}; // Chunk and address of the first match of every job
+    };
+
+    // A batch to start if chunk is no_chunk, otherwise a chunk of a started batch
+    struct scan_task {
+        std::shared_ptr<scan_batch> batch;
+        size_t chunk;
+    };
+
+    struct scan_worker_queue {
+        std::mutex mutex{};
+        std::deque<scan_task> tasks{};
+    };
+
+    struct scan_scheduler_state {
+        std::mutex mutex{};
+        std::condition_variable wake{};
+        std::deque<scan_task> incoming{};                  // Batches submitted from outside of the pool
+        std::vector<std::shared_ptr<scan_batch>> pending{}; // Batches which haven't been taken by a worker yet
+        std::atomic<size_t> queued{};                      // Tasks in incoming and in every worker queue
+        bool stopping{};
+
+        std::vector<scan_worker_queue> queues;
+        std::vector<std::jthread> workers{};
+
+        explicit scan_scheduler_state(const size_t threads) : queues(threads) {}
+
+        void add(const std::span<std::byte> range, const scan_alignment alignment, std::vector<scan_job> jobs) {
+            {
+                std::scoped_lock lock{this->mutex};
+                const auto it = std::ranges::find_if(this->pending, [&](const auto& batch) {
+                    return batch->range.data() == range.data()
+                        && batch->range.size() == range.size()
+                        && batch->alignment == alignment;
+                });
+                if (it != this->pending.end()) {
+                    std::ranges::move(jobs, std::back_inserter((*it)->jobs));
+                    return;
+                }
+
+                auto batch = std::make_shared<scan_batch>();
+                batch->range = range;
+                batch->alignment = alignment;
+                batch->jobs = std::move(jobs);
+                this->pending.push_back(batch);
+                this->incoming.push_back({std::move(batch), no_chunk});
+                this->queued++;
+            }
+            this->wake.notify_one();
+        }
+
+        std::optional<scan_task> take(const size_t self) {
+            {
+                auto& own = this->queues[self];
+                std::scoped_lock lock{own.mutex};
+                if (!own.tasks.empty()) {
+                    auto task = std::move(own.tasks.back());
+                    own.tasks.pop_back();
+                    this->queued--;
+                    return task;
+                }
+            }
+            for (size_t i = 1; i < this->queues.size(); i++) {
+                auto& other = this->queues[(self + i) % this->queues.size()];
+                std::scoped_lock lock{other.mutex};
+                if (!other.tasks.empty()) {
+                    auto task = std::move(other.tasks.front());
+                    other.tasks.pop_front();
+                    this->queued--;
+                    return task;
+                }
+            }
+
+            std::scoped_lock lock{this->mutex};
+            if (!this->incoming.empty()) {
+                auto task = std::move(this->incoming.front());
+                this->incoming.pop_front();
+                std::erase(this->pending, task.batch);
+                this->queued--;
+                return task;
+            }
+            return std::nullopt;
+        }
+
+        void start(const size_t self, const std::shared_ptr<scan_batch>& batch) {
+            std::vector<signature_view> signatures{};
+            signatures.reserve(batch->jobs.size());
+            for (const auto& job : batch->jobs) {
+                signatures.emplace_back(job.pattern);
+                batch->overlap = std::max(batch->overlap, std::max<size_t>(job.pattern.size(), 1) - 1);
+            }
+            batch->set.emplace(signatures, batch->alignment);
+            batch->first.assign(batch->jobs.size(), {no_chunk, nullptr});
+            batch->chunks = std::max<size_t>((batch->range.size() + scheduler_chunk_size - 1) / scheduler_chunk_size, 1);
+            batch->remaining = batch->chunks;
+
+            // Queue the later chunks for the other workers to steal, and scan the first one right away
+            if (batch->chunks > 1) {
+                {
+                    auto& own = this->queues[self];
+                    std::scoped_lock lock{own.mutex};
+                    for (size_t chunk = batch->chunks - 1; chunk > 0; chunk--) {
+                        own.tasks.push_back({batch, chunk});
+                    }
+                    this->queued += batch->chunks - 1;
+                }
+                // Synchronize with workers which are about to wait, so that none of them misses the notification
+                { std::scoped_lock lock{this->mutex}; }
+                this->wake.notify_all();
+            }
+            scan(batch, 0);
+        }
+
+        static void scan(const std::shared_ptr<scan_batch>& batch, const size_t chunk) {
+            // Skip the chunk if every job already has a match in an earlier one
+            const bool needed = [&] {
+                std::scoped_lock lock{batch->mutex};
+                return std::ranges::any_of(batch->first, [&](const auto& first) { return first.first > chunk; });
+            }();
+
+            if (needed) {
+                // Chunks overlap by the longest signature, so that a match beginning within the chunk is always found
+                const auto size = batch->range.size();
+                const auto begin = batch->range.data() + std::min(size, chunk * scheduler_chunk_size);
+                const auto end = batch->range.data() + std::min(size, (chunk + 1) * scheduler_chunk_size + batch->overlap);
+                const auto results = batch->set->find_first(begin, end);
+
+                std::scoped_lock lock{batch->mutex};
+                for (size_t i = 0; i < results.size(); i++) {
+                    if (results[i].has_result() && chunk < batch->first[i].first) {
+                        batch->first[i] = {chunk, results[i]};
+                    }
+                }
+            }
+
+            if (--batch->remaining == 0) {
+                for (size_t i = 0; i < batch->jobs.size(); i++) {
+                    batch->jobs[i].callback(batch->first[i].second);
+                }
+            }
+        }
+
+        void run(const size_t self) {
+            while (true) {
+                if (auto task = this->take(self)) {
+                    if (task->chunk == no_chunk) {
+                        this->start(self, task->batch);
+                    } else {
+                        scan(task->batch, task->chunk);
+                    }
+                    continue;
+                }
+
+                std::unique_lock lock{this->mutex};
+                this->wake.wait(lock, [&] { return this->queued != 0 || this->stopping; });
+                if (this->queued == 0 && this->stopping) {
+                    return;
+                }
+            }
+        }
+    };
+}
+
+namespace hat {
+
+    scan_scheduler::scan_scheduler(size_t threads) {
+        if (threads == 0) {
+            threads = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+
+        this->state = std::make_unique<detail::scan_scheduler_state>(threads);
+        this->state->workers.reserve(threads);
+        for (size_t i = 0; i < threads; i++) {
+            this->state->workers.emplace_back([state = this->state.get(), i] {
+                state->run(i);
+            });
+        }
+    }
+
+    scan_scheduler::~scan_scheduler() {
+        {
+            std::scoped_lock lock{this->state->mutex};
+            this->state->stopping = true;
+        }
+        this->state->wake.notify_all();
+        this->state->workers.clear();
+    }
+
+    size_t scan_scheduler::size() const noexcept {
+        return this->state->queues.size();
+    }
+
+    void scan_scheduler::submit(
+        const signature_view             signature,
+        const std::span<std::byte>       range,
+        const scan_alignment             alignment,
+        std::function<void(scan_result)> callback
+    ) {
+        std::vector<detail::scan_job> jobs{};
+        jobs.push_back({{signature.begin(), signature.end()}, std::move(callback)});
+        this->state->add(range, alignment, std::move(jobs));
+    }
+
+    std::future<scan_result> scan_scheduler::submit(const signature_view signature, const std::span<std::byte> range, const scan_alignment alignment) {
+        auto promise = std::make_shared<std::promise<scan_result>>();
+        auto future = promise->get_future();
+        this->submit(signature, range, alignment, [promise = std::move(promise)](const scan_result result) {
+            promise->set_value(result);
+        });
+        return future;
+    }
+
+    std::future<scan_result> scan_scheduler::submit(
+        const signature_view    signature,
+        const std::string_view  section,
+        const process::module_t mod,
+        const scan_alignment    alignment
+    ) {
+        return this->submit(signature, process::get_section_data(mod, section), alignment);
+    }
+
+    std::vector<std::future<scan_result>> scan_scheduler::submit(
+        const std::span<const signature_view> signatures,
+        const std::span<std::byte>            range,
+        const scan_alignment                  alignment
+    ) {
+        std::vector<detail::scan_job> jobs{};
+        std::vector<std::future<scan_result>> futures{};
+        jobs.reserve(signatures.size());
+        futures.reserve(signatures.size());
+        for (const auto signature : signatures) {
+            auto promise = std::make_shared<std::promise<scan_result>>();
+            futures.push_back(promise->get_future());
+            jobs.push_back({{signature.begin(), signature.end()}, [promise = std::move(promise)](const scan_result result) {
+                promise->set_value(result);
+            }});
+        }
+        this->state->add(range, alignment, std::move(jobs));
+        return futures;
+    }
+}
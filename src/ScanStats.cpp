@@ -0,0 +1,71 @@
+#include <libhat/ScanStats.hpp>
+
+#include <algorithm>
+#include <atomic>
+
+namespace hat {
+
+    static std::atomic<scan_trace_hook> traceHook{};
+    static std::atomic<void*> traceUser{};
+    static thread_local scan_stats_collector* currentCollector{};
+
+    void set_scan_trace_hook(const scan_trace_hook hook, void* user) {
+        // The user pointer is published before the hook which reads it
+        traceUser.store(user, std::memory_order_relaxed);
+        traceHook.store(hook, std::memory_order_release);
+    }
+
+    scan_stats_collector::scan_stats_collector() : previous(currentCollector) {
+        currentCollector = this;
+    }
+
+    scan_stats_collector::~scan_stats_collector() {
+        currentCollector = this->previous;
+    }
+}
+
+namespace hat::detail {
+
+    const_scan_result traced_scan(const scan_context& context, const std::byte* begin, const std::byte* end, match_sink* sink) {
+        const auto hook = traceHook.load(std::memory_order_acquire);
+        if (!hook && !currentCollector) {
+            return context.scanner(begin, end, context, sink);
+        }
+
+#if defined(LIBHAT_SCAN_STATS)
+        const auto candidatesBefore = candidateCount;
+#endif
+        const auto matchesBefore = sink ? sink->count : 0;
+        const auto start = std::chrono::steady_clock::now();
+        const auto result = context.scanner(begin, end, context, sink);
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+
+        // Only the vectorized X1 scanners are anchored on the pair, the others compare the first byte
+        const auto anchor = context.resolvedMode != scan_mode::Single && context.alignment == scan_alignment::X1
+            ? context.pairIndex
+            : std::nullopt;
+
+        scan_stats stats{
+            .mode = context.resolvedMode,
+            .alignment = context.alignment,
+            .signatureSize = context.signature.size(),
+            .anchorOffset = anchor,
+            .anchorDistance = anchor ? context.pairDistance : 0,
+            .bytesScanned = static_cast<size_t>((result.has_result() ? std::min(result.get() + context.signature.size(), end) : end) - begin),
+            .matches = sink ? sink->count - matchesBefore : static_cast<size_t>(result.has_result()),
+            .elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+        };
+#if defined(LIBHAT_SCAN_STATS)
+        stats.candidates = candidateCount - candidatesBefore;
+        stats.verifyFailures = stats.candidates - std::min(stats.candidates, stats.matches);
+#endif
+
+        if (hook) {
+            hook(stats, traceUser.load(std::memory_order_relaxed));
+        }
+        if (currentCollector) {
+            currentCollector->records.push_back(stats);
+        }
+        return result;
+    }
+}
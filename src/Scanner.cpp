@@ -1,84 +1,379 @@
 #include <libhat/Scanner.hpp>
 
 #include <libhat/Defines.hpp>
+#include <libhat/FixedPattern.hpp>
+#include <libhat/FrequencyModel.hpp>
 #include <libhat/System.hpp>
 
-#include "arch/x86/Frequency.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <random>
+#include <memory>
+#include <utility>
+#include <vector>
 
 namespace hat::detail {
 
-    void scan_context::apply_hints(const scanner_context& scanner) {
-        const bool x86_64 = static_cast<bool>(this->hints & scan_hint::x86_64);
-        const bool pair0 = static_cast<bool>(this->hints & scan_hint::pair0);
+    // Returns the index of the byte pair with the least occurrences according to the model, considering only pairs
+    // which begin before the limit
+    static std::optional<size_t> find_rare_pair(const signature_view signature, const frequency_model& model, const size_t limit) {
+        std::optional<std::pair<size_t, uint32_t>> bestPair{};
+        for (auto it = signature.begin(); it != std::prev(signature.end()); it++) {
+            const auto i = static_cast<size_t>(it - signature.begin());
+            if (i >= limit) {
+                break;
+            }
+            auto& a = *it;
+            auto& b = *std::next(it);
 
-        if (x86_64 && !pair0 && scanner.vectorSize && this->alignment == hat::scan_alignment::X1) {
-            static constexpr auto getScore = [](const std::byte a, const std::byte b) {
-                constexpr auto& pairs = hat::detail::x86_64::pairs_x1;
-                const auto it = std::ranges::find(pairs, std::pair{a, b});
-                return static_cast<size_t>(it - pairs.begin());
-            };
-
-            std::optional<std::pair<size_t, size_t>> bestPair{};
-            for (auto it = this->signature.begin(); it != std::prev(this->signature.end()); it++) {
-                const auto i = static_cast<size_t>(it - this->signature.begin());
-                auto& a = *it;
-                auto& b = *std::next(it);
-
-                if (a.has_value() && b.has_value()) {
-                    const auto score = getScore(a.value(), b.value());
-                    if (!bestPair || score > bestPair->second) {
-                        bestPair.emplace(i, score);
-                    }
+            if (a.has_value() && b.has_value()) {
+                const auto count = model.count(a.value(), b.value());
+                if (!bestPair || count < bestPair->second) {
+                    bestPair.emplace(i, count);
                 }
             }
+        }
 
-            if (bestPair) {
-                this->pairIndex = bestPair->first;
+        if (bestPair) {
+            return bestPair->first;
+        }
+        return {};
+    }
+
+    static std::optional<size_t> find_first_pair(const signature_view signature, const bool pair0, const size_t limit) {
+        for (auto it = signature.begin(); it != std::prev(signature.end()); it++) {
+            const auto i = static_cast<size_t>(it - signature.begin());
+            if (i >= limit) {
+                break;
+            }
+            auto& a = *it;
+            auto& b = *std::next(it);
+
+            if (a.has_value() && b.has_value()) {
+                return i;
+            }
+            if (i == 0 && pair0) {
+                break;
             }
         }
+        return {};
+    }
 
-        // If no "optimal" pair was found, find the first byte pair in the signature
-        if (!this->pairIndex.has_value()) {
-            for (auto it = this->signature.begin(); it != std::prev(this->signature.end()); it++) {
-                const auto i = static_cast<size_t>(it - this->signature.begin());
-                auto& a = *it;
-                auto& b = *std::next(it);
-
-                if (a.has_value() && b.has_value()) {
-                    this->pairIndex = i;
-                    break;
+    // Returns the indices of the two non-adjacent signature bytes which are the least likely to both match at a given
+    // position, assuming the bytes occur independently of each other, considering only first bytes before the limit
+    static std::optional<std::pair<size_t, size_t>> find_rare_distant_pair(const signature_view signature, const frequency_model& model, const size_t limit) {
+        std::optional<std::pair<size_t, size_t>> bestPair{};
+        double bestCount{};
+        for (size_t i = 0; i < signature.size() && i < limit; i++) {
+            if (!signature[i].has_value()) {
+                continue;
+            }
+            for (size_t j = i + 2; j < signature.size(); j++) {
+                if (!signature[j].has_value()) {
+                    continue;
+                }
+                const auto count = static_cast<double>(model.count(*signature[i])) * static_cast<double>(model.count(*signature[j]));
+                if (!bestPair || count < bestCount) {
+                    bestPair.emplace(i, j);
+                    bestCount = count;
                 }
-                if (i == 0 && pair0) {
-                    break;
+            }
+        }
+        return bestPair;
+    }
+
+    // Returns the indices of the first solid byte before the limit and the solid byte following it
+    static std::optional<std::pair<size_t, size_t>> find_first_distant_pair(const signature_view signature, const size_t limit) {
+        std::optional<size_t> first{};
+        for (size_t i = 0; i < signature.size(); i++) {
+            if (!signature[i].has_value()) {
+                continue;
+            }
+            if (first) {
+                return std::make_pair(*first, i);
+            }
+            if (i >= limit) {
+                break;
+            }
+            first = i;
+        }
+        return {};
+    }
+
+    // The model explicitly provided for the scan takes precedence over the one implied by the hints
+    static const frequency_model* select_model(const frequency_model* model, const scan_hint hints) {
+        if (!model && static_cast<bool>(hints & scan_hint::x86_64)) {
+            return &frequency_model::x86_64();
+        }
+        return model;
+    }
+
+    std::optional<size_t> select_pair(const signature_view signature, const scan_hint hints, const frequency_model* model) {
+        const bool pair0 = static_cast<bool>(hints & scan_hint::pair0);
+        constexpr auto limit = std::numeric_limits<size_t>::max();
+
+        if (const auto selected = select_model(model, hints); selected && !pair0) {
+            if (const auto pair = find_rare_pair(signature, *selected, limit); pair.has_value()) {
+                return pair;
+            }
+        }
+        return find_first_pair(signature, pair0, limit);
+    }
+
+    void scan_context::apply_hints(const scanner_context& scanner) {
+        const bool pair0 = static_cast<bool>(this->hints & scan_hint::pair0);
+        const auto model = select_model(this->model, this->hints);
+
+        // Most vectorized scanners compare the pair within the first vector of a candidate. The others anchor on the
+        // rarest pair of any solid segment, which may lie past a long run of wildcards.
+        const auto limit = scanner.vectorSize && !scanner.farPairs ? scanner.vectorSize : std::numeric_limits<size_t>::max();
+
+        // Only the X1 vectorized scanners are able to compare a pair of bytes that aren't adjacent
+        const bool distant = !pair0 && scanner.vectorSize && this->alignment == hat::scan_alignment::X1;
+        this->pairDistance = 1;
+
+        if (model && distant) {
+            this->pairIndex = find_rare_pair(this->signature, *model, limit);
+
+            // Two bytes that are each rare may match less often at a fixed distance than any adjacent pair does, e.g.
+            // the opcodes surrounding the displacement in "E8 ? ? ? ? 48 8B". Telling that requires the counts of the
+            // individual bytes, which a ranking of the most common pairs doesn't provide.
+            const auto pair = model->is_measured() ? find_rare_distant_pair(this->signature, *model, limit) : std::nullopt;
+            if (pair && model->total()) {
+                const auto total = static_cast<double>(model->total());
+                const auto distantCount = static_cast<double>(model->count(*this->signature[pair->first]))
+                    * static_cast<double>(model->count(*this->signature[pair->second])) / total;
+                const auto adjacentCount = this->pairIndex.has_value()
+                    ? static_cast<double>(model->count(*this->signature[*this->pairIndex], *this->signature[*this->pairIndex + 1]))
+                    : std::numeric_limits<double>::infinity();
+                if (distantCount < adjacentCount) {
+                    this->pairIndex = pair->first;
+                    this->pairDistance = pair->second - pair->first;
                 }
             }
         }
+
+        // If no "optimal" pair was found, find the first byte pair in the signature
+        if (!this->pairIndex.has_value()) {
+            this->pairIndex = find_first_pair(this->signature, pair0, limit);
+        }
+
+        // Without any adjacent pair, the first two solid bytes are still a better filter than a single byte
+        if (!this->pairIndex.has_value() && distant) {
+            if (const auto pair = find_first_distant_pair(this->signature, limit); pair.has_value()) {
+                this->pairIndex = pair->first;
+                this->pairDistance = pair->second - pair->first;
+            }
+        }
+    }
+
+    // Modes in the order of preference, from the widest vectors to the scalar fallback
+    static constexpr scan_mode mode_priority[]{
+        scan_mode::AVX512,
+        scan_mode::AVX2,
+        scan_mode::SSE,
+        scan_mode::SVE2,
+        scan_mode::NEON,
+        scan_mode::Single
+    };
+
+    // The pinned mode is stored as its value plus one, so that 0 means no pin
+    static std::atomic<uint32_t> pinnedMode{};
+    static std::atomic<uint32_t> disabledModes{};
+
+    // Far enough ahead to cover the memory latency at the throughput of the vectorized scanners
+    static std::atomic<size_t> streamingPrefetchDistance{4096};
+
+    static constexpr uint32_t mode_bit(const scan_mode mode) {
+        return 1u << static_cast<uint32_t>(mode);
     }
 
-    void scan_context::auto_resolve_scanner() {
+    using resolver_t = scan_function_t(*)(scan_context&);
+
+    // The resolvers of the modes indexed by their value, and the modes supported by the current system. The table is
+    // settled on first use, so that neither the CPU features nor the compiled in modes are checked for each context.
+    struct dispatch_table {
+        std::array<resolver_t, std::size(mode_priority)> resolvers{};
+        uint32_t supported{};
+    };
+
+    static dispatch_table make_dispatch_table() {
+        dispatch_table table{};
+        table.resolvers.fill(&resolve_scanner<scan_mode::Single>);
+        table.supported = mode_bit(scan_mode::Single);
+
+        [[maybe_unused]] const auto add = [&](const scan_mode mode, const resolver_t resolver, const bool supported) {
+            table.resolvers[static_cast<size_t>(mode)] = resolver;
+            table.supported |= supported ? mode_bit(mode) : 0;
+        };
+        [[maybe_unused]] const auto& ext = get_system().extensions;
 #if defined(LIBHAT_X86)
-        const auto& ext = get_system().extensions;
-        if (ext.bmi) {
+        // The AVX2 and AVX512 scanners use BMI for iterating over the bits of the comparison masks
 #if !defined(LIBHAT_DISABLE_AVX512)
-            if (ext.avx512f && ext.avx512bw) {
-                this->scanner = resolve_scanner<scan_mode::AVX512>(*this);
-                return;
-            }
+        add(scan_mode::AVX512, &resolve_scanner<scan_mode::AVX512>, ext.bmi && ext.avx512f && ext.avx512bw);
+#endif
+        add(scan_mode::AVX2, &resolve_scanner<scan_mode::AVX2>, ext.bmi && ext.avx2);
+#if !defined(LIBHAT_DISABLE_SSE)
+        add(scan_mode::SSE, &resolve_scanner<scan_mode::SSE>, ext.sse41);
 #endif
-            if (ext.avx2) {
-                this->scanner = resolve_scanner<scan_mode::AVX2>(*this);
-                return;
+#elif defined(LIBHAT_ARM64) && defined(LIBHAT_ARM_SCANNERS)
+        // The ARM scanners are only built on request until they have been verified on hardware, without them ARM64
+        // uses the scalar scanner
+#if !defined(LIBHAT_DISABLE_SVE2)
+        add(scan_mode::SVE2, &resolve_scanner<scan_mode::SVE2>, ext.sve2);
+#endif
+        add(scan_mode::NEON, &resolve_scanner<scan_mode::NEON>, ext.neon);
+#endif
+        return table;
+    }
+
+    static const dispatch_table& dispatch() {
+        static const dispatch_table table = make_dispatch_table();
+        return table;
+    }
+
+    static bool is_enabled(const scan_mode mode) {
+        return !(disabledModes.load(std::memory_order_relaxed) & mode_bit(mode));
+    }
+
+    // The result of compute_scan_mode() plus one in the low byte, or 0 there if the selection was changed since it was
+    // computed. The upper bits count the changes, so that a result computed before a change is never stored after it.
+    static std::atomic<uint32_t> cachedMode{};
+
+    static void invalidate_scan_mode() {
+        auto state = cachedMode.load(std::memory_order_relaxed);
+        while (!cachedMode.compare_exchange_weak(state, (state & ~0xFFu) + 0x100u, std::memory_order_acq_rel)) {}
+    }
+
+    static scan_mode compute_scan_mode() {
+        if (const auto pinned = pinnedMode.load(std::memory_order_relaxed); pinned != 0) {
+            const auto mode = static_cast<scan_mode>(pinned - 1);
+            if (is_scan_mode_supported(mode) && is_enabled(mode)) {
+                return mode;
             }
         }
-#if !defined(LIBHAT_DISABLE_SSE)
-        if (ext.sse41) {
-            this->scanner = resolve_scanner<scan_mode::SSE>(*this);
+        for (const auto mode : mode_priority) {
+            if (is_scan_mode_supported(mode) && is_enabled(mode)) {
+                return mode;
+            }
+        }
+        return scan_mode::Single;
+    }
+
+    scan_mode best_scan_mode() {
+        auto state = cachedMode.load(std::memory_order_acquire);
+        if (state & 0xFFu) LIBHAT_LIKELY {
+            return static_cast<scan_mode>((state & 0xFFu) - 1);
+        }
+        const auto mode = compute_scan_mode();
+        cachedMode.compare_exchange_strong(state, state | (static_cast<uint32_t>(mode) + 1), std::memory_order_acq_rel);
+        return mode;
+    }
+
+    scan_mode select_scan_mode(const std::optional<scan_mode> requested) {
+        if (requested && is_scan_mode_supported(*requested)) {
+            return *requested;
+        }
+        return best_scan_mode();
+    }
+
+    void scan_context::auto_resolve_scanner(const std::span<const std::byte> data) {
+        // Keep the measured model alive until the scanner has been resolved
+        std::shared_ptr<const frequency_model> measured{};
+        if (!this->model && static_cast<bool>(this->hints & scan_hint::measure) && !data.empty()) {
+            measured = frequency_model::measure(data);
+            this->model = measured.get();
+        }
+
+        this->prefetchDistance = static_cast<bool>(this->hints & scan_hint::streaming)
+            ? streamingPrefetchDistance.load(std::memory_order_relaxed)
+            : 0;
+
+        // The resolvers of the vectorized modes overwrite the resolved mode when they fall back to another one
+        const auto selected = select_scan_mode(this->mode);
+        this->resolvedMode = selected;
+        this->scanner = dispatch().resolvers[static_cast<size_t>(selected)](*this);
+
+        if (measured) {
+            this->model = nullptr;
+        }
+    }
+}
+
+namespace hat {
+
+    bool is_scan_mode_supported(const scan_mode mode) {
+        return detail::dispatch().supported & detail::mode_bit(mode);
+    }
+
+    void pin_scan_mode(const std::optional<scan_mode> mode) {
+        detail::pinnedMode.store(mode ? static_cast<uint32_t>(*mode) + 1 : 0, std::memory_order_relaxed);
+        detail::invalidate_scan_mode();
+    }
+
+    void set_scan_mode_enabled(const scan_mode mode, const bool enabled) {
+        if (mode == scan_mode::Single) {
             return;
         }
-#endif
-#endif
-        // If none of the vectorized implementations are available/supported, then fallback to scanning per-byte
-        this->scanner = resolve_scanner<scan_mode::Single>(*this);
+        if (enabled) {
+            detail::disabledModes.fetch_and(~detail::mode_bit(mode), std::memory_order_relaxed);
+        } else {
+            detail::disabledModes.fetch_or(detail::mode_bit(mode), std::memory_order_relaxed);
+        }
+        detail::invalidate_scan_mode();
+    }
+
+    void set_prefetch_distance(const size_t distance) {
+        detail::streamingPrefetchDistance.store(distance, std::memory_order_relaxed);
+    }
+
+    size_t prefetch_distance() {
+        return detail::streamingPrefetchDistance.load(std::memory_order_relaxed);
+    }
+
+    scan_mode selected_scan_mode() {
+        return detail::best_scan_mode();
+    }
+
+    scan_mode calibrate_scan_mode() {
+        // Random bytes only rarely match the first pair of the signature, so the timing is dominated by the throughput
+        // of the vectorized loop rather than by verifying candidates
+        constexpr size_t bufferSize = 1 << 20;
+        std::vector<std::byte> buffer(bufferSize);
+        std::default_random_engine generator(123);
+        std::uniform_int_distribution<uint32_t> distribution(0, 0xFF);
+        for (auto& byte : buffer) {
+            byte = static_cast<std::byte>(distribution(generator));
+        }
+        constexpr auto signature = compile_signature<"48 8B 05 ? ? ? ? 48 85 C0 74 ? 48 8B">();
+
+        // Clear the pin so that the fastest mode is chosen among all the enabled ones
+        pin_scan_mode(std::nullopt);
+
+        std::optional<std::pair<scan_mode, std::chrono::steady_clock::duration>> fastest{};
+        for (const auto mode : detail::mode_priority) {
+            if (!is_scan_mode_supported(mode) || !detail::is_enabled(mode)) {
+                continue;
+            }
+            const auto context = detail::scan_context::create(signature, scan_alignment::X1, scan_hint::none, {}, nullptr, mode);
+
+            // The best of several runs is the least affected by interrupts and frequency transitions
+            auto best = std::chrono::steady_clock::duration::max();
+            for (size_t run = 0; run < 8; run++) {
+                const auto start = std::chrono::steady_clock::now();
+                (void) context.scan(buffer.data(), buffer.data() + buffer.size());
+                best = std::min(best, std::chrono::steady_clock::now() - start);
+            }
+            if (!fastest || best < fastest->second) {
+                fastest.emplace(mode, best);
+            }
+        }
+
+        const auto mode = fastest ? fastest->first : scan_mode::Single;
+        pin_scan_mode(mode);
+        return mode;
     }
 }
 
@@ -122,4 +417,14 @@ namespace hat {
         const auto [scan_end, results_end] = hat::find_all_pattern(a.cbegin(), a.cend(), results.begin(), results.end(), s);
         return scan_end == a.cend() && results_end == std::next(results.begin(), 2);
     }());
+
+    static_assert(std::is_same_v<scan_result, decltype(find_pattern<"01">(
+        std::declval<std::byte*>(),
+        std::declval<std::byte*>()))>);
+
+    static_assert([] {
+        constexpr std::array a{std::byte{1}, std::byte{2}, std::byte{3}, std::byte{4}, std::byte{1}};
+        return hat::find_pattern<"? 03 ? 01">(a.cbegin(), a.cend()).get() == &a[1]
+            && !hat::find_pattern<"04 01 ?">(a.cbegin(), a.cend()).has_result();
+    }());
 }
@@ -0,0 +1,49 @@
+#include <libhat/SignatureArena.hpp>
+
+#include <algorithm>
+
+namespace hat {
+
+    signature_arena::signature_arena(const size_t blockSize) : blockSize(std::max<size_t>(blockSize, 1)) {}
+
+    result<signature_view, signature_parse_error> signature_arena::parse(const std::string_view str) {
+        // The number of words is the number of elements of a valid signature, so that it is parsed in place
+        const auto data = this->reserve(detail::count_elements(str));
+        size_t count = 0;
+        if (const auto error = detail::parse_elements(str, [&](const signature_element element) { data[count++] = element; })) {
+            return result_error{error.value()};
+        }
+        return this->commit(count);
+    }
+
+    signature_view signature_arena::store(const signature_view signature) {
+        const auto data = this->reserve(signature.size());
+        std::ranges::copy(signature, data);
+        return this->commit(signature.size());
+    }
+
+    void signature_arena::clear() noexcept {
+        if (this->blocks.size() > 1) {
+            this->blocks.erase(this->blocks.begin() + 1, this->blocks.end());
+        }
+        this->used = 0;
+        this->elements = 0;
+    }
+
+    signature_element* signature_arena::reserve(const size_t count) {
+        if (this->blocks.empty() || this->blocks.back().capacity - this->used < count) {
+            // A signature larger than a block gets a block of its own
+            const auto capacity = std::max(this->blockSize, count);
+            this->blocks.push_back({std::make_unique<signature_element[]>(capacity), capacity});
+            this->used = 0;
+        }
+        return this->blocks.back().data.get() + this->used;
+    }
+
+    signature_view signature_arena::commit(const size_t count) {
+        const auto data = this->blocks.back().data.get() + this->used;
+        this->used += count;
+        this->elements += count;
+        return {data, count};
+    }
+}
@@ -0,0 +1,138 @@
+#include <libhat/Watch.hpp>
+
+#include "Hasher.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace hat {
+
+    watch::watch(const std::span<std::byte> range, const std::span<const signature_view> signatures, const scan_alignment alignment)
+        : data(range), set(signatures, alignment), results(signatures.size()) {
+
+        for (const auto signature : signatures) {
+            this->margin = std::max(this->margin, std::max<size_t>(signature.size(), 1) - 1);
+        }
+
+        this->set.find_all(this->data.begin(), this->data.end(), [&](const size_t index, const scan_result result) {
+            this->results[index].push_back(result);
+        });
+
+        const auto pages = (this->data.size() + watch_page_size - 1) / watch_page_size;
+        this->hashes.resize(pages);
+        for (size_t page = 0; page < pages; page++) {
+            this->hashes[page] = this->hash_page(page);
+        }
+    }
+
+    uint64_t watch::hash_page(const size_t page) const {
+        const auto offset = page * watch_page_size;
+        const std::span<const std::byte> bytes{this->data.data() + offset, std::min(watch_page_size, this->data.size() - offset)};
+        detail::hasher h{};
+        h.update(bytes);
+        return h.digest();
+    }
+
+    watch_update watch::update() {
+        std::vector<std::pair<size_t, size_t>> dirty{};
+        for (size_t page = 0; page < this->hashes.size(); page++) {
+            const auto hash = this->hash_page(page);
+            if (hash == this->hashes[page]) {
+                continue;
+            }
+            this->hashes[page] = hash;
+            if (!dirty.empty() && dirty.back().second == page) {
+                dirty.back().second++;
+            } else {
+                dirty.emplace_back(page, page + 1);
+            }
+        }
+        return this->rescan(dirty);
+    }
+
+    watch_update watch::update(const std::span<const std::span<std::byte>> changed) {
+        const auto begin = this->data.data();
+        const auto end = begin + this->data.size();
+
+        std::vector<std::pair<size_t, size_t>> dirty{};
+        for (const auto region : changed) {
+            const auto first = std::clamp(region.data(), begin, end);
+            const auto last = std::clamp(region.data() + region.size(), begin, end);
+            if (first < last) {
+                dirty.emplace_back(
+                    static_cast<size_t>(first - begin) / watch_page_size,
+                    (static_cast<size_t>(last - begin) + watch_page_size - 1) / watch_page_size
+                );
+            }
+        }
+
+        std::ranges::sort(dirty);
+        std::vector<std::pair<size_t, size_t>> merged{};
+        for (const auto& range : dirty) {
+            if (!merged.empty() && range.first <= merged.back().second) {
+                merged.back().second = std::max(merged.back().second, range.second);
+            } else {
+                merged.push_back(range);
+            }
+        }
+
+        for (const auto& [first, last] : merged) {
+            for (size_t page = first; page < last; page++) {
+                this->hashes[page] = this->hash_page(page);
+            }
+        }
+        return this->rescan(merged);
+    }
+
+    watch_update watch::rescan(const std::span<const std::pair<size_t, size_t>> pages) {
+        watch_update result{};
+        const auto size = this->data.size();
+        const auto begin = this->data.data();
+
+        // A match depends on the bytes [match, match + margin], so the matches beginning up to margin bytes before a
+        // changed page may have changed as well. Windows of match positions which overlap are merged.
+        std::vector<std::pair<size_t, size_t>> windows{};
+        for (const auto& [first, last] : pages) {
+            result.pages += last - first;
+            const auto windowBegin = first * watch_page_size - std::min(first * watch_page_size, this->margin);
+            const auto windowEnd = std::min(size, last * watch_page_size);
+            if (!windows.empty() && windowBegin <= windows.back().second) {
+                windows.back().second = windowEnd;
+            } else {
+                windows.emplace_back(windowBegin, windowEnd);
+            }
+        }
+
+        std::vector<std::vector<scan_result>> found(this->results.size());
+        for (const auto& [windowBegin, windowEnd] : windows) {
+            for (auto& matches : found) {
+                matches.clear();
+            }
+
+            const auto scanEnd = std::min(size, windowEnd + this->margin);
+            this->set.find_all(begin + windowBegin, begin + scanEnd, [&](const size_t index, const scan_result match) {
+                if (match.get() < begin + windowEnd) {
+                    found[index].push_back(match);
+                }
+            });
+
+            for (size_t i = 0; i < this->results.size(); i++) {
+                auto& matches = this->results[i];
+                const auto less = [](const scan_result a, const std::byte* b) { return a.get() < b; };
+                const auto first = std::lower_bound(matches.begin(), matches.end(), begin + windowBegin, less);
+                const auto last = std::lower_bound(first, matches.end(), begin + windowEnd, less);
+
+                // Every match in both the old and the new set of the window is unchanged
+                const auto compare = [](const scan_result a, const scan_result b) { return a.get() < b.get(); };
+                std::vector<scan_result> common{};
+                std::ranges::set_intersection(first, last, found[i].begin(), found[i].end(), std::back_inserter(common), compare);
+                result.removed += static_cast<size_t>(last - first) - common.size();
+                result.added += found[i].size() - common.size();
+
+                const auto position = matches.erase(first, last);
+                matches.insert(position, found[i].begin(), found[i].end());
+            }
+        }
+        return result;
+    }
+}
@@ -0,0 +1,137 @@
+#include <libhat/XrefIndex.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <tuple>
+
+namespace hat {
+
+    template<typename T>
+    static T read_unaligned(const std::byte* address) {
+        T value;
+        std::memcpy(&value, address, sizeof(T));
+        return value;
+    }
+
+    template<size_t Alignment>
+    static std::byte* align_up(std::byte* address) {
+        const auto value = reinterpret_cast<uintptr_t>(address);
+        return address + ((Alignment - value % Alignment) % Alignment);
+    }
+
+    static bool xref_order(const xref& lhs, const xref& rhs) {
+        return std::tie(lhs.target, lhs.kind, lhs.source) < std::tie(rhs.target, rhs.kind, rhs.source);
+    }
+
+    xref_index xref_index::build(const process::module_t mod, const xref_kind kinds) {
+        const auto module = process::get_module_data(mod);
+        auto* const base = module.data();
+        const auto contains = [&](const uintptr_t address) {
+            return address - reinterpret_cast<uintptr_t>(base) < module.size();
+        };
+
+        xref_index index{};
+        auto& entries = index.entries;
+
+        const auto regions = process::module_regions(mod, protection::Read);
+        if ((kinds & (xref_kind::pointer | xref_kind::image_offset)) != xref_kind::none) {
+            // Offsets pointing into the headers are mostly small integers, so they are only recorded from the first
+            // region of the module onward
+            const auto minOffset = regions.empty() ? 0 : static_cast<size_t>(regions.front().data() - base);
+
+            for (const auto region : regions) {
+                auto* const begin = region.data();
+                auto* const end = begin + region.size();
+
+                if ((kinds & xref_kind::pointer) != xref_kind::none) {
+                    for (auto* it = align_up<sizeof(uintptr_t)>(begin); it + sizeof(uintptr_t) <= end; it += sizeof(uintptr_t)) {
+                        const auto value = read_unaligned<uintptr_t>(it);
+                        if (contains(value)) {
+                            entries.push_back({reinterpret_cast<std::byte*>(value), it, xref_kind::pointer});
+                        }
+                    }
+                }
+                if ((kinds & xref_kind::image_offset) != xref_kind::none) {
+                    for (auto* it = align_up<sizeof(uint32_t)>(begin); it + sizeof(uint32_t) <= end; it += sizeof(uint32_t)) {
+                        const auto value = read_unaligned<uint32_t>(it);
+                        if (value >= minOffset && value < module.size()) {
+                            entries.push_back({base + value, it, xref_kind::image_offset});
+                        }
+                    }
+                }
+            }
+        }
+
+#ifdef LIBHAT_X86
+        if ((kinds & xref_kind::relative) != xref_kind::none) {
+            for (const auto region : process::module_regions(mod, protection::Read | protection::Execute)) {
+                auto* const begin = region.data();
+                auto* const end = begin + region.size();
+
+                // Every byte is treated as a potential opcode rather than disassembling, since the code may be
+                // interleaved with data and padding. Operands whose target is outside the module are discarded.
+                for (auto* it = begin; end - it >= 5; it++) {
+                    const auto opcode = *it;
+                    std::byte* operand;
+                    size_t size;
+                    if (opcode == std::byte{0xE8} || opcode == std::byte{0xE9}) {
+                        // call rel32, jmp rel32
+                        operand = it + 1;
+                        size = 5;
+                    }
+#ifdef LIBHAT_X86_64
+                    else if ((opcode == std::byte{0x89} || opcode == std::byte{0x8B} || opcode == std::byte{0x8D})
+                        && (it[1] & std::byte{0xC7}) == std::byte{0x05} && end - it >= 6) {
+                        // mov [rip+disp32], r; mov r, [rip+disp32]; lea r, [rip+disp32]
+                        operand = it + 2;
+                        size = 6;
+                    }
+#endif
+                    else {
+                        continue;
+                    }
+                    const auto target = reinterpret_cast<uintptr_t>(it + size) + static_cast<uintptr_t>(static_cast<intptr_t>(read_unaligned<int32_t>(operand)));
+                    if (contains(target)) {
+                        entries.push_back({reinterpret_cast<std::byte*>(target), operand, xref_kind::relative});
+                    }
+                }
+            }
+        }
+#endif
+
+        std::sort(entries.begin(), entries.end(), xref_order);
+        entries.shrink_to_fit();
+        return index;
+    }
+
+    std::span<const xref> xref_index::references(const void* target) const {
+        auto* const address = static_cast<std::byte*>(const_cast<void*>(target));
+        const auto [first, last] = std::equal_range(this->entries.begin(), this->entries.end(), xref{address, nullptr, xref_kind::none}, [](const xref& lhs, const xref& rhs) {
+            return lhs.target < rhs.target;
+        });
+        return {first, last};
+    }
+
+    scan_result xref_index::find(const void* target, const xref_kind kinds) const {
+        std::byte* result{};
+        for (const auto& ref : this->references(target)) {
+            if ((ref.kind & kinds) != xref_kind::none && (!result || ref.source < result)) {
+                result = ref.source;
+            }
+        }
+        return result;
+    }
+
+    scan_result xref_index::find(const void* target, const xref_kind kinds, const std::span<const std::byte> range) const {
+        std::byte* result{};
+        for (const auto& ref : this->references(target)) {
+            if ((ref.kind & kinds) == xref_kind::none || (result && ref.source >= result)) {
+                continue;
+            }
+            if (ref.source >= range.data() && ref.source < range.data() + range.size()) {
+                result = ref.source;
+            }
+        }
+        return result;
+    }
+}
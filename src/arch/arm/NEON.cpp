@@ -0,0 +1,299 @@
+#include <libhat/Defines.hpp>
+
+#if defined(LIBHAT_ARM64) && defined(LIBHAT_ARM_SCANNERS)
+
+#include <libhat/PatternSet.hpp>
+#include <libhat/Scanner.hpp>
+
+#include <arm_neon.h>
+#include <tuple>
+
+namespace hat::detail {
+
+    inline auto load_signature_neon(const scan_context& context) {
+        return std::make_tuple(
+            vld1q_u8(reinterpret_cast<const uint8_t*>(context.vectorBytes.data())),
+            vld1q_u8(reinterpret_cast<const uint8_t*>(context.vectorMask.data()))
+        );
+    }
+
+    // NEON has no equivalent to movemask. Shifting every 16-bit lane right by 4 and narrowing it packs the result of
+    // each byte comparison into a nibble, and keeping only the top bit of every nibble leaves bit (4 * i + 3) set for
+    // each matching byte i, so the mask can be iterated with tzcnt/blsr like its x86 counterparts.
+    LIBHAT_FORCEINLINE uint64_t movemask_neon(const uint8x16_t cmp) {
+        const auto nibbles = vshrn_n_u16(vreinterpretq_u16_u8(cmp), 4);
+        return vget_lane_u64(vreinterpret_u64_u8(nibbles), 0) & 0x8888888888888888ull;
+    }
+
+    template<scan_alignment alignment>
+    LIBHAT_FORCEINLINE consteval uint64_t create_alignment_mask_neon() {
+        uint64_t mask{};
+        for (size_t i = 0; i < 16; i += alignment_stride<alignment>) {
+            mask |= (uint64_t(0b1000) << (i * 4));
+        }
+        return mask;
+    }
+
+    // Compares a candidate against a signature which is longer than a single vector, one vector of the preloaded bytes
+    // at a time, stopping at the first vector that doesn't match. Vectors covering only wildcards are skipped.
+    LIBHAT_FORCEINLINE bool verify_long_neon(const std::byte* i, const scan_context& context) {
+        const auto verifySize = context.verify_size(sizeof(uint8x16_t));
+        for (size_t offset = 0; offset != verifySize; offset += sizeof(uint8x16_t)) {
+            if (!context.is_solid(offset, sizeof(uint8x16_t))) {
+                continue;
+            }
+            const auto bytes = vld1q_u8(reinterpret_cast<const uint8_t*>(context.vectorBytes.data() + offset));
+            const auto mask = vld1q_u8(reinterpret_cast<const uint8_t*>(context.vectorMask.data() + offset));
+            const auto data = vld1q_u8(reinterpret_cast<const uint8_t*>(i + offset));
+            if (vminvq_u8(vornq_u8(vceqq_u8(bytes, vandq_u8(data, mask)), mask)) != 0xFF) {
+                return false;
+            }
+        }
+        return context.verify_tail(i);
+    }
+
+    template<scan_alignment alignment, bool cmpeq2, bool veccmp, bool distant>
+    const_scan_result find_pattern_neon(const std::byte* begin, const std::byte* end, const scan_context& context, match_sink* sink) {
+        const auto signature = context.signature;
+        const auto cmpIndex = cmpeq2 ? *context.pairIndex : 0;
+        const auto distance = distant ? context.pairDistance : 1;
+        LIBHAT_ASSUME(cmpIndex < 16);
+
+        // 128 bit vector containing first signature byte repeated
+        const auto firstByte = vdupq_n_u8(static_cast<uint8_t>(*signature[cmpIndex]));
+
+        uint8x16_t secondByte;
+        if constexpr (cmpeq2) {
+            secondByte = vdupq_n_u8(static_cast<uint8_t>(*signature[cmpIndex + distance]));
+        }
+
+        uint8x16_t signatureBytes, signatureMask;
+        if constexpr (veccmp) {
+            std::tie(signatureBytes, signatureMask) = load_signature_neon(context);
+        }
+
+        begin = next_boundary_align<alignment>(begin);
+        if (begin >= end) LIBHAT_UNLIKELY {
+            return {};
+        }
+
+        auto [pre, vec, post] = segment_scan<uint8x16_t>(begin, end, signature.size(), cmpIndex, context.verify_size(sizeof(uint8x16_t)));
+
+        if (!pre.empty()) {
+            const auto result = find_pattern_single<alignment>(pre.data(), pre.data() + pre.size(), context, sink);
+            if (result.has_result()) {
+                return result;
+            }
+        }
+
+        for (auto& it : vec) {
+            const auto data = vld1q_u8(reinterpret_cast<const uint8_t*>(&it));
+            auto mask = movemask_neon(vceqq_u8(firstByte, data));
+
+            if constexpr (alignment != scan_alignment::X1) {
+                mask &= create_alignment_mask_neon<alignment>();
+                if (!mask) continue;
+            } else if constexpr (cmpeq2 && distant) {
+                mask &= movemask_neon(vceqq_u8(secondByte, vld1q_u8(reinterpret_cast<const uint8_t*>(&it) + distance)));
+            } else if constexpr (cmpeq2) {
+                const auto mask2 = movemask_neon(vceqq_u8(secondByte, data));
+                // avoid loading unaligned memory by letting a match of the first signature byte in the last
+                // position imply that the second byte also matched
+                mask &= (mask2 >> 4) | (0b1000ull << 60);
+            }
+
+            while (mask) {
+                const auto offset = static_cast<size_t>(LIBHAT_TZCNT64(mask)) / 4;
+                const auto i = reinterpret_cast<const std::byte*>(&it) + offset - cmpIndex;
+                count_candidate();
+                if constexpr (veccmp) {
+                    const auto bytes = vld1q_u8(reinterpret_cast<const uint8_t*>(i));
+                    const auto cmpToSig = vceqq_u8(signatureBytes, vandq_u8(bytes, signatureMask));
+                    // Every byte is 0xFF if it either matched or isn't part of the signature
+                    const auto matched = vminvq_u8(vornq_u8(cmpToSig, signatureMask)) == 0xFF;
+                    if (matched && stop_at(sink, i)) LIBHAT_UNLIKELY {
+                        return i;
+                    }
+                } else if (verify_long_neon(i, context) && stop_at(sink, i)) LIBHAT_UNLIKELY {
+                    return i;
+                }
+                mask = LIBHAT_BLSR64(mask);
+            }
+        }
+
+        if (!post.empty()) {
+            return find_pattern_single<alignment>(post.data(), post.data() + post.size(), context, sink);
+        }
+        return {};
+    }
+
+    // Every 64-bit lane of an aligned vector is an 8 byte aligned candidate, so the first 8 bytes of the signature are
+    // compared against all of them at once rather than only the first byte. If the signature is no longer than that,
+    // the lane comparison is the entire verification.
+    template<bool full, bool veccmp>
+    const_scan_result find_pattern_neon_x8(const std::byte* begin, const std::byte* end, const scan_context& context, match_sink* sink) {
+        const auto signature = context.signature;
+        const auto laneBytes = vld1q_dup_u64(reinterpret_cast<const uint64_t*>(context.vectorBytes.data()));
+        const auto laneMask = vld1q_dup_u64(reinterpret_cast<const uint64_t*>(context.vectorMask.data()));
+
+        uint8x16_t signatureBytes, signatureMask;
+        if constexpr (veccmp) {
+            std::tie(signatureBytes, signatureMask) = load_signature_neon(context);
+        }
+
+        begin = next_boundary_align<scan_alignment::X8>(begin);
+        if (begin >= end) LIBHAT_UNLIKELY {
+            return {};
+        }
+
+        auto [pre, vec, post] = segment_scan<uint8x16_t>(begin, end, signature.size(), 0, full ? 0 : context.verify_size(sizeof(uint8x16_t)));
+
+        if (!pre.empty()) {
+            const auto result = find_pattern_single<scan_alignment::X8>(pre.data(), pre.data() + pre.size(), context, sink);
+            if (result.has_result()) {
+                return result;
+            }
+        }
+
+        for (auto& it : vec) {
+            const auto data = vld1q_u64(reinterpret_cast<const uint64_t*>(&it));
+            const auto cmp = vceqq_u64(laneBytes, vandq_u64(data, laneMask));
+            auto mask = static_cast<uint32_t>((vgetq_lane_u64(cmp, 0) & 0b01) | (vgetq_lane_u64(cmp, 1) & 0b10));
+
+            while (mask) {
+                const auto i = reinterpret_cast<const std::byte*>(&it) + LIBHAT_BSF32(mask) * 8;
+                count_candidate();
+                if constexpr (full) {
+                    if (stop_at(sink, i)) LIBHAT_UNLIKELY {
+                        return i;
+                    }
+                } else if constexpr (veccmp) {
+                    const auto bytes = vld1q_u8(reinterpret_cast<const uint8_t*>(i));
+                    const auto cmpToSig = vceqq_u8(signatureBytes, vandq_u8(bytes, signatureMask));
+                    const auto matched = vminvq_u8(vornq_u8(cmpToSig, signatureMask)) == 0xFF;
+                    if (matched && stop_at(sink, i)) LIBHAT_UNLIKELY {
+                        return i;
+                    }
+                } else if (verify_long_neon(i, context) && stop_at(sink, i)) LIBHAT_UNLIKELY {
+                    return i;
+                }
+                mask &= (mask - 1);
+            }
+        }
+
+        if (!post.empty()) {
+            return find_pattern_single<scan_alignment::X8>(post.data(), post.data() + post.size(), context, sink);
+        }
+        return {};
+    }
+
+    template<scan_alignment alignment>
+    scan_function_t resolve_aligned_neon(const bool veccmp) {
+        if (veccmp) {
+            return &find_pattern_neon<alignment, false, true, false>;
+        } else {
+            return &find_pattern_neon<alignment, false, false, false>;
+        }
+    }
+
+    template<>
+    scan_function_t resolve_scanner<scan_mode::NEON>(scan_context& context) {
+        context.apply_hints({.vectorSize = 16});
+
+        const auto alignment = context.alignment;
+        const auto signature = context.signature;
+        const bool veccmp = context.verifyLength <= 16;
+
+        if (alignment == scan_alignment::X8) {
+            if (context.verifyLength <= 8) {
+                return &find_pattern_neon_x8<true, false>;
+            } else if (veccmp) {
+                return &find_pattern_neon_x8<false, true>;
+            } else {
+                return &find_pattern_neon_x8<false, false>;
+            }
+        }
+
+        // Without a pair, the scanner is anchored on the first element, which has to match exactly one byte value
+        if ((alignment != scan_alignment::X1 || !context.pairIndex.has_value()) && !signature[0].has_value()) {
+            return resolve_scanner<scan_mode::Single>(context);
+        }
+
+        if (alignment == scan_alignment::X1) {
+            const bool cmpeq2 = context.pairIndex.has_value();
+            const bool distant = cmpeq2 && context.pairDistance != 1;
+            if (distant && veccmp) {
+                return &find_pattern_neon<scan_alignment::X1, true, true, true>;
+            } else if (distant) {
+                return &find_pattern_neon<scan_alignment::X1, true, false, true>;
+            } else if (cmpeq2 && veccmp) {
+                return &find_pattern_neon<scan_alignment::X1, true, true, false>;
+            } else if (cmpeq2) {
+                return &find_pattern_neon<scan_alignment::X1, true, false, false>;
+            } else if (veccmp) {
+                return &find_pattern_neon<scan_alignment::X1, false, true, false>;
+            } else {
+                return &find_pattern_neon<scan_alignment::X1, false, false, false>;
+            }
+        }
+
+        switch (alignment) {
+            case scan_alignment::X2:  return resolve_aligned_neon<scan_alignment::X2>(veccmp);
+            case scan_alignment::X4:  return resolve_aligned_neon<scan_alignment::X4>(veccmp);
+            case scan_alignment::X16: return resolve_aligned_neon<scan_alignment::X16>(veccmp);
+            // At most every other vector holds a candidate, which is cheaper to test one byte at a time
+            case scan_alignment::X32:
+            case scan_alignment::X64: return resolve_scanner<scan_mode::Single>(context);
+            default:                  break;
+        }
+        LIBHAT_UNREACHABLE();
+    }
+
+    LIBHAT_FORCEINLINE uint8x16x2_t load_byte_set_neon(const byte_set_table& table) {
+        uint8x16x2_t lookup;
+        lookup.val[0] = vld1q_u8(table.lo.data());
+        lookup.val[1] = vld1q_u8(table.hi.data());
+        return lookup;
+    }
+
+    // Returns a vector with every byte of data which is present in the set described by the lookup table set to 0xFF
+    LIBHAT_FORCEINLINE uint8x16_t byte_set_test_neon(const uint8x16_t data, const uint8x16x2_t lookup) {
+        static constexpr uint8_t bits[16]{1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+        // The high bit of the byte selects between the lo (indices 0-15) and hi (indices 16-31) tables
+        const auto index = vorrq_u8(
+            vandq_u8(data, vdupq_n_u8(0x0F)),
+            vandq_u8(vshrq_n_u8(data, 3), vdupq_n_u8(0x10))
+        );
+        const auto row = vqtbl2q_u8(lookup, index);
+        const auto bit = vqtbl1q_u8(vld1q_u8(bits), vshrq_n_u8(data, 4));
+        return vtstq_u8(row, bit);
+    }
+
+    const std::byte* find_candidate_neon(const std::byte* begin, const std::byte* end, const pattern_set_context& context) {
+        const auto first = load_byte_set_neon(context.first);
+        const auto second = load_byte_set_neon(context.second);
+
+        auto i = begin;
+        // The second anchor byte is loaded one byte past the first, so one extra byte must be readable
+        for (; static_cast<size_t>(end - i) > sizeof(uint8x16_t); i += sizeof(uint8x16_t)) {
+            const auto a = vld1q_u8(reinterpret_cast<const uint8_t*>(i));
+            const auto b = vld1q_u8(reinterpret_cast<const uint8_t*>(i + 1));
+            auto mask = movemask_neon(vandq_u8(byte_set_test_neon(a, first), byte_set_test_neon(b, second)));
+
+            while (mask) {
+                const auto candidate = i + static_cast<size_t>(LIBHAT_TZCNT64(mask)) / 4;
+                if (context.is_candidate(candidate, end)) {
+                    return candidate;
+                }
+                mask = LIBHAT_BLSR64(mask);
+            }
+        }
+        return find_candidate_single(i, end, context);
+    }
+
+    template<>
+    pattern_set_scan_function_t resolve_pattern_set_scanner<scan_mode::NEON>(const pattern_set_context&) {
+        return &find_candidate_neon;
+    }
+}
+#endif
@@ -0,0 +1,148 @@
+#include <libhat/Defines.hpp>
+
+#if defined(LIBHAT_ARM64) && defined(LIBHAT_ARM_SCANNERS) && !defined(LIBHAT_DISABLE_SVE2)
+
+#include <libhat/PatternSet.hpp>
+#include <libhat/Scanner.hpp>
+
+#include <arm_sve.h>
+
+namespace hat::detail {
+
+    // Compares a candidate against a signature which is longer than a single vector, one vector of the preloaded bytes
+    // at a time, stopping at the first vector that doesn't match. The loads are predicated on the bytes that are part
+    // of the signature, so nothing past the end of the candidate is accessed.
+    LIBHAT_FORCEINLINE bool verify_long_sve2(const std::byte* i, const scan_context& context) {
+        const auto preloaded = std::min(context.verifyLength, context.vectorBytes.size());
+        const auto lanes = svcntb();
+        for (size_t offset = 0; offset < preloaded; offset += lanes) {
+            const auto pg = svwhilelt_b8_u64(offset, preloaded);
+            const auto mask = svld1_u8(pg, reinterpret_cast<const uint8_t*>(context.vectorMask.data() + offset));
+            const auto present = svcmpne_n_u8(pg, mask, 0);
+            const auto bytes = svld1_u8(present, reinterpret_cast<const uint8_t*>(context.vectorBytes.data() + offset));
+            const auto data = svld1_u8(present, reinterpret_cast<const uint8_t*>(i + offset));
+            if (svptest_any(present, svcmpne_u8(present, bytes, svand_u8_x(present, data, mask)))) {
+                return false;
+            }
+        }
+        return context.verify_tail(i);
+    }
+
+    // The number of lanes in an SVE vector is only known at runtime, so unlike the fixed width scanners the input isn't
+    // split into pre/vec/post segments. Instead, every iteration is predicated on the positions remaining in the range,
+    // and predicated loads never access the memory of inactive lanes.
+    template<bool cmpeq2, bool veccmp>
+    const_scan_result find_pattern_sve2(const std::byte* begin, const std::byte* end, const scan_context& context, match_sink* sink) {
+        const auto signature = context.signature;
+        const auto cmpIndex = cmpeq2 ? *context.pairIndex : 0;
+        const auto distance = cmpeq2 ? context.pairDistance : 1;
+
+        const auto firstByte = static_cast<uint8_t>(*signature[cmpIndex]);
+        const auto secondByte = cmpeq2 ? static_cast<uint8_t>(*signature[cmpIndex + distance]) : uint8_t{};
+
+        // Only the bytes that are at least partially specified by the signature are loaded for the comparison
+        const auto signatureLanes = svwhilelt_b8_u64(0, std::min(context.verifyLength, context.vectorMask.size()));
+        const auto signaturePresent = svcmpne_n_u8(
+            signatureLanes,
+            svld1_u8(signatureLanes, reinterpret_cast<const uint8_t*>(context.vectorMask.data())),
+            0
+        );
+        const auto signatureBytes = svld1_u8(signaturePresent, reinterpret_cast<const uint8_t*>(context.vectorBytes.data()));
+        const auto signatureBits = svld1_u8(signaturePresent, reinterpret_cast<const uint8_t*>(context.vectorMask.data()));
+
+        if (begin >= end || static_cast<size_t>(end - begin) < signature.size()) LIBHAT_UNLIKELY {
+            return {};
+        }
+
+        // Every position in [begin, scanEnd) may be the start of a match
+        const auto scanEnd = end - signature.size() + 1;
+        const auto lanes = svcntb();
+
+        for (auto i = begin; i < scanEnd; i += lanes) {
+            const auto pg = svwhilelt_b8_u64(0, static_cast<uint64_t>(scanEnd - i));
+            const auto data = reinterpret_cast<const uint8_t*>(i + cmpIndex);
+
+            auto match = svcmpeq_n_u8(pg, svld1_u8(pg, data), firstByte);
+            if constexpr (cmpeq2) {
+                match = svcmpeq_n_u8(match, svld1_u8(pg, data + distance), secondByte);
+            }
+
+            while (svptest_any(pg, match)) {
+                // The number of lanes before the first active lane is the offset of the candidate
+                const auto candidate = i + svcntp_b8(pg, svbrkb_b_z(pg, match));
+                count_candidate();
+                if constexpr (veccmp) {
+                    const auto bytes = svld1_u8(signaturePresent, reinterpret_cast<const uint8_t*>(candidate));
+                    if (!svptest_any(signaturePresent, svcmpne_u8(signaturePresent, signatureBytes, svand_u8_x(signaturePresent, bytes, signatureBits))) && stop_at(sink, candidate)) LIBHAT_UNLIKELY {
+                        return candidate;
+                    }
+                } else if (verify_long_sve2(candidate, context) && stop_at(sink, candidate)) LIBHAT_UNLIKELY {
+                    return candidate;
+                }
+                // Clear the first active lane
+                match = svbic_b_z(pg, match, svbrka_b_z(pg, match));
+            }
+        }
+        return {};
+    }
+
+    template<>
+    scan_function_t resolve_scanner<scan_mode::SVE2>(scan_context& context) {
+        // Only every 16th position is a candidate for aligned scans, which doesn't benefit from the wider vectors
+        if (context.alignment != scan_alignment::X1) {
+            context.resolvedMode = scan_mode::NEON;
+            return resolve_scanner<scan_mode::NEON>(context);
+        }
+
+        context.apply_hints({.vectorSize = svcntb()});
+
+        const auto signature = context.signature;
+        const bool veccmp = context.verifyLength <= std::min<size_t>(svcntb(), context.vectorBytes.size());
+        const bool cmpeq2 = context.pairIndex.has_value();
+
+        // Without a pair, the scanner is anchored on the first element, which has to match exactly one byte value
+        if (!cmpeq2 && !signature[0].has_value()) {
+            return resolve_scanner<scan_mode::Single>(context);
+        }
+
+        if (cmpeq2 && veccmp) {
+            return &find_pattern_sve2<true, true>;
+        } else if (cmpeq2) {
+            return &find_pattern_sve2<true, false>;
+        } else if (veccmp) {
+            return &find_pattern_sve2<false, true>;
+        } else {
+            return &find_pattern_sve2<false, false>;
+        }
+    }
+
+    const std::byte* find_candidate_sve2(const std::byte* begin, const std::byte* end, const pattern_set_context& context) {
+        // MATCH tests every byte against all 16 bytes in the corresponding 128-bit segment, so each segment holds the
+        // full set of first anchor bytes
+        const auto needles = svld1rq_u8(svptrue_b8(), reinterpret_cast<const uint8_t*>(context.firstBytes.data()));
+        const auto lanes = svcntb();
+
+        for (auto i = begin; i < end; i += lanes) {
+            const auto pg = svwhilelt_b8_u64(0, static_cast<uint64_t>(end - i));
+            auto match = svmatch_u8(pg, svld1_u8(pg, reinterpret_cast<const uint8_t*>(i)), needles);
+
+            while (svptest_any(pg, match)) {
+                const auto candidate = i + svcntp_b8(pg, svbrkb_b_z(pg, match));
+                if (context.is_candidate(candidate, end)) {
+                    return candidate;
+                }
+                match = svbic_b_z(pg, match, svbrka_b_z(pg, match));
+            }
+        }
+        return end;
+    }
+
+    template<>
+    pattern_set_scan_function_t resolve_pattern_set_scanner<scan_mode::SVE2>(const pattern_set_context& context) {
+        if (context.firstCount <= context.firstBytes.size()) {
+            return &find_candidate_sve2;
+        }
+        return resolve_pattern_set_scanner<scan_mode::NEON>(context);
+    }
+}
+#endif
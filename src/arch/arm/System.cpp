@@ -3,7 +3,38 @@
 
 #include <libhat/System.hpp>
 
+#if defined(LIBHAT_WINDOWS)
+    #include <Windows.h>
+#elif defined(LIBHAT_LINUX)
+    #include <sys/auxv.h>
+#endif
+
 namespace hat {
 
+    system_info_arm::system_info_arm() {
+#if defined(LIBHAT_WINDOWS)
+        this->extensions.neon = IsProcessorFeaturePresent(PF_ARM_NEON_INSTRUCTIONS_AVAILABLE);
+    #ifdef PF_ARM_SVE_INSTRUCTIONS_AVAILABLE
+        this->extensions.sve = IsProcessorFeaturePresent(PF_ARM_SVE_INSTRUCTIONS_AVAILABLE);
+    #endif
+    #ifdef PF_ARM_SVE2_INSTRUCTIONS_AVAILABLE
+        this->extensions.sve2 = IsProcessorFeaturePresent(PF_ARM_SVE2_INSTRUCTIONS_AVAILABLE);
+    #endif
+#elif defined(LIBHAT_LINUX)
+        const auto hwcap = getauxval(AT_HWCAP);
+    #if defined(LIBHAT_ARM64)
+        // Advanced SIMD is mandatory on AArch64, but is still reported by the kernel as "asimd"
+        this->extensions.neon = hwcap & HWCAP_ASIMD;
+        #ifdef HWCAP_SVE
+        this->extensions.sve = hwcap & HWCAP_SVE;
+        #endif
+        #ifdef HWCAP2_SVE2
+        this->extensions.sve2 = this->extensions.sve && (getauxval(AT_HWCAP2) & HWCAP2_SVE2);
+        #endif
+    #else
+        this->extensions.neon = hwcap & HWCAP_ARM_NEON;
+    #endif
+#endif
+    }
 }
 #endif
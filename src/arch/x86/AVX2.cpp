@@ -2,46 +2,67 @@
 
 #ifdef LIBHAT_X86
 
+#include <libhat/PatternSet.hpp>
 #include <libhat/Scanner.hpp>
 
+#include <cstring>
 #include <immintrin.h>
-#include <tuple>
+
+LIBHAT_TARGET_BEGIN("avx,avx2,bmi")
 
 namespace hat::detail {
 
-    inline auto load_signature_256(const signature_view signature) {
-        std::byte byteBuffer[32]{}; // The remaining signature bytes
-        std::byte maskBuffer[32]{}; // A bitmask for the signature bytes we care about
-        for (size_t i = 0; i < signature.size(); i++) {
-            auto e = signature[i];
-            if (e.has_value()) {
-                byteBuffer[i] = *e;
-                maskBuffer[i] = std::byte{0xFFu};
+    // Returned instead of a std::tuple, whose constructors aren't compiled for the instruction set of this file
+    struct vector_pair_256 {
+        __m256i first;
+        __m256i second;
+    };
+
+    inline auto load_signature_256(const scan_context& context) {
+        return vector_pair_256{
+            _mm256_load_si256(reinterpret_cast<const __m256i*>(context.vectorBytes.data())),
+            _mm256_load_si256(reinterpret_cast<const __m256i*>(context.vectorMask.data()))
+        };
+    }
+
+    // Compares a candidate against a signature which is longer than a single vector, one vector of the preloaded bytes
+    // at a time, stopping at the first vector that doesn't match. Vectors covering only wildcards are skipped.
+    LIBHAT_FORCEINLINE bool verify_long_avx2(const std::byte* i, const scan_context& context) {
+        const auto verifySize = context.verify_size(sizeof(__m256i));
+        for (size_t offset = 0; offset != verifySize; offset += sizeof(__m256i)) {
+            if (!context.is_solid(offset, sizeof(__m256i))) {
+                continue;
+            }
+            const auto bytes = _mm256_load_si256(reinterpret_cast<const __m256i*>(context.vectorBytes.data() + offset));
+            const auto mask = _mm256_load_si256(reinterpret_cast<const __m256i*>(context.vectorMask.data() + offset));
+            const auto data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(i + offset));
+            if (!_mm256_testc_si256(_mm256_cmpeq_epi8(bytes, _mm256_and_si256(data, mask)), mask)) {
+                return false;
             }
         }
-        return std::make_tuple(
-            _mm256_loadu_si256(reinterpret_cast<__m256i*>(&byteBuffer)),
-            _mm256_loadu_si256(reinterpret_cast<__m256i*>(&maskBuffer))
-        );
+        return context.verify_tail(i);
     }
 
-    template<scan_alignment alignment, bool cmpeq2, bool veccmp>
-    const_scan_result find_pattern_avx2(const std::byte* begin, const std::byte* end, const scan_context& context) {
+    template<scan_alignment alignment, bool cmpeq2, bool veccmp, bool distant, bool streaming>
+    const_scan_result find_pattern_avx2(const std::byte* begin, const std::byte* end, const scan_context& context, match_sink* sink) {
         const auto signature = context.signature;
+        const auto prefetchDistance = context.prefetchDistance;
         const auto cmpIndex = cmpeq2 ? *context.pairIndex : 0;
-        LIBHAT_ASSUME(cmpIndex < 32);
+        const auto distance = distant ? context.pairDistance : 1;
 
         // 256 bit vector containing first signature byte repeated
         const auto firstByte = _mm256_set1_epi8(static_cast<int8_t>(*signature[cmpIndex]));
 
         __m256i secondByte;
         if constexpr (cmpeq2) {
-            secondByte = _mm256_set1_epi8(static_cast<int8_t>(*signature[cmpIndex + 1]));
+            secondByte = _mm256_set1_epi8(static_cast<int8_t>(*signature[cmpIndex + distance]));
         }
 
         __m256i signatureBytes, signatureMask;
         if constexpr (veccmp) {
-            std::tie(signatureBytes, signatureMask) = load_signature_256(signature);
+            const auto loaded = load_signature_256(context);
+            signatureBytes = loaded.first;
+            signatureMask = loaded.second;
         }
 
         begin = next_boundary_align<alignment>(begin);
@@ -49,22 +70,30 @@ namespace hat::detail {
             return {};
         }
 
-        auto [pre, vec, post] = segment_scan<__m256i>(begin, end, signature.size(), cmpIndex);
+        auto [pre, vec, post] = segment_scan<__m256i>(begin, end, signature.size(), cmpIndex, context.verify_size(sizeof(__m256i)));
 
         if (!pre.empty()) {
-            const auto result = find_pattern_single<alignment>(pre.data(), pre.data() + pre.size(), context);
+            const auto result = find_pattern_single<alignment>(pre.data(), pre.data() + pre.size(), context, sink);
             if (result.has_result()) {
                 return result;
             }
         }
 
         for (auto& it : vec) {
+            if constexpr (streaming) {
+                _mm_prefetch(reinterpret_cast<const char*>(&it) + prefetchDistance, _MM_HINT_T0);
+            }
             const auto cmp = _mm256_cmpeq_epi8(firstByte, _mm256_loadu_si256(&it));
             auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(cmp));
 
             if constexpr (alignment != scan_alignment::X1) {
                 mask &= create_alignment_mask<uint32_t, alignment>();
                 if (!mask) continue;
+            } else if constexpr (cmpeq2 && distant) {
+                // the second byte is loaded at its distance from the first, which stays in bounds because every
+                // vector is followed by at least the size of the signature
+                const auto cmp2 = _mm256_cmpeq_epi8(secondByte, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(reinterpret_cast<const std::byte*>(&it) + distance)));
+                mask &= static_cast<uint32_t>(_mm256_movemask_epi8(cmp2));
             } else if constexpr (cmpeq2) {
                 const auto cmp2 = _mm256_cmpeq_epi8(secondByte, _mm256_loadu_si256(&it));
                 auto mask2 = static_cast<uint32_t>(_mm256_movemask_epi8(cmp2));
@@ -76,58 +105,224 @@ namespace hat::detail {
             while (mask) {
                 const auto offset = _tzcnt_u32(mask);
                 const auto i = reinterpret_cast<const std::byte*>(&it) + offset - cmpIndex;
+                count_candidate();
                 if constexpr (veccmp) {
                     const auto data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(i));
-                    const auto cmpToSig = _mm256_cmpeq_epi8(signatureBytes, data);
+                    const auto cmpToSig = _mm256_cmpeq_epi8(signatureBytes, _mm256_and_si256(data, signatureMask));
                     const auto matched = _mm256_testc_si256(cmpToSig, signatureMask);
-                    if (matched) LIBHAT_UNLIKELY {
+                    if (matched && stop_at(sink, i)) LIBHAT_UNLIKELY {
                         return i;
                     }
-                } else {
-                    auto match = std::equal(signature.begin(), signature.end(), i, [](auto opt, auto byte) {
-                        return !opt.has_value() || *opt == byte;
-                    });
-                    if (match) LIBHAT_UNLIKELY {
+                } else if (verify_long_avx2(i, context) && stop_at(sink, i)) LIBHAT_UNLIKELY {
+                    return i;
+                }
+                mask = _blsr_u32(mask);
+            }
+        }
+
+        if (!post.empty()) {
+            return find_pattern_single<alignment>(post.data(), post.data() + post.size(), context, sink);
+        }
+        return {};
+    }
+
+    // Every 64-bit lane of an aligned vector is an 8 byte aligned candidate, so the first 8 bytes of the signature are
+    // compared against all of them at once rather than only the first byte. If the signature is no longer than that,
+    // the lane comparison is the entire verification.
+    template<bool full, bool veccmp, bool streaming>
+    const_scan_result find_pattern_avx2_x8(const std::byte* begin, const std::byte* end, const scan_context& context, match_sink* sink) {
+        const auto signature = context.signature;
+        const auto prefetchDistance = context.prefetchDistance;
+        uint64_t laneValue, laneValueMask;
+        std::memcpy(&laneValue, context.vectorBytes.data(), sizeof(laneValue));
+        std::memcpy(&laneValueMask, context.vectorMask.data(), sizeof(laneValueMask));
+        const auto laneBytes = _mm256_set1_epi64x(static_cast<int64_t>(laneValue));
+        const auto laneMask = _mm256_set1_epi64x(static_cast<int64_t>(laneValueMask));
+
+        __m256i signatureBytes, signatureMask;
+        if constexpr (veccmp) {
+            const auto loaded = load_signature_256(context);
+            signatureBytes = loaded.first;
+            signatureMask = loaded.second;
+        }
+
+        begin = next_boundary_align<scan_alignment::X8>(begin);
+        if (begin >= end) LIBHAT_UNLIKELY {
+            return {};
+        }
+
+        auto [pre, vec, post] = segment_scan<__m256i>(begin, end, signature.size(), 0, full ? 0 : context.verify_size(sizeof(__m256i)));
+
+        if (!pre.empty()) {
+            const auto result = find_pattern_single<scan_alignment::X8>(pre.data(), pre.data() + pre.size(), context, sink);
+            if (result.has_result()) {
+                return result;
+            }
+        }
+
+        for (auto& it : vec) {
+            if constexpr (streaming) {
+                _mm_prefetch(reinterpret_cast<const char*>(&it) + prefetchDistance, _MM_HINT_T0);
+            }
+            const auto cmp = _mm256_cmpeq_epi64(laneBytes, _mm256_and_si256(_mm256_load_si256(&it), laneMask));
+            auto mask = static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(cmp)));
+
+            while (mask) {
+                const auto i = reinterpret_cast<const std::byte*>(&it) + _tzcnt_u32(mask) * 8;
+                count_candidate();
+                if constexpr (full) {
+                    if (stop_at(sink, i)) LIBHAT_UNLIKELY {
                         return i;
                     }
+                } else if constexpr (veccmp) {
+                    const auto data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(i));
+                    const auto cmpToSig = _mm256_cmpeq_epi8(signatureBytes, _mm256_and_si256(data, signatureMask));
+                    const auto matched = _mm256_testc_si256(cmpToSig, signatureMask);
+                    if (matched && stop_at(sink, i)) LIBHAT_UNLIKELY {
+                        return i;
+                    }
+                } else if (verify_long_avx2(i, context) && stop_at(sink, i)) LIBHAT_UNLIKELY {
+                    return i;
                 }
                 mask = _blsr_u32(mask);
             }
         }
 
         if (!post.empty()) {
-            return find_pattern_single<alignment>(post.data(), post.data() + post.size(), context);
+            return find_pattern_single<scan_alignment::X8>(post.data(), post.data() + post.size(), context, sink);
         }
         return {};
     }
 
+    // Selects the instantiation of a scanner which prefetches ahead of the scan if the context asks for it
+    template<scan_alignment alignment, bool cmpeq2, bool veccmp, bool distant>
+    scan_function_t select_avx2(const scan_context& context) {
+        if (context.prefetchDistance) {
+            return &find_pattern_avx2<alignment, cmpeq2, veccmp, distant, true>;
+        }
+        return &find_pattern_avx2<alignment, cmpeq2, veccmp, distant, false>;
+    }
+
+    template<bool full, bool veccmp>
+    scan_function_t select_avx2_x8(const scan_context& context) {
+        if (context.prefetchDistance) {
+            return &find_pattern_avx2_x8<full, veccmp, true>;
+        }
+        return &find_pattern_avx2_x8<full, veccmp, false>;
+    }
+
+    template<scan_alignment alignment>
+    scan_function_t resolve_aligned_avx2(const scan_context& context, const bool veccmp) {
+        if (veccmp) {
+            return select_avx2<alignment, false, true, false>(context);
+        } else {
+            return select_avx2<alignment, false, false, false>(context);
+        }
+    }
+
     template<>
     scan_function_t resolve_scanner<scan_mode::AVX2>(scan_context& context) {
-        context.apply_hints({.vectorSize = 32});
+        context.apply_hints({.vectorSize = 32, .farPairs = true});
 
         const auto alignment = context.alignment;
         const auto signature = context.signature;
-        const bool veccmp = signature.size() <= 32;
+        const bool veccmp = context.verifyLength <= 32;
+
+        if (alignment == scan_alignment::X8) {
+            if (context.verifyLength <= 8) {
+                return select_avx2_x8<true, false>(context);
+            } else if (veccmp) {
+                return select_avx2_x8<false, true>(context);
+            } else {
+                return select_avx2_x8<false, false>(context);
+            }
+        }
+
+        // Without a pair, the scanner is anchored on the first element, which has to match exactly one byte value
+        if ((alignment != scan_alignment::X1 || !context.pairIndex.has_value()) && !signature[0].has_value()) {
+            return resolve_scanner<scan_mode::Single>(context);
+        }
 
         if (alignment == scan_alignment::X1) {
             const bool cmpeq2 = context.pairIndex.has_value();
-            if (cmpeq2 && veccmp) {
-                return &find_pattern_avx2<scan_alignment::X1, true, true>;
+            const bool distant = cmpeq2 && context.pairDistance != 1;
+            if (distant && veccmp) {
+                return select_avx2<scan_alignment::X1, true, true, true>(context);
+            } else if (distant) {
+                return select_avx2<scan_alignment::X1, true, false, true>(context);
+            } else if (cmpeq2 && veccmp) {
+                return select_avx2<scan_alignment::X1, true, true, false>(context);
             } else if (cmpeq2) {
-                return &find_pattern_avx2<scan_alignment::X1, true, false>;
+                return select_avx2<scan_alignment::X1, true, false, false>(context);
             } else if (veccmp) {
-                return &find_pattern_avx2<scan_alignment::X1, false, true>;
+                return select_avx2<scan_alignment::X1, false, true, false>(context);
             } else {
-                return &find_pattern_avx2<scan_alignment::X1, false, false>;
-            }
-        } else if (alignment == scan_alignment::X16) {
-            if (veccmp) {
-                return &find_pattern_avx2<scan_alignment::X16, false, true>;
-            } else {
-                return &find_pattern_avx2<scan_alignment::X16, false, false>;
+                return select_avx2<scan_alignment::X1, false, false, false>(context);
             }
         }
+
+        switch (alignment) {
+            case scan_alignment::X2:  return resolve_aligned_avx2<scan_alignment::X2>(context, veccmp);
+            case scan_alignment::X4:  return resolve_aligned_avx2<scan_alignment::X4>(context, veccmp);
+            case scan_alignment::X16: return resolve_aligned_avx2<scan_alignment::X16>(context, veccmp);
+            case scan_alignment::X32: return resolve_aligned_avx2<scan_alignment::X32>(context, veccmp);
+            // Only every other vector holds a candidate, which is cheaper to test one byte at a time
+            case scan_alignment::X64: return resolve_scanner<scan_mode::Single>(context);
+            default:                  break;
+        }
         LIBHAT_UNREACHABLE();
     }
+
+    LIBHAT_FORCEINLINE auto load_byte_set_256(const byte_set_table& table) {
+        return vector_pair_256{
+            _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(table.lo.data()))),
+            _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(table.hi.data())))
+        };
+    }
+
+    // Returns a bitmask of the bytes in data which are present in the set described by lo/hi
+    LIBHAT_FORCEINLINE uint32_t byte_set_test_256(const __m256i data, const __m256i lo, const __m256i hi) {
+        const auto bits = _mm256_setr_epi8(
+            1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128,
+            1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128
+        );
+        // Shuffling with the high bit of an index set yields 0, which selects between the lo and hi tables
+        const auto row = _mm256_or_si256(
+            _mm256_shuffle_epi8(lo, data),
+            _mm256_shuffle_epi8(hi, _mm256_xor_si256(data, _mm256_set1_epi8(static_cast<int8_t>(0x80))))
+        );
+        const auto bit = _mm256_shuffle_epi8(bits, _mm256_and_si256(_mm256_srli_epi16(data, 4), _mm256_set1_epi8(0x0F)));
+        const auto cmp = _mm256_cmpeq_epi8(_mm256_and_si256(row, bit), _mm256_setzero_si256());
+        return ~static_cast<uint32_t>(_mm256_movemask_epi8(cmp));
+    }
+
+    const std::byte* find_candidate_avx2(const std::byte* begin, const std::byte* end, const pattern_set_context& context) {
+        const auto [firstLo, firstHi] = load_byte_set_256(context.first);
+        const auto [secondLo, secondHi] = load_byte_set_256(context.second);
+
+        auto i = begin;
+        // The second anchor byte is loaded one byte past the first, so one extra byte must be readable
+        for (; static_cast<size_t>(end - i) > sizeof(__m256i); i += sizeof(__m256i)) {
+            const auto a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(i));
+            const auto b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(i + 1));
+            auto mask = byte_set_test_256(a, firstLo, firstHi) & byte_set_test_256(b, secondLo, secondHi);
+
+            while (mask) {
+                const auto candidate = i + _tzcnt_u32(mask);
+                if (context.is_candidate(candidate, end)) {
+                    return candidate;
+                }
+                mask = _blsr_u32(mask);
+            }
+        }
+        return find_candidate_single(i, end, context);
+    }
+
+    template<>
+    pattern_set_scan_function_t resolve_pattern_set_scanner<scan_mode::AVX2>(const pattern_set_context&) {
+        return &find_candidate_avx2;
+    }
 }
+
+LIBHAT_TARGET_END()
 #endif
@@ -2,47 +2,67 @@
 
 #if defined(LIBHAT_X86) && !defined(LIBHAT_DISABLE_AVX512)
 
+#include <libhat/PatternSet.hpp>
 #include <libhat/Scanner.hpp>
 
+#include <cstring>
 #include <immintrin.h>
-#include <tuple>
+
+LIBHAT_TARGET_BEGIN("avx512f,avx512bw,bmi")
 
 namespace hat::detail {
 
-    inline auto load_signature_512(const signature_view signature) {
-        std::byte byteBuffer[64]{}; // The remaining signature bytes
-        uint64_t maskBuffer{}; // A bitmask for the signature bytes we care about
-        for (size_t i = 0; i < signature.size(); i++) {
-            auto e = signature[i];
-            if (e.has_value()) {
-                byteBuffer[i] = *e;
-                maskBuffer |= (1ull << i);
+    // Returned instead of a std::tuple, whose constructors aren't compiled for the instruction set of this file
+    struct vector_pair_512 {
+        __m512i first;
+        __m512i second;
+    };
+
+    inline auto load_signature_512(const scan_context& context) {
+        return vector_pair_512{
+            _mm512_load_si512(context.vectorBytes.data()),
+            _mm512_load_si512(context.vectorMask.data())
+        };
+    }
+
+    // Compares a candidate against a signature which is longer than a single vector, one vector of the preloaded bytes
+    // at a time, stopping at the first vector that doesn't match. Vectors covering only wildcards are skipped.
+    LIBHAT_FORCEINLINE bool verify_long_avx512(const std::byte* i, const scan_context& context) {
+        const auto verifySize = context.verify_size(sizeof(__m512i));
+        for (size_t offset = 0; offset != verifySize; offset += sizeof(__m512i)) {
+            if (!context.is_solid(offset, sizeof(__m512i))) {
+                continue;
+            }
+            const auto bytes = _mm512_load_si512(context.vectorBytes.data() + offset);
+            const auto mask = _mm512_load_si512(context.vectorMask.data() + offset);
+            const auto data = _mm512_loadu_si512(i + offset);
+            if (_mm512_cmpneq_epi8_mask(bytes, _mm512_and_si512(data, mask))) {
+                return false;
             }
         }
-        return std::make_tuple(
-            _mm512_loadu_si512(&byteBuffer),
-            _cvtu64_mask64(maskBuffer)
-        );
+        return context.verify_tail(i);
     }
 
-    template<scan_alignment alignment, bool cmpeq2, bool veccmp>
-    const_scan_result find_pattern_avx512(const std::byte* begin, const std::byte* end, const scan_context& context) {
+    template<scan_alignment alignment, bool cmpeq2, bool veccmp, bool distant, bool streaming>
+    const_scan_result find_pattern_avx512(const std::byte* begin, const std::byte* end, const scan_context& context, match_sink* sink) {
         const auto signature = context.signature;
+        const auto prefetchDistance = context.prefetchDistance;
         const auto cmpIndex = cmpeq2 ? *context.pairIndex : 0;
-        LIBHAT_ASSUME(cmpIndex < 64);
+        const auto distance = distant ? context.pairDistance : 1;
 
         // 512 bit vector containing first signature byte repeated
         const auto firstByte = _mm512_set1_epi8(static_cast<int8_t>(*signature[cmpIndex]));
 
         __m512i secondByte;
         if constexpr (cmpeq2) {
-            secondByte = _mm512_set1_epi8(static_cast<int8_t>(*signature[cmpIndex + 1]));
+            secondByte = _mm512_set1_epi8(static_cast<int8_t>(*signature[cmpIndex + distance]));
         }
 
-        __m512i signatureBytes;
-        uint64_t signatureMask;
+        __m512i signatureBytes, signatureMask;
         if constexpr (veccmp) {
-            std::tie(signatureBytes, signatureMask) = load_signature_512(signature);
+            const auto loaded = load_signature_512(context);
+            signatureBytes = loaded.first;
+            signatureMask = loaded.second;
         }
 
         begin = next_boundary_align<alignment>(begin);
@@ -50,21 +70,26 @@ namespace hat::detail {
             return {};
         }
 
-        auto [pre, vec, post] = segment_scan<__m512i>(begin, end, signature.size(), cmpIndex);
+        auto [pre, vec, post] = segment_scan<__m512i>(begin, end, signature.size(), cmpIndex, context.verify_size(sizeof(__m512i)));
 
         if (!pre.empty()) {
-            const auto result = find_pattern_single<alignment>(pre.data(), pre.data() + pre.size(), context);
+            const auto result = find_pattern_single<alignment>(pre.data(), pre.data() + pre.size(), context, sink);
             if (result.has_result()) {
                 return result;
             }
         }
 
         for (auto& it : vec) {
+            if constexpr (streaming) {
+                _mm_prefetch(reinterpret_cast<const char*>(&it) + prefetchDistance, _MM_HINT_T0);
+            }
             auto mask = _mm512_cmpeq_epi8_mask(firstByte, _mm512_loadu_si512(&it));
 
             if constexpr (alignment != scan_alignment::X1) {
                 mask &= create_alignment_mask<uint64_t, alignment>();
                 if (!mask) continue;
+            } else if constexpr (cmpeq2 && distant) {
+                mask &= _mm512_cmpeq_epi8_mask(secondByte, _mm512_loadu_si512(reinterpret_cast<const std::byte*>(&it) + distance));
             } else if constexpr (cmpeq2) {
                 const auto mask2 = _mm512_cmpeq_epi8_mask(secondByte, _mm512_loadu_si512(&it));
                 mask &= (mask2 >> 1) | (0b1ull << 63);
@@ -73,57 +98,223 @@ namespace hat::detail {
             while (mask) {
                 const auto offset = LIBHAT_TZCNT64(mask);
                 const auto i = reinterpret_cast<const std::byte*>(&it) + offset - cmpIndex;
+                count_candidate();
                 if constexpr (veccmp) {
                     const auto data = _mm512_loadu_si512(i);
-                    const auto invalid = _mm512_mask_cmpneq_epi8_mask(signatureMask, signatureBytes, data);
-                    if (!invalid) LIBHAT_UNLIKELY {
+                    const auto invalid = _mm512_cmpneq_epi8_mask(signatureBytes, _mm512_and_si512(data, signatureMask));
+                    if (!invalid && stop_at(sink, i)) LIBHAT_UNLIKELY {
                         return i;
                     }
-                } else {
-                    auto match = std::equal(signature.begin(), signature.end(), i, [](auto opt, auto byte) {
-                        return !opt.has_value() || *opt == byte;
-                    });
-                    if (match) LIBHAT_UNLIKELY {
+                } else if (verify_long_avx512(i, context) && stop_at(sink, i)) LIBHAT_UNLIKELY {
+                    return i;
+                }
+                mask = LIBHAT_BLSR64(mask);
+            }
+        }
+
+        if (!post.empty()) {
+            return find_pattern_single<alignment>(post.data(), post.data() + post.size(), context, sink);
+        }
+        return {};
+    }
+
+    // Every 64-bit lane of an aligned vector is an 8 byte aligned candidate, so the first 8 bytes of the signature are
+    // compared against all of them at once rather than only the first byte. If the signature is no longer than that,
+    // the lane comparison is the entire verification.
+    template<bool full, bool veccmp, bool streaming>
+    const_scan_result find_pattern_avx512_x8(const std::byte* begin, const std::byte* end, const scan_context& context, match_sink* sink) {
+        const auto signature = context.signature;
+        const auto prefetchDistance = context.prefetchDistance;
+        uint64_t laneValue, laneValueMask;
+        std::memcpy(&laneValue, context.vectorBytes.data(), sizeof(laneValue));
+        std::memcpy(&laneValueMask, context.vectorMask.data(), sizeof(laneValueMask));
+        const auto laneBytes = _mm512_set1_epi64(static_cast<int64_t>(laneValue));
+        const auto laneMask = _mm512_set1_epi64(static_cast<int64_t>(laneValueMask));
+
+        __m512i signatureBytes, signatureMask;
+        if constexpr (veccmp) {
+            const auto loaded = load_signature_512(context);
+            signatureBytes = loaded.first;
+            signatureMask = loaded.second;
+        }
+
+        begin = next_boundary_align<scan_alignment::X8>(begin);
+        if (begin >= end) LIBHAT_UNLIKELY {
+            return {};
+        }
+
+        auto [pre, vec, post] = segment_scan<__m512i>(begin, end, signature.size(), 0, full ? 0 : context.verify_size(sizeof(__m512i)));
+
+        if (!pre.empty()) {
+            const auto result = find_pattern_single<scan_alignment::X8>(pre.data(), pre.data() + pre.size(), context, sink);
+            if (result.has_result()) {
+                return result;
+            }
+        }
+
+        for (auto& it : vec) {
+            if constexpr (streaming) {
+                _mm_prefetch(reinterpret_cast<const char*>(&it) + prefetchDistance, _MM_HINT_T0);
+            }
+            // Kept as a __mmask8, GCC 12 spills it as a byte but reloads 32 bits when it is widened to uint32_t
+            __mmask8 mask = _mm512_cmpeq_epi64_mask(laneBytes, _mm512_and_si512(_mm512_load_si512(&it), laneMask));
+
+            while (mask) {
+                const auto i = reinterpret_cast<const std::byte*>(&it) + _tzcnt_u32(mask) * 8;
+                count_candidate();
+                if constexpr (full) {
+                    if (stop_at(sink, i)) LIBHAT_UNLIKELY {
                         return i;
                     }
+                } else if constexpr (veccmp) {
+                    const auto data = _mm512_loadu_si512(i);
+                    const auto invalid = _mm512_cmpneq_epi8_mask(signatureBytes, _mm512_and_si512(data, signatureMask));
+                    if (!invalid && stop_at(sink, i)) LIBHAT_UNLIKELY {
+                        return i;
+                    }
+                } else if (verify_long_avx512(i, context) && stop_at(sink, i)) LIBHAT_UNLIKELY {
+                    return i;
                 }
-                mask = LIBHAT_BLSR64(mask);
+                mask = static_cast<__mmask8>(mask & (mask - 1));
             }
         }
 
         if (!post.empty()) {
-            return find_pattern_single<alignment>(post.data(), post.data() + post.size(), context);
+            return find_pattern_single<scan_alignment::X8>(post.data(), post.data() + post.size(), context, sink);
         }
         return {};
     }
 
+    // Selects the instantiation of a scanner which prefetches ahead of the scan if the context asks for it
+    template<scan_alignment alignment, bool cmpeq2, bool veccmp, bool distant>
+    scan_function_t select_avx512(const scan_context& context) {
+        if (context.prefetchDistance) {
+            return &find_pattern_avx512<alignment, cmpeq2, veccmp, distant, true>;
+        }
+        return &find_pattern_avx512<alignment, cmpeq2, veccmp, distant, false>;
+    }
+
+    template<bool full, bool veccmp>
+    scan_function_t select_avx512_x8(const scan_context& context) {
+        if (context.prefetchDistance) {
+            return &find_pattern_avx512_x8<full, veccmp, true>;
+        }
+        return &find_pattern_avx512_x8<full, veccmp, false>;
+    }
+
+    template<scan_alignment alignment>
+    scan_function_t resolve_aligned_avx512(const scan_context& context, const bool veccmp) {
+        if (veccmp) {
+            return select_avx512<alignment, false, true, false>(context);
+        } else {
+            return select_avx512<alignment, false, false, false>(context);
+        }
+    }
+
     template<>
     scan_function_t resolve_scanner<scan_mode::AVX512>(scan_context& context) {
-        context.apply_hints({.vectorSize = 64});
+        context.apply_hints({.vectorSize = 64, .farPairs = true});
 
         const auto alignment = context.alignment;
         const auto signature = context.signature;
-        const bool veccmp = signature.size() <= 64;
+        const bool veccmp = context.verifyLength <= 64;
+
+        if (alignment == scan_alignment::X8) {
+            if (context.verifyLength <= 8) {
+                return select_avx512_x8<true, false>(context);
+            } else if (veccmp) {
+                return select_avx512_x8<false, true>(context);
+            } else {
+                return select_avx512_x8<false, false>(context);
+            }
+        }
+
+        // Without a pair, the scanner is anchored on the first element, which has to match exactly one byte value
+        if ((alignment != scan_alignment::X1 || !context.pairIndex.has_value()) && !signature[0].has_value()) {
+            return resolve_scanner<scan_mode::Single>(context);
+        }
 
         if (alignment == scan_alignment::X1) {
             const bool cmpeq2 = context.pairIndex.has_value();
-            if (cmpeq2 && veccmp) {
-                return &find_pattern_avx512<scan_alignment::X1, true, true>;
+            const bool distant = cmpeq2 && context.pairDistance != 1;
+            if (distant && veccmp) {
+                return select_avx512<scan_alignment::X1, true, true, true>(context);
+            } else if (distant) {
+                return select_avx512<scan_alignment::X1, true, false, true>(context);
+            } else if (cmpeq2 && veccmp) {
+                return select_avx512<scan_alignment::X1, true, true, false>(context);
             } else if (cmpeq2) {
-                return &find_pattern_avx512<scan_alignment::X1, true, false>;
+                return select_avx512<scan_alignment::X1, true, false, false>(context);
             } else if (veccmp) {
-                return &find_pattern_avx512<scan_alignment::X1, false, true>;
-            } else {
-                return &find_pattern_avx512<scan_alignment::X1, false, false>;
-            }
-        } else if (alignment == scan_alignment::X16) {
-            if (veccmp) {
-                return &find_pattern_avx512<scan_alignment::X16, false, true>;
+                return select_avx512<scan_alignment::X1, false, true, false>(context);
             } else {
-                return &find_pattern_avx512<scan_alignment::X16, false, false>;
+                return select_avx512<scan_alignment::X1, false, false, false>(context);
             }
         }
+
+        switch (alignment) {
+            case scan_alignment::X2:  return resolve_aligned_avx512<scan_alignment::X2>(context, veccmp);
+            case scan_alignment::X4:  return resolve_aligned_avx512<scan_alignment::X4>(context, veccmp);
+            case scan_alignment::X16: return resolve_aligned_avx512<scan_alignment::X16>(context, veccmp);
+            case scan_alignment::X32: return resolve_aligned_avx512<scan_alignment::X32>(context, veccmp);
+            case scan_alignment::X64: return resolve_aligned_avx512<scan_alignment::X64>(context, veccmp);
+            default:                  break;
+        }
         LIBHAT_UNREACHABLE();
     }
+
+    // Repeats a 128-bit vector in every lane. The zero masked form is used because GCC 12 warns that the undefined
+    // vector _mm512_broadcast_i32x4 merges into is uninitialized.
+    LIBHAT_FORCEINLINE __m512i broadcast_128_512(const __m128i value) {
+        return _mm512_maskz_broadcast_i32x4(static_cast<__mmask16>(0xFFFF), value);
+    }
+
+    LIBHAT_FORCEINLINE auto load_byte_set_512(const byte_set_table& table) {
+        return vector_pair_512{
+            broadcast_128_512(_mm_loadu_si128(reinterpret_cast<const __m128i*>(table.lo.data()))),
+            broadcast_128_512(_mm_loadu_si128(reinterpret_cast<const __m128i*>(table.hi.data())))
+        };
+    }
+
+    // Returns a bitmask of the bytes in data which are present in the set described by lo/hi
+    LIBHAT_FORCEINLINE uint64_t byte_set_test_512(const __m512i data, const __m512i lo, const __m512i hi) {
+        const auto bits = broadcast_128_512(_mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128));
+        // Shuffling with the high bit of an index set yields 0, which selects between the lo and hi tables
+        const auto row = _mm512_or_si512(
+            _mm512_shuffle_epi8(lo, data),
+            _mm512_shuffle_epi8(hi, _mm512_xor_si512(data, _mm512_set1_epi8(static_cast<int8_t>(0x80))))
+        );
+        const auto bit = _mm512_shuffle_epi8(bits, _mm512_and_si512(_mm512_srli_epi16(data, 4), _mm512_set1_epi8(0x0F)));
+        return _mm512_test_epi8_mask(row, bit);
+    }
+
+    const std::byte* find_candidate_avx512(const std::byte* begin, const std::byte* end, const pattern_set_context& context) {
+        const auto [firstLo, firstHi] = load_byte_set_512(context.first);
+        const auto [secondLo, secondHi] = load_byte_set_512(context.second);
+
+        auto i = begin;
+        // The second anchor byte is loaded one byte past the first, so one extra byte must be readable
+        for (; static_cast<size_t>(end - i) > sizeof(__m512i); i += sizeof(__m512i)) {
+            const auto a = _mm512_loadu_si512(i);
+            const auto b = _mm512_loadu_si512(i + 1);
+            auto mask = byte_set_test_512(a, firstLo, firstHi) & byte_set_test_512(b, secondLo, secondHi);
+
+            while (mask) {
+                const auto candidate = i + LIBHAT_TZCNT64(mask);
+                if (context.is_candidate(candidate, end)) {
+                    return candidate;
+                }
+                mask = LIBHAT_BLSR64(mask);
+            }
+        }
+        return find_candidate_single(i, end, context);
+    }
+
+    template<>
+    pattern_set_scan_function_t resolve_pattern_set_scanner<scan_mode::AVX512>(const pattern_set_context&) {
+        return &find_candidate_avx512;
+    }
 }
+
+LIBHAT_TARGET_END()
 #endif
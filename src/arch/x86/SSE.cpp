@@ -2,46 +2,66 @@
 
 #if defined(LIBHAT_X86) && !defined(LIBHAT_DISABLE_SSE)
 
+#include <libhat/PatternSet.hpp>
 #include <libhat/Scanner.hpp>
 
+#include <cstring>
 #include <immintrin.h>
-#include <tuple>
+
+LIBHAT_TARGET_BEGIN("sse4.1")
 
 namespace hat::detail {
 
-    inline auto load_signature_128(const signature_view signature) {
-        std::byte byteBuffer[16]{}; // The remaining signature bytes
-        std::byte maskBuffer[16]{}; // A bitmask for the signature bytes we care about
-        for (size_t i = 0; i < signature.size(); i++) {
-            auto e = signature[i];
-            if (e.has_value()) {
-                byteBuffer[i] = *e;
-                maskBuffer[i] = std::byte{0xFFu};
+    // Returned instead of a std::tuple, whose constructors aren't compiled for the instruction set of this file
+    struct vector_pair_128 {
+        __m128i first;
+        __m128i second;
+    };
+
+    inline auto load_signature_128(const scan_context& context) {
+        return vector_pair_128{
+            _mm_load_si128(reinterpret_cast<const __m128i*>(context.vectorBytes.data())),
+            _mm_load_si128(reinterpret_cast<const __m128i*>(context.vectorMask.data()))
+        };
+    }
+
+    // Compares a candidate against a signature which is longer than a single vector, one vector of the preloaded bytes
+    // at a time, stopping at the first vector that doesn't match. Vectors covering only wildcards are skipped.
+    LIBHAT_FORCEINLINE bool verify_long_sse(const std::byte* i, const scan_context& context) {
+        const auto verifySize = context.verify_size(sizeof(__m128i));
+        for (size_t offset = 0; offset != verifySize; offset += sizeof(__m128i)) {
+            if (!context.is_solid(offset, sizeof(__m128i))) {
+                continue;
+            }
+            const auto bytes = _mm_load_si128(reinterpret_cast<const __m128i*>(context.vectorBytes.data() + offset));
+            const auto mask = _mm_load_si128(reinterpret_cast<const __m128i*>(context.vectorMask.data() + offset));
+            const auto data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(i + offset));
+            if (!_mm_testc_si128(_mm_cmpeq_epi8(bytes, _mm_and_si128(data, mask)), mask)) {
+                return false;
             }
         }
-        return std::make_tuple(
-            _mm_loadu_si128(reinterpret_cast<__m128i*>(&byteBuffer)),
-            _mm_loadu_si128(reinterpret_cast<__m128i*>(&maskBuffer))
-        );
+        return context.verify_tail(i);
     }
 
-    template<scan_alignment alignment, bool cmpeq2, bool veccmp>
-    const_scan_result find_pattern_sse(const std::byte* begin, const std::byte* end, const scan_context& context) {
+    template<scan_alignment alignment, bool cmpeq2, bool veccmp, bool distant>
+    const_scan_result find_pattern_sse(const std::byte* begin, const std::byte* end, const scan_context& context, match_sink* sink) {
         const auto signature = context.signature;
         const auto cmpIndex = cmpeq2 ? *context.pairIndex : 0;
-        LIBHAT_ASSUME(cmpIndex < 16);
+        const auto distance = distant ? context.pairDistance : 1;
 
         // 128 bit vector containing first signature byte repeated
         const auto firstByte = _mm_set1_epi8(static_cast<int8_t>(*signature[cmpIndex]));
 
         __m128i secondByte;
         if constexpr (cmpeq2) {
-            secondByte = _mm_set1_epi8(static_cast<int8_t>(*signature[cmpIndex + 1]));
+            secondByte = _mm_set1_epi8(static_cast<int8_t>(*signature[cmpIndex + distance]));
         }
 
         __m128i signatureBytes, signatureMask;
         if constexpr (veccmp) {
-            std::tie(signatureBytes, signatureMask) = load_signature_128(signature);
+            const auto loaded = load_signature_128(context);
+            signatureBytes = loaded.first;
+            signatureMask = loaded.second;
         }
 
         begin = next_boundary_align<alignment>(begin);
@@ -49,10 +69,10 @@ namespace hat::detail {
             return {};
         }
 
-        auto [pre, vec, post] = segment_scan<__m128i>(begin, end, signature.size(), cmpIndex);
+        auto [pre, vec, post] = segment_scan<__m128i>(begin, end, signature.size(), cmpIndex, context.verify_size(sizeof(__m128i)));
 
         if (!pre.empty()) {
-            const auto result = find_pattern_single<alignment>(pre.data(), pre.data() + pre.size(), context);
+            const auto result = find_pattern_single<alignment>(pre.data(), pre.data() + pre.size(), context, sink);
             if (result.has_result()) {
                 return result;
             }
@@ -65,6 +85,9 @@ namespace hat::detail {
             if constexpr (alignment != scan_alignment::X1) {
                 mask &= create_alignment_mask<uint16_t, alignment>();
                 if (!mask) continue;
+            } else if constexpr (cmpeq2 && distant) {
+                const auto cmp2 = _mm_cmpeq_epi8(secondByte, _mm_loadu_si128(reinterpret_cast<const __m128i*>(reinterpret_cast<const std::byte*>(&it) + distance)));
+                mask &= static_cast<uint16_t>(_mm_movemask_epi8(cmp2));
             } else if constexpr (cmpeq2) {
                 const auto cmp2 = _mm_cmpeq_epi8(secondByte, _mm_loadu_si128(&it));
                 auto mask2 = static_cast<uint16_t>(_mm_movemask_epi8(cmp2));
@@ -74,58 +97,200 @@ namespace hat::detail {
             while (mask) {
                 const auto offset = LIBHAT_BSF32(mask);
                 const auto i = reinterpret_cast<const std::byte*>(&it) + offset - cmpIndex;
+                count_candidate();
                 if constexpr (veccmp) {
                     const auto data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(i));
-                    const auto cmpToSig = _mm_cmpeq_epi8(signatureBytes, data);
+                    const auto cmpToSig = _mm_cmpeq_epi8(signatureBytes, _mm_and_si128(data, signatureMask));
                     const auto matched = _mm_testc_si128(cmpToSig, signatureMask);
-                    if (matched) LIBHAT_UNLIKELY {
+                    if (matched && stop_at(sink, i)) LIBHAT_UNLIKELY {
+                        return i;
+                    }
+                } else if (verify_long_sse(i, context) && stop_at(sink, i)) LIBHAT_UNLIKELY {
+                    return i;
+                }
+                mask &= (mask - 1);
+            }
+        }
+
+        if (!post.empty()) {
+            return find_pattern_single<alignment>(post.data(), post.data() + post.size(), context, sink);
+        }
+        return {};
+    }
+
+    // Every 64-bit lane of an aligned vector is an 8 byte aligned candidate, so the first 8 bytes of the signature are
+    // compared against all of them at once rather than only the first byte. If the signature is no longer than that,
+    // the lane comparison is the entire verification.
+    template<bool full, bool veccmp>
+    const_scan_result find_pattern_sse_x8(const std::byte* begin, const std::byte* end, const scan_context& context, match_sink* sink) {
+        const auto signature = context.signature;
+        uint64_t laneValue, laneValueMask;
+        std::memcpy(&laneValue, context.vectorBytes.data(), sizeof(laneValue));
+        std::memcpy(&laneValueMask, context.vectorMask.data(), sizeof(laneValueMask));
+        const auto laneBytes = _mm_set1_epi64x(static_cast<int64_t>(laneValue));
+        const auto laneMask = _mm_set1_epi64x(static_cast<int64_t>(laneValueMask));
+
+        __m128i signatureBytes, signatureMask;
+        if constexpr (veccmp) {
+            const auto loaded = load_signature_128(context);
+            signatureBytes = loaded.first;
+            signatureMask = loaded.second;
+        }
+
+        begin = next_boundary_align<scan_alignment::X8>(begin);
+        if (begin >= end) LIBHAT_UNLIKELY {
+            return {};
+        }
+
+        auto [pre, vec, post] = segment_scan<__m128i>(begin, end, signature.size(), 0, full ? 0 : context.verify_size(sizeof(__m128i)));
+
+        if (!pre.empty()) {
+            const auto result = find_pattern_single<scan_alignment::X8>(pre.data(), pre.data() + pre.size(), context, sink);
+            if (result.has_result()) {
+                return result;
+            }
+        }
+
+        for (auto& it : vec) {
+            const auto cmp = _mm_cmpeq_epi64(laneBytes, _mm_and_si128(_mm_load_si128(&it), laneMask));
+            auto mask = static_cast<uint32_t>(_mm_movemask_pd(_mm_castsi128_pd(cmp)));
+
+            while (mask) {
+                const auto i = reinterpret_cast<const std::byte*>(&it) + LIBHAT_BSF32(mask) * 8;
+                count_candidate();
+                if constexpr (full) {
+                    if (stop_at(sink, i)) LIBHAT_UNLIKELY {
                         return i;
                     }
-                } else {
-                    auto match = std::equal(signature.begin(), signature.end(), i, [](auto opt, auto byte) {
-                        return !opt.has_value() || *opt == byte;
-                    });
-                    if (match) LIBHAT_UNLIKELY {
+                } else if constexpr (veccmp) {
+                    const auto data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(i));
+                    const auto cmpToSig = _mm_cmpeq_epi8(signatureBytes, _mm_and_si128(data, signatureMask));
+                    const auto matched = _mm_testc_si128(cmpToSig, signatureMask);
+                    if (matched && stop_at(sink, i)) LIBHAT_UNLIKELY {
                         return i;
                     }
+                } else if (verify_long_sse(i, context) && stop_at(sink, i)) LIBHAT_UNLIKELY {
+                    return i;
                 }
                 mask &= (mask - 1);
             }
         }
 
         if (!post.empty()) {
-            return find_pattern_single<alignment>(post.data(), post.data() + post.size(), context);
+            return find_pattern_single<scan_alignment::X8>(post.data(), post.data() + post.size(), context, sink);
         }
         return {};
     }
 
+    template<scan_alignment alignment>
+    scan_function_t resolve_aligned_sse(const bool veccmp) {
+        if (veccmp) {
+            return &find_pattern_sse<alignment, false, true, false>;
+        } else {
+            return &find_pattern_sse<alignment, false, false, false>;
+        }
+    }
+
     template<>
     scan_function_t resolve_scanner<scan_mode::SSE>(scan_context& context) {
-        context.apply_hints({.vectorSize = 16});
+        context.apply_hints({.vectorSize = 16, .farPairs = true});
 
         const auto alignment = context.alignment;
         const auto signature = context.signature;
-        const bool veccmp = signature.size() <= 16;
+        const bool veccmp = context.verifyLength <= 16;
+
+        if (alignment == scan_alignment::X8) {
+            if (context.verifyLength <= 8) {
+                return &find_pattern_sse_x8<true, false>;
+            } else if (veccmp) {
+                return &find_pattern_sse_x8<false, true>;
+            } else {
+                return &find_pattern_sse_x8<false, false>;
+            }
+        }
+
+        // Without a pair, the scanner is anchored on the first element, which has to match exactly one byte value
+        if ((alignment != scan_alignment::X1 || !context.pairIndex.has_value()) && !signature[0].has_value()) {
+            return resolve_scanner<scan_mode::Single>(context);
+        }
 
         if (alignment == scan_alignment::X1) {
             const bool cmpeq2 = context.pairIndex.has_value();
-            if (cmpeq2 && veccmp) {
-                return &find_pattern_sse<scan_alignment::X1, true, true>;
+            const bool distant = cmpeq2 && context.pairDistance != 1;
+            if (distant && veccmp) {
+                return &find_pattern_sse<scan_alignment::X1, true, true, true>;
+            } else if (distant) {
+                return &find_pattern_sse<scan_alignment::X1, true, false, true>;
+            } else if (cmpeq2 && veccmp) {
+                return &find_pattern_sse<scan_alignment::X1, true, true, false>;
             } else if (cmpeq2) {
-                return &find_pattern_sse<scan_alignment::X1, true, false>;
+                return &find_pattern_sse<scan_alignment::X1, true, false, false>;
             } else if (veccmp) {
-                return &find_pattern_sse<scan_alignment::X1, false, true>;
+                return &find_pattern_sse<scan_alignment::X1, false, true, false>;
             } else {
-                return &find_pattern_sse<scan_alignment::X1, false, false>;
-            }
-        } else if (alignment == scan_alignment::X16) {
-            if (veccmp) {
-                return &find_pattern_sse<scan_alignment::X16, false, true>;
-            } else {
-                return &find_pattern_sse<scan_alignment::X16, false, false>;
+                return &find_pattern_sse<scan_alignment::X1, false, false, false>;
             }
         }
+
+        switch (alignment) {
+            case scan_alignment::X2:  return resolve_aligned_sse<scan_alignment::X2>(veccmp);
+            case scan_alignment::X4:  return resolve_aligned_sse<scan_alignment::X4>(veccmp);
+            case scan_alignment::X16: return resolve_aligned_sse<scan_alignment::X16>(veccmp);
+            // At most every other vector holds a candidate, which is cheaper to test one byte at a time
+            case scan_alignment::X32:
+            case scan_alignment::X64: return resolve_scanner<scan_mode::Single>(context);
+            default:                  break;
+        }
         LIBHAT_UNREACHABLE();
     }
+
+    LIBHAT_FORCEINLINE auto load_byte_set_128(const byte_set_table& table) {
+        return vector_pair_128{
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(table.lo.data())),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(table.hi.data()))
+        };
+    }
+
+    // Returns a bitmask of the bytes in data which are present in the set described by lo/hi
+    LIBHAT_FORCEINLINE uint16_t byte_set_test_128(const __m128i data, const __m128i lo, const __m128i hi) {
+        const auto bits = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+        // Shuffling with the high bit of an index set yields 0, which selects between the lo and hi tables
+        const auto row = _mm_or_si128(
+            _mm_shuffle_epi8(lo, data),
+            _mm_shuffle_epi8(hi, _mm_xor_si128(data, _mm_set1_epi8(static_cast<int8_t>(0x80))))
+        );
+        const auto bit = _mm_shuffle_epi8(bits, _mm_and_si128(_mm_srli_epi16(data, 4), _mm_set1_epi8(0x0F)));
+        const auto cmp = _mm_cmpeq_epi8(_mm_and_si128(row, bit), _mm_setzero_si128());
+        return static_cast<uint16_t>(~_mm_movemask_epi8(cmp));
+    }
+
+    const std::byte* find_candidate_sse(const std::byte* begin, const std::byte* end, const pattern_set_context& context) {
+        const auto [firstLo, firstHi] = load_byte_set_128(context.first);
+        const auto [secondLo, secondHi] = load_byte_set_128(context.second);
+
+        auto i = begin;
+        // The second anchor byte is loaded one byte past the first, so one extra byte must be readable
+        for (; static_cast<size_t>(end - i) > sizeof(__m128i); i += sizeof(__m128i)) {
+            const auto a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(i));
+            const auto b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(i + 1));
+            uint32_t mask = byte_set_test_128(a, firstLo, firstHi) & byte_set_test_128(b, secondLo, secondHi);
+
+            while (mask) {
+                const auto candidate = i + LIBHAT_BSF32(mask);
+                if (context.is_candidate(candidate, end)) {
+                    return candidate;
+                }
+                mask &= (mask - 1);
+            }
+        }
+        return find_candidate_single(i, end, context);
+    }
+
+    template<>
+    pattern_set_scan_function_t resolve_pattern_set_scanner<scan_mode::SSE>(const pattern_set_context&) {
+        return &find_candidate_sse;
+    }
 }
+
+LIBHAT_TARGET_END()
 #endif
@@ -5,10 +5,16 @@
 
 #include <array>
 #include <cstdint>
+#include <cstring>
 #include <bitset>
 #include <vector>
 #include <immintrin.h>
-#include <intrin.h>
+
+#ifdef _MSC_VER
+    #include <intrin.h>
+#else
+    #include <cpuid.h>
+#endif
 
 #ifndef _XCR_XFEATURE_ENABLED_MASK
     #define _XCR_XFEATURE_ENABLED_MASK 0
@@ -16,6 +22,19 @@
 
 namespace hat {
 
+    static void cpuid(std::array<int, 4>& info, const int leaf, const int subleaf = 0) {
+#ifdef _MSC_VER
+        __cpuidex(info.data(), leaf, subleaf);
+#else
+        __cpuid_count(leaf, subleaf, info[0], info[1], info[2], info[3]);
+#endif
+    }
+
+    // Only valid once CPUID reported that the OS has enabled XSAVE
+    LIBHAT_TARGET("xsave") static uint64_t xgetbv(const uint32_t xcr) {
+        return _xgetbv(xcr);
+    }
+
     static constexpr int CPU_BASIC_INFO = 0;
     static constexpr int CPU_EXTENDED_INFO = static_cast<int>(0x80000000);
     static constexpr int CPU_BRAND_STRING = static_cast<int>(0x80000004);
@@ -26,7 +45,7 @@ namespace hat {
         std::vector<std::array<int, 4>> extData{};
 
         // Gather info
-        __cpuid(info.data(), CPU_BASIC_INFO);
+        cpuid(info, CPU_BASIC_INFO);
         auto nIds = info[0];
 
         char vendor[0xC + 1]{};
@@ -35,15 +54,15 @@ namespace hat {
         memcpy(vendor + 8, &info[2], sizeof(int));
 
         for (int i = CPU_BASIC_INFO; i <= nIds; i++) {
-            __cpuidex(info.data(), i, 0);
+            cpuid(info, i);
             data.push_back(info);
         }
 
         // Gather extended info
-        __cpuid(info.data(), CPU_EXTENDED_INFO);
+        cpuid(info, CPU_EXTENDED_INFO);
         int nExtIds = info[0];
         for (int i = CPU_EXTENDED_INFO; i <= nExtIds; i++) {
-            __cpuidex(info.data(), i, 0);
+            cpuid(info, i);
             extData.push_back(info);
         }
 
@@ -74,7 +93,7 @@ namespace hat {
         bool osxsave = f_1_ECX_[27];
         if (xsave && osxsave) {
             // https://cdrdv2-public.intel.com/671190/253668-sdm-vol-3a.pdf (Page 2-20)
-            const std::bitset<64> xcr = _xgetbv(_XCR_XFEATURE_ENABLED_MASK);
+            const std::bitset<64> xcr = xgetbv(_XCR_XFEATURE_ENABLED_MASK);
             avxsupport = xcr[1] && xcr[2]; // xmm and ymm
             avx512support = avxsupport && xcr[5] && xcr[6] && xcr[7]; // opmask and zmm
         }
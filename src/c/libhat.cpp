@@ -1,7 +1,15 @@
 #include <libhat/c/libhat.h>
 
+#include <libhat/CompiledPattern.hpp>
+#include <libhat/PatternSet.hpp>
 #include <libhat/Scanner.hpp>
 
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <vector>
+
 static signature_t* allocate_signature(const hat::signature_view signature) {
     const auto bytes = std::as_bytes(signature);
     auto* mem = malloc(sizeof(signature_t) + bytes.size());
@@ -12,6 +20,55 @@ static signature_t* allocate_signature(const hat::signature_view signature) {
     return sig;
 }
 
+static std::optional<hat::scan_alignment> to_alignment(const scan_alignment align) {
+    switch (align) {
+        case scan_alignment_x1:  return hat::scan_alignment::X1;
+        case scan_alignment_x2:  return hat::scan_alignment::X2;
+        case scan_alignment_x4:  return hat::scan_alignment::X4;
+        case scan_alignment_x8:  return hat::scan_alignment::X8;
+        case scan_alignment_x16: return hat::scan_alignment::X16;
+        case scan_alignment_x32: return hat::scan_alignment::X32;
+        case scan_alignment_x64: return hat::scan_alignment::X64;
+    }
+    return std::nullopt;
+}
+
+static hat::signature_view to_view(const signature_t* signature) {
+    return {static_cast<hat::signature_element*>(signature->data), signature->count};
+}
+
+static std::vector<hat::signature_view> to_views(const signature_t* const* signatures, const size_t count) {
+    std::vector<hat::signature_view> views{};
+    views.reserve(count);
+    for (size_t i{}; i < count; i++) {
+        views.push_back(to_view(signatures[i]));
+    }
+    return views;
+}
+
+// Returns a callback for find_all which writes into the caller's buffer and stops the scan once it is full
+static auto write_to(const void** resultsOut, const size_t capacity) {
+    return [=, written = size_t{}](const hat::const_scan_result result) mutable {
+        resultsOut[written++] = result.get();
+        return written < capacity;
+    };
+}
+
+// Invokes fn with the alignment as a template argument
+template<typename Fn>
+static auto with_alignment(const scan_alignment align, Fn&& fn) {
+    switch (align) {
+        case scan_alignment_x1:  return fn.template operator()<hat::scan_alignment::X1>();
+        case scan_alignment_x2:  return fn.template operator()<hat::scan_alignment::X2>();
+        case scan_alignment_x4:  return fn.template operator()<hat::scan_alignment::X4>();
+        case scan_alignment_x8:  return fn.template operator()<hat::scan_alignment::X8>();
+        case scan_alignment_x16: return fn.template operator()<hat::scan_alignment::X16>();
+        case scan_alignment_x32: return fn.template operator()<hat::scan_alignment::X32>();
+        case scan_alignment_x64: return fn.template operator()<hat::scan_alignment::X64>();
+    }
+    exit(EXIT_FAILURE);
+}
+
 extern "C" {
 
 LIBHAT_API libhat_status_t libhat_parse_signature(const char* signatureStr, signature_t** signatureOut) {
@@ -67,13 +124,7 @@ LIBHAT_API const void* libhat_find_pattern(
         return result.has_result() ? result.get() : nullptr;
     };
 
-    switch (align) {
-        case scan_alignment_x1:
-            return find_pattern.operator()<hat::scan_alignment::X1>();
-        case scan_alignment_x16:
-            return find_pattern.operator()<hat::scan_alignment::X16>();
-    }
-    exit(EXIT_FAILURE);
+    return with_alignment(align, find_pattern);
 }
 
 LIBHAT_API const void* libhat_find_pattern_mod(
@@ -92,17 +143,168 @@ LIBHAT_API const void* libhat_find_pattern_mod(
         if (!mod.has_value()) {
             return nullptr;
         }
-        const auto result = hat::find_pattern(view, section, mod.value());
+        const auto result = hat::find_pattern<A>(view, section, mod.value());
         return result.has_result() ? result.get() : nullptr;
     };
 
-    switch (align) {
-        case scan_alignment_x1:
-            return find_pattern.operator()<hat::scan_alignment::X1>();
-        case scan_alignment_x16:
-            return find_pattern.operator()<hat::scan_alignment::X16>();
+    return with_alignment(align, find_pattern);
+}
+
+LIBHAT_API size_t libhat_find_all_pattern(
+    const signature_t*   signature,
+    const void*          buffer,
+    const size_t         size,
+    const scan_alignment align,
+    const void**         resultsOut,
+    const size_t         capacity
+) {
+    if (!capacity) {
+        return 0;
     }
-    exit(EXIT_FAILURE);
+
+    const auto find_all_pattern = [=]<hat::scan_alignment A>() {
+        const auto begin = static_cast<const std::byte*>(buffer);
+        const auto end = static_cast<const std::byte*>(buffer) + size;
+        return hat::find_all_pattern<A>(begin, end, write_to(resultsOut, capacity), to_view(signature));
+    };
+
+    return with_alignment(align, find_all_pattern);
+}
+
+LIBHAT_API size_t libhat_find_all_pattern_mod(
+    const signature_t*   signature,
+    const void*          module,
+    const char*          section,
+    const scan_alignment align,
+    const void**         resultsOut,
+    const size_t         capacity
+) {
+    const auto mod = hat::process::module_at(const_cast<void*>(module));
+    if (!mod.has_value()) {
+        return 0;
+    }
+    const auto data = hat::process::get_section_data(mod.value(), section);
+    return libhat_find_all_pattern(signature, data.data(), data.size(), align, resultsOut, capacity);
+}
+
+LIBHAT_API libhat_status_t libhat_find_patterns(
+    const signature_t* const* signatures,
+    const size_t              count,
+    const void*               buffer,
+    const size_t              size,
+    const scan_alignment      align,
+    const void**              resultsOut
+) {
+    const auto alignment = to_alignment(align);
+    if (!alignment) {
+        return libhat_err_unknown;
+    }
+
+    const auto views = to_views(signatures, count);
+    const auto begin = static_cast<const std::byte*>(buffer);
+    const auto end = static_cast<const std::byte*>(buffer) + size;
+    const auto results = hat::pattern_set{views, *alignment}.find_first(begin, end);
+    for (size_t i{}; i < count; i++) {
+        resultsOut[i] = results[i].get();
+    }
+    return libhat_success;
+}
+
+LIBHAT_API libhat_status_t libhat_find_patterns_mod(
+    const signature_t* const* signatures,
+    const size_t              count,
+    const void*               module,
+    const char*               section,
+    const scan_alignment      align,
+    const void**              resultsOut
+) {
+    const auto mod = hat::process::module_at(const_cast<void*>(module));
+    const auto data = mod.has_value()
+        ? hat::process::get_section_data(mod.value(), section)
+        : std::span<std::byte>{};
+    return libhat_find_patterns(signatures, count, data.data(), data.size(), align, resultsOut);
+}
+
+LIBHAT_API libhat_status_t libhat_compile_pattern(
+    const signature_t*   signature,
+    const scan_alignment align,
+    compiled_pattern_t** patternOut
+) {
+    const hat::signature_view view{
+        static_cast<hat::signature_element*>(signature->data),
+        signature->count
+    };
+
+    const auto alignment = to_alignment(align);
+    if (!alignment) {
+        *patternOut = nullptr;
+        return libhat_err_unknown;
+    }
+
+    *patternOut = reinterpret_cast<compiled_pattern_t*>(new hat::compiled_pattern{view, *alignment});
+    return libhat_success;
+}
+
+LIBHAT_API const void* libhat_find_compiled_pattern(
+    const compiled_pattern_t* pattern,
+    const void*               buffer,
+    const size_t              size
+) {
+    const auto& compiled = *reinterpret_cast<const hat::compiled_pattern*>(pattern);
+    const auto begin = static_cast<const std::byte*>(buffer);
+    const auto end = static_cast<const std::byte*>(buffer) + size;
+    const auto result = compiled.find(begin, end);
+    return result.has_result() ? result.get() : nullptr;
+}
+
+LIBHAT_API const void* libhat_find_compiled_pattern_mod(
+    const compiled_pattern_t* pattern,
+    const void*               module,
+    const char*               section
+) {
+    const auto& compiled = *reinterpret_cast<const hat::compiled_pattern*>(pattern);
+    const auto mod = hat::process::module_at(const_cast<void*>(module));
+    if (!mod.has_value()) {
+        return nullptr;
+    }
+    const auto result = compiled.find(section, mod.value());
+    return result.has_result() ? result.get() : nullptr;
+}
+
+LIBHAT_API size_t libhat_find_all_compiled_pattern(
+    const compiled_pattern_t* pattern,
+    const void*               buffer,
+    const size_t              size,
+    const void**              resultsOut,
+    const size_t              capacity
+) {
+    if (!capacity) {
+        return 0;
+    }
+
+    const auto& compiled = *reinterpret_cast<const hat::compiled_pattern*>(pattern);
+    const auto begin = static_cast<const std::byte*>(buffer);
+    const auto end = static_cast<const std::byte*>(buffer) + size;
+    return compiled.find_all(begin, end, write_to(resultsOut, capacity));
+}
+
+LIBHAT_API size_t libhat_find_all_compiled_pattern_mod(
+    const compiled_pattern_t* pattern,
+    const void*               module,
+    const char*               section,
+    const void**              resultsOut,
+    const size_t              capacity
+) {
+    const auto mod = hat::process::module_at(const_cast<void*>(module));
+    if (!mod.has_value()) {
+        return 0;
+    }
+    const auto data = hat::process::get_section_data(mod.value(), section);
+    return libhat_find_all_compiled_pattern(pattern, data.data(), data.size(), resultsOut, capacity);
+}
+
+LIBHAT_API void libhat_free_compiled_pattern(compiled_pattern_t* pattern) {
+    delete reinterpret_cast<hat::compiled_pattern*>(pattern);
 }
 
 LIBHAT_API const void* libhat_get_module(const char* name) {
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <elf.h>
+#include <link.h>
+
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace hat::detail {
+
+    using elf_header = ElfW(Ehdr);
+    using program_header = ElfW(Phdr);
+    using section_header = ElfW(Shdr);
+
+    /// A range of virtual addresses as they appear in an ELF file, before the module's load bias is applied
+    struct elf_range {
+        uintptr_t address;
+        size_t size;
+    };
+
+    /// Reads the program headers of the ELF file
+    inline std::vector<program_header> readFileSegments(const std::string& path) {
+        std::ifstream file{path, std::ios::binary};
+        if (!file) {
+            return {};
+        }
+
+        elf_header header{};
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.e_phoff == 0 || header.e_phentsize != sizeof(program_header)) {
+            return {};
+        }
+
+        std::vector<program_header> segments(header.e_phnum);
+        file.seekg(static_cast<std::streamoff>(header.e_phoff));
+        if (!file.read(reinterpret_cast<char*>(segments.data()), static_cast<std::streamsize>(segments.size() * sizeof(program_header)))) {
+            return {};
+        }
+        return segments;
+    }
+
+    /// Reads the section headers of the ELF file, as they aren't necessarily mapped into memory, and returns the range
+    /// of the allocated section with the given name
+    inline std::optional<elf_range> findFileSection(const std::string& path, const std::string_view name) {
+        std::ifstream file{path, std::ios::binary};
+        if (!file) {
+            return {};
+        }
+
+        elf_header header{};
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.e_shoff == 0 || header.e_shstrndx == SHN_UNDEF) {
+            return {};
+        }
+
+        std::vector<section_header> sections(header.e_shnum);
+        file.seekg(static_cast<std::streamoff>(header.e_shoff));
+        if (!file.read(reinterpret_cast<char*>(sections.data()), static_cast<std::streamsize>(sections.size() * sizeof(section_header)))) {
+            return {};
+        }
+
+        if (header.e_shstrndx >= sections.size()) {
+            return {};
+        }
+        const auto& strtab = sections[header.e_shstrndx];
+        std::string names(strtab.sh_size, '\0');
+        file.seekg(static_cast<std::streamoff>(strtab.sh_offset));
+        if (!file.read(names.data(), static_cast<std::streamsize>(names.size()))) {
+            return {};
+        }
+
+        for (const auto& section : sections) {
+            if (section.sh_name >= names.size() || !(section.sh_flags & SHF_ALLOC)) {
+                continue;
+            }
+            if (std::string_view{names.c_str() + section.sh_name} == name) {
+                return elf_range{static_cast<uintptr_t>(section.sh_addr), static_cast<size_t>(section.sh_size)};
+            }
+        }
+        return {};
+    }
+
+    /// Maps the PE section names used throughout the library onto the loadable segment with matching permissions
+    inline std::optional<elf_range> findSegment(const std::span<const program_header> phdrs, const std::string_view name) {
+        ElfW(Word) flags;
+        if (name == ".text") {
+            flags = PF_R | PF_X;
+        } else if (name == ".rdata") {
+            flags = PF_R;
+        } else if (name == ".data") {
+            flags = PF_R | PF_W;
+        } else {
+            return {};
+        }
+
+        for (const auto& phdr : phdrs) {
+            if (phdr.p_type == PT_LOAD && phdr.p_flags == flags) {
+                return elf_range{static_cast<uintptr_t>(phdr.p_vaddr), static_cast<size_t>(phdr.p_memsz)};
+            }
+        }
+        return {};
+    }
+}
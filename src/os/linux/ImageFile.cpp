@@ -0,0 +1,75 @@
+#include <libhat/Defines.hpp>
+#ifdef LIBHAT_LINUX
+
+#include <libhat/ImageFile.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <utility>
+
+namespace hat {
+
+    std::optional<image_file> image_file::open(const std::filesystem::path& path) {
+        const auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd == -1) {
+            return {};
+        }
+
+        struct stat info{};
+        if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+            ::close(fd);
+            return {};
+        }
+
+        // The mapping keeps a reference to the file, so the descriptor isn't needed after mapping it
+        const auto size = static_cast<size_t>(info.st_size);
+        const auto view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (view == MAP_FAILED) {
+            return {};
+        }
+
+        image_file image{};
+        image.view = static_cast<const std::byte*>(view);
+        image.size = size;
+        if (!image.parse()) {
+            return {};
+        }
+        return image;
+    }
+
+    image_file::image_file(image_file&& other) noexcept
+        : view(std::exchange(other.view, nullptr)),
+          size(std::exchange(other.size, 0)),
+          handle(std::exchange(other.handle, 0)),
+          fileFormat(other.fileFormat),
+          preferredBase(other.preferredBase),
+          sectionList(std::move(other.sectionList)),
+          ranges(std::move(other.ranges)) {}
+
+    image_file& image_file::operator=(image_file&& other) noexcept {
+        if (this != &other) {
+            if (this->view) {
+                munmap(const_cast<std::byte*>(this->view), this->size);
+            }
+            this->view = std::exchange(other.view, nullptr);
+            this->size = std::exchange(other.size, 0);
+            this->handle = std::exchange(other.handle, 0);
+            this->fileFormat = other.fileFormat;
+            this->preferredBase = other.preferredBase;
+            this->sectionList = std::move(other.sectionList);
+            this->ranges = std::move(other.ranges);
+        }
+        return *this;
+    }
+
+    image_file::~image_file() {
+        if (this->view) {
+            munmap(const_cast<std::byte*>(this->view), this->size);
+        }
+    }
+}
+#endif
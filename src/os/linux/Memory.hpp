@@ -0,0 +1,66 @@
+#pragma once
+
+#include <sys/mman.h>
+
+#include <charconv>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+namespace hat::detail {
+
+    struct memory_mapping {
+        uintptr_t begin;
+        uintptr_t end;
+        int prot;              // PROT_* flags of the mapping
+        uintptr_t offset;      // Offset of the mapping into the mapped file
+        std::string_view path; // Path of the mapped file, or a pseudo-path such as "[heap]", only valid during the callback
+    };
+
+    /// Invokes the callback with every mapping of the process's address space in ascending address order, until it
+    /// returns true. There is no API for querying the mappings, so they have to be read from the process's memory map,
+    /// which is "/proc/<pid>/maps" for other processes.
+    template<typename Fn>
+    bool forEachMapping(Fn&& fn, const std::string& file = "/proc/self/maps") {
+        std::ifstream maps{file};
+        std::string line;
+        while (std::getline(maps, line)) {
+            // Each line starts with "begin-end perms ...", where begin and end are in hexadecimal
+            uintptr_t begin{}, end{};
+            const auto* const lineEnd = line.data() + line.size();
+            const auto [sep, ec1] = std::from_chars(line.data(), lineEnd, begin, 16);
+            if (ec1 != std::errc{} || sep == lineEnd || *sep != '-') {
+                continue;
+            }
+            const auto [perms, ec2] = std::from_chars(sep + 1, lineEnd, end, 16);
+            if (ec2 != std::errc{} || lineEnd - perms < 5) {
+                continue;
+            }
+            int prot = PROT_NONE;
+            if (perms[1] == 'r') prot |= PROT_READ;
+            if (perms[2] == 'w') prot |= PROT_WRITE;
+            if (perms[3] == 'x') prot |= PROT_EXEC;
+
+            // The permissions are followed by the offset, device, inode, and the path padded with spaces
+            uintptr_t offset{};
+            const auto* field = perms + 5;
+            while (field != lineEnd && *field == ' ') field++;
+            std::from_chars(field, lineEnd, offset, 16);
+
+            std::string_view path{};
+            for (int i = 0; i < 3 && field != lineEnd; i++) {
+                while (field != lineEnd && *field != ' ') field++;
+                while (field != lineEnd && *field == ' ') field++;
+            }
+            if (field != lineEnd) {
+                path = {field, static_cast<size_t>(lineEnd - field)};
+            }
+
+            if (fn(memory_mapping{begin, end, prot, offset, path})) {
+                return true;
+            }
+        }
+        return false;
+    }
+}
@@ -0,0 +1,60 @@
+#include <libhat/Defines.hpp>
+#ifdef LIBHAT_LINUX
+
+#include <libhat/MemoryProtector.hpp>
+
+#include "Memory.hpp"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <utility>
+
+namespace hat {
+
+    static int ToPosixProt(const protection flags) {
+        int prot = PROT_NONE;
+        if (static_cast<bool>(flags & protection::Read))    prot |= PROT_READ;
+        if (static_cast<bool>(flags & protection::Write))   prot |= PROT_WRITE;
+        if (static_cast<bool>(flags & protection::Execute)) prot |= PROT_EXEC;
+        return prot;
+    }
+
+    // The old protection of an address which is in no mapping, in which case nothing is restored
+    static constexpr uint32_t UnknownProt = UINT32_MAX;
+
+    static uint32_t GetPosixProt(const uintptr_t address) {
+        uint32_t prot = UnknownProt;
+        detail::forEachMapping([&](const detail::memory_mapping& mapping) {
+            if (address >= mapping.begin && address < mapping.end) {
+                prot = static_cast<uint32_t>(mapping.prot);
+                return true;
+            }
+            return false;
+        });
+        return prot;
+    }
+
+    // mprotect operates on whole pages, so expand the region to the pages containing it
+    static std::pair<uintptr_t, size_t> PageRange(const uintptr_t address, const size_t size) {
+        const auto pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+        const auto begin = address & ~(pageSize - 1);
+        const auto end = (address + size + pageSize - 1) & ~(pageSize - 1);
+        return {begin, end - begin};
+    }
+
+    memory_protector::memory_protector(const uintptr_t address, const size_t size, const protection flags) : address(address), size(size) {
+        this->oldProtection = GetPosixProt(this->address);
+        const auto [page, length] = PageRange(this->address, this->size);
+        mprotect(reinterpret_cast<void*>(page), length, ToPosixProt(flags));
+    }
+
+    memory_protector::~memory_protector() {
+        if (this->oldProtection == UnknownProt) {
+            return;
+        }
+        const auto [page, length] = PageRange(this->address, this->size);
+        mprotect(reinterpret_cast<void*>(page), length, static_cast<int>(this->oldProtection));
+    }
+}
+#endif
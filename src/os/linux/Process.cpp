@@ -0,0 +1,172 @@
+#include <libhat/Defines.hpp>
+#ifdef LIBHAT_LINUX
+
+#include <libhat/Process.hpp>
+
+#include "Elf.hpp"
+#include "Memory.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <span>
+#include <vector>
+
+namespace hat::process {
+
+    using detail::elf_header;
+    using detail::program_header;
+
+    struct module_info {
+        uintptr_t base;  // Address of the ELF header, which is where the first loadable segment is mapped
+        uintptr_t bias;  // Difference between the virtual addresses in the ELF file and the mapped addresses
+        std::span<const program_header> phdrs;
+        std::string path;
+    };
+
+    template<typename Fn>
+    static bool forEachModule(Fn&& fn) {
+        const auto callback = [](dl_phdr_info* info, size_t, void* data) -> int {
+            const std::span<const program_header> phdrs{info->dlpi_phdr, info->dlpi_phnum};
+            const auto load = std::ranges::find(phdrs, static_cast<ElfW(Word)>(PT_LOAD), &program_header::p_type);
+            if (load == phdrs.end()) {
+                return 0;
+            }
+
+            const auto bias = static_cast<uintptr_t>(info->dlpi_addr);
+            const module_info mod{
+                .base = bias + static_cast<uintptr_t>(load->p_vaddr - load->p_offset),
+                .bias = bias,
+                .phdrs = phdrs,
+                // The main executable is reported without a name
+                .path = info->dlpi_name && *info->dlpi_name ? info->dlpi_name : "/proc/self/exe"
+            };
+            return (*static_cast<std::remove_reference_t<Fn>*>(data))(mod) ? 1 : 0;
+        };
+        return dl_iterate_phdr(callback, &fn) != 0;
+    }
+
+    static std::optional<module_info> findModule(const module_t mod) {
+        std::optional<module_info> result{};
+        forEachModule([&](const module_info& info) {
+            if (info.base == static_cast<uintptr_t>(mod)) {
+                result = info;
+                return true;
+            }
+            return false;
+        });
+        return result;
+    }
+
+    static bool isValidModule(const void* mod, const std::optional<size_t> size) {
+        if (size && *size < sizeof(elf_header)) {
+            return false;
+        }
+
+        const auto header = static_cast<const elf_header*>(mod);
+        if (std::memcmp(header->e_ident, ELFMAG, SELFMAG) != 0) {
+            return false;
+        }
+
+        const auto elfClass = sizeof(void*) == 8 ? ELFCLASS64 : ELFCLASS32;
+        return header->e_ident[EI_CLASS] == elfClass;
+    }
+
+    static protection fromPosixProt(const int prot) {
+        protection flags{};
+        if (prot & PROT_READ)  flags = flags | protection::Read;
+        if (prot & PROT_WRITE) flags = flags | protection::Write;
+        if (prot & PROT_EXEC)  flags = flags | protection::Execute;
+        return flags;
+    }
+
+    module_t get_process_module() {
+        // The first object reported by dl_iterate_phdr is always the main executable
+        module_t mod{};
+        forEachModule([&](const module_info& info) {
+            mod = module_t{info.base};
+            return true;
+        });
+        return mod;
+    }
+
+    std::optional<module_t> get_module(const std::string& name) {
+        std::optional<module_t> mod{};
+        forEachModule([&](const module_info& info) {
+            const auto slash = info.path.find_last_of('/');
+            const auto filename = slash == std::string::npos ? std::string_view{info.path} : std::string_view{info.path}.substr(slash + 1);
+            if (info.path == name || filename == name) {
+                mod = module_t{info.base};
+                return true;
+            }
+            return false;
+        });
+        return mod;
+    }
+
+    std::optional<module_t> module_at(void* address, std::optional<size_t> size) {
+        if (isValidModule(address, size)) {
+            return module_t{reinterpret_cast<uintptr_t>(address)};
+        }
+        return {};
+    }
+
+    std::span<std::byte> get_module_data(const module_t mod) {
+        const auto info = findModule(mod);
+        if (!info) {
+            return {};
+        }
+
+        uintptr_t end = info->base;
+        for (const auto& phdr : info->phdrs) {
+            if (phdr.p_type == PT_LOAD) {
+                end = std::max<uintptr_t>(end, info->bias + phdr.p_vaddr + phdr.p_memsz);
+            }
+        }
+        return {reinterpret_cast<std::byte*>(info->base), end - info->base};
+    }
+
+    std::span<std::byte> get_section_data(const module_t mod, const std::string_view name) {
+        const auto info = findModule(mod);
+        if (!info) {
+            return {};
+        }
+        auto section = detail::findFileSection(info->path, name);
+        if (!section) {
+            section = detail::findSegment(info->phdrs, name);
+        }
+        if (!section) {
+            return {};
+        }
+        return {reinterpret_cast<std::byte*>(info->bias + section->address), section->size};
+    }
+
+    std::vector<std::span<std::byte>> module_regions(const module_t mod, const protection flags) {
+        const auto data = get_module_data(mod);
+        const auto moduleBegin = reinterpret_cast<uintptr_t>(data.data());
+        const auto moduleEnd = moduleBegin + data.size();
+
+        // Every mapping is committed, the holes between the loadable segments are only reserved with PROT_NONE
+        std::vector<std::span<std::byte>> regions{};
+        detail::forEachMapping([&](const detail::memory_mapping& mapping) {
+            if (mapping.begin >= moduleEnd) {
+                return true;
+            }
+            const auto begin = std::max(mapping.begin, moduleBegin);
+            const auto end = std::min(mapping.end, moduleEnd);
+            const auto prot = fromPosixProt(mapping.prot);
+            if (begin < end && prot != protection{} && (prot & flags) == flags) {
+                auto* const first = reinterpret_cast<std::byte*>(begin);
+                auto* const last = reinterpret_cast<std::byte*>(end);
+                if (!regions.empty() && regions.back().data() + regions.back().size() == first) {
+                    regions.back() = {regions.back().data(), last};
+                } else {
+                    regions.emplace_back(first, last);
+                }
+            }
+            return false;
+        });
+        return regions;
+    }
+}
+#endif
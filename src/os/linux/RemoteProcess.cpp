@@ -0,0 +1,161 @@
+#include <libhat/Defines.hpp>
+#ifdef LIBHAT_LINUX
+
+#include <libhat/RemoteProcess.hpp>
+
+#include "Elf.hpp"
+#include "Memory.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <climits>
+#include <limits>
+#include <string>
+#include <utility>
+
+namespace hat {
+
+    static std::string procPath(const uint32_t pid, const std::string_view file) {
+        return "/proc/" + std::to_string(pid) + "/" + std::string{file};
+    }
+
+    // Finds the path of the file mapped at the module's base address
+    static std::optional<std::string> modulePath(const uint32_t pid, const process::module_t mod) {
+        std::optional<std::string> path{};
+        detail::forEachMapping([&](const detail::memory_mapping& mapping) {
+            if (mapping.begin == static_cast<uintptr_t>(mod)) {
+                if (mapping.offset == 0 && mapping.path.starts_with('/')) {
+                    path.emplace(mapping.path);
+                }
+                return true;
+            }
+            return false;
+        }, procPath(pid, "maps"));
+        return path;
+    }
+
+    // Finds the first mapping of the given file, which contains the ELF header. The predicate is given the full path.
+    template<typename Pred>
+    static std::optional<process::module_t> findModule(const uint32_t pid, Pred&& pred) {
+        std::optional<process::module_t> mod{};
+        detail::forEachMapping([&](const detail::memory_mapping& mapping) {
+            if (mapping.offset == 0 && mapping.path.starts_with('/') && pred(mapping.path)) {
+                mod = process::module_t{mapping.begin};
+                return true;
+            }
+            return false;
+        }, procPath(pid, "maps"));
+        return mod;
+    }
+
+    std::optional<remote_process> remote_process::open(const uint32_t pid) {
+        // The access check for reading the memory of another process is performed when the file is opened
+        const auto fd = ::open(procPath(pid, "mem").c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd == -1) {
+            return {};
+        }
+        return remote_process{pid, fd};
+    }
+
+    remote_process::remote_process(remote_process&& other) noexcept
+        : id(other.id), handle(std::exchange(other.handle, -1)) {}
+
+    remote_process& remote_process::operator=(remote_process&& other) noexcept {
+        if (this != &other) {
+            if (this->handle != -1) {
+                ::close(static_cast<int>(this->handle));
+            }
+            this->id = other.id;
+            this->handle = std::exchange(other.handle, -1);
+        }
+        return *this;
+    }
+
+    remote_process::~remote_process() {
+        if (this->handle != -1) {
+            ::close(static_cast<int>(this->handle));
+        }
+    }
+
+    bool remote_process::read(const uintptr_t address, const std::span<std::byte> buffer) const {
+        size_t total{};
+        while (total < buffer.size()) {
+            // The file offset is the virtual address, which may not be representable by a signed off_t
+            if (address + total > static_cast<uintptr_t>(std::numeric_limits<off_t>::max())) {
+                return false;
+            }
+            const auto count = ::pread(static_cast<int>(this->handle), buffer.data() + total, buffer.size() - total,
+                static_cast<off_t>(address + total));
+            if (count <= 0) {
+                return false;
+            }
+            total += static_cast<size_t>(count);
+        }
+        return true;
+    }
+
+    std::optional<process::module_t> remote_process::get_process_module() const {
+        char exe[PATH_MAX];
+        const auto length = ::readlink(procPath(this->id, "exe").c_str(), exe, sizeof(exe));
+        if (length <= 0) {
+            return {};
+        }
+        const std::string_view path{exe, static_cast<size_t>(length)};
+        return findModule(this->id, [&](const std::string_view mapped) {
+            return mapped == path;
+        });
+    }
+
+    std::optional<process::module_t> remote_process::get_module(const std::string& name) const {
+        return findModule(this->id, [&](const std::string_view path) {
+            const auto slash = path.find_last_of('/');
+            return path == name || path.substr(slash + 1) == name;
+        });
+    }
+
+    remote_region remote_process::get_module_data(const process::module_t mod) const {
+        const auto path = modulePath(this->id, mod);
+        if (!path) {
+            return {};
+        }
+
+        // The module extends to the end of the last mapping of its file, the anonymous mapping of .bss which may follow
+        // it isn't included
+        uintptr_t end{};
+        detail::forEachMapping([&](const detail::memory_mapping& mapping) {
+            if (mapping.begin >= static_cast<uintptr_t>(mod) && mapping.path == *path) {
+                end = mapping.end;
+            }
+            return false;
+        }, procPath(this->id, "maps"));
+        return {static_cast<uintptr_t>(mod), end - static_cast<uintptr_t>(mod)};
+    }
+
+    remote_region remote_process::get_section_data(const process::module_t mod, const std::string_view name) const {
+        const auto path = modulePath(this->id, mod);
+        if (!path) {
+            return {};
+        }
+
+        // The path is relative to the root directory of the remote process, which may be in another mount namespace
+        const auto file = procPath(this->id, "root") + *path;
+        const auto segments = detail::readFileSegments(file);
+        const auto load = std::ranges::find(segments, static_cast<ElfW(Word)>(PT_LOAD), &detail::program_header::p_type);
+        if (load == segments.end()) {
+            return {};
+        }
+        const auto bias = static_cast<uintptr_t>(mod) - static_cast<uintptr_t>(load->p_vaddr - load->p_offset);
+
+        auto section = detail::findFileSection(file, name);
+        if (!section) {
+            section = detail::findSegment(segments, name);
+        }
+        if (!section) {
+            return {};
+        }
+        return {bias + section->address, section->size};
+    }
+}
+#endif
@@ -0,0 +1,153 @@
+#include <libhat/Defines.hpp>
+#ifdef LIBHAT_LINUX
+
+#include <libhat/ScanBuffer.hpp>
+
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+namespace hat {
+
+    // Memory policy constants from <linux/mempolicy.h>, the syscalls are used directly to avoid depending on libnuma
+    static constexpr int MPOL_PREFERRED_ = 1;
+    static constexpr unsigned MPOL_F_NODE_ = 1 << 0;
+    static constexpr unsigned MPOL_F_ADDR_ = 1 << 1;
+
+    static constexpr size_t huge_page_size = 1 << 21; // 2 MiB, the PMD size on x86-64 and on arm64 with 4 KiB pages
+    static constexpr size_t max_nodes = 1024;
+
+    static size_t RoundUp(const size_t value, const size_t multiple) {
+        return (value + multiple - 1) / multiple * multiple;
+    }
+
+    // Parses a cpulist or nodelist from sysfs, e.g. "0-3,8-11", calling fn for every element
+    template<typename Fn>
+    static bool ForEachInList(const std::string& path, Fn&& fn) {
+        std::ifstream file{path};
+        std::string list{};
+        if (!std::getline(file, list)) {
+            return false;
+        }
+
+        const char* it = list.c_str();
+        while (*it) {
+            char* next{};
+            const auto first = std::strtoul(it, &next, 10);
+            if (next == it) {
+                break;
+            }
+            auto last = first;
+            if (*next == '-') {
+                it = next + 1;
+                last = std::strtoul(it, &next, 10);
+            }
+            for (auto i = first; i <= last; i++) {
+                fn(static_cast<uint32_t>(i));
+            }
+            it = *next == ',' ? next + 1 : next;
+        }
+        return true;
+    }
+
+    std::optional<scan_buffer> scan_buffer::allocate(const size_t size, const scan_buffer_options& options) {
+        if (options.node && *options.node >= max_nodes) {
+            return std::nullopt;
+        }
+
+        // Transparent huge pages are only used for huge page aligned ranges, so over-allocate and trim the mapping
+        const auto pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        const auto alignment = options.largePages ? huge_page_size : pageSize;
+        const auto length = RoundUp(std::max<size_t>(size, 1), alignment);
+        const auto reserved = length + (alignment - pageSize);
+
+        auto* mapped = static_cast<std::byte*>(mmap(nullptr, reserved, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+        if (mapped == MAP_FAILED) {
+            return std::nullopt;
+        }
+
+        const auto address = reinterpret_cast<uintptr_t>(mapped);
+        auto* aligned = reinterpret_cast<std::byte*>(RoundUp(address, alignment));
+        if (const auto head = static_cast<size_t>(aligned - mapped)) {
+            munmap(mapped, head);
+        }
+        if (const auto tail = static_cast<size_t>(mapped + reserved - (aligned + length))) {
+            munmap(aligned + length, tail);
+        }
+
+        scan_buffer buffer{};
+        buffer.memory = aligned;
+        buffer.length = size;
+        buffer.mapping = aligned;
+        buffer.mappingSize = length;
+
+        if (options.largePages) {
+            buffer.largePages = madvise(aligned, length, MADV_HUGEPAGE) == 0;
+        }
+
+        // The policy has to be set before the pages are first touched, they are placed on the node as they fault in
+        if (options.node) {
+            unsigned long mask[max_nodes / (8 * sizeof(unsigned long))]{};
+            mask[*options.node / (8 * sizeof(unsigned long))] = 1ul << (*options.node % (8 * sizeof(unsigned long)));
+            if (syscall(SYS_mbind, aligned, length, MPOL_PREFERRED_, mask, max_nodes, 0) != 0) {
+                // A kernel without NUMA support has every page on node 0
+                if (errno != ENOSYS || *options.node != 0) {
+                    return std::nullopt;
+                }
+            }
+            buffer.numaNode = options.node;
+        }
+        return buffer;
+    }
+
+    void scan_buffer::release() noexcept {
+        if (this->mapping) {
+            munmap(this->mapping, this->mappingSize);
+            this->mapping = nullptr;
+        }
+    }
+
+    size_t numa_node_count() {
+        static const size_t count = [] {
+            uint32_t highest{};
+            if (!ForEachInList("/sys/devices/system/node/online", [&](const uint32_t node) { highest = node; })) {
+                return size_t{1};
+            }
+            return static_cast<size_t>(highest) + 1;
+        }();
+        return count;
+    }
+
+    std::optional<uint32_t> numa_node_of(const void* address) {
+        int node{-1};
+        if (syscall(SYS_get_mempolicy, &node, nullptr, 0, address, MPOL_F_NODE_ | MPOL_F_ADDR_) != 0 || node < 0) {
+            return std::nullopt;
+        }
+        return static_cast<uint32_t>(node);
+    }
+}
+
+namespace hat::detail {
+
+    bool bind_thread_to_node(const uint32_t node) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        bool any{};
+        const auto path = "/sys/devices/system/node/node" + std::to_string(node) + "/cpulist";
+        ForEachInList(path, [&](const uint32_t cpu) {
+            if (cpu < CPU_SETSIZE) {
+                CPU_SET(cpu, &set);
+                any = true;
+            }
+        });
+        return any && sched_setaffinity(0, sizeof(set), &set) == 0;
+    }
+}
+#endif
@@ -0,0 +1,74 @@
+#include <libhat/Defines.hpp>
+#ifdef LIBHAT_LINUX
+
+#include <libhat/Scanner.hpp>
+#include <libhat/XrefIndex.hpp>
+
+namespace hat::experimental {
+
+    // Finds the first match of a pointer in any of the given sections, where pointers are always naturally aligned
+    static std::byte* find_pointer_in_sections(const signature_view signature, std::initializer_list<std::string_view> sections, hat::process::module_t mod) {
+        for (const auto section : sections) {
+            if (const auto result = find_pattern<pointer_alignment>(signature, section, mod).get()) {
+                return result;
+            }
+        }
+        return nullptr;
+    }
+
+    // Finds the lowest pointer to the target in the first of the given sections which has one
+    static std::byte* find_pointer_in_sections(const xref_index& index, const void* target, std::initializer_list<std::string_view> sections, hat::process::module_t mod) {
+        for (const auto section : sections) {
+            if (const auto result = index.find(target, xref_kind::pointer, process::get_section_data(mod, section)).get()) {
+                return result;
+            }
+        }
+        return nullptr;
+    }
+
+    static std::byte* find_type_name(const std::string& className, hat::process::module_t mod) {
+        std::string name = std::to_string(className.size()) + className;
+        name.push_back('\0');
+        return find_pattern(string_to_signature(name), ".rodata", mod).get();
+    }
+
+    template<>
+    scan_result find_vtable<compiler_type::GNU>(const std::string& className, hat::process::module_t mod) {
+        // Tracing cross-references
+        // Type Descriptor Name => Type Info => VTable
+        const auto typeName = find_type_name(className, mod);
+        if (!typeName) {
+            return nullptr;
+        }
+
+        // Type info and vtables require dynamic relocations in position independent executables, so they are placed in
+        // .data.rel.ro, otherwise the linker is free to put them alongside the type name in .rodata
+        auto typeInfo = find_pointer_in_sections(object_to_signature(typeName), {".data.rel.ro", ".rodata"}, mod);
+        if (!typeInfo) {
+            return nullptr;
+        }
+        // A single pointer is the offset from the type name pointer to the start of the type info
+        typeInfo -= sizeof(void*);
+
+        const auto vtable = find_pointer_in_sections(object_to_signature(typeInfo), {".data.rel.ro", ".rodata"}, mod);
+        return vtable ? vtable + sizeof(void*) : nullptr;
+    }
+
+    template<>
+    scan_result find_vtable<compiler_type::GNU>(const std::string& className, const xref_index& index, hat::process::module_t mod) {
+        const auto typeName = find_type_name(className, mod);
+        if (!typeName) {
+            return nullptr;
+        }
+
+        auto typeInfo = find_pointer_in_sections(index, typeName, {".data.rel.ro", ".rodata"}, mod);
+        if (!typeInfo) {
+            return nullptr;
+        }
+        typeInfo -= sizeof(void*);
+
+        const auto vtable = find_pointer_in_sections(index, typeInfo, {".data.rel.ro", ".rodata"}, mod);
+        return vtable ? vtable + sizeof(void*) : nullptr;
+    }
+}
+#endif
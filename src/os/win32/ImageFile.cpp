@@ -0,0 +1,82 @@
+#include <libhat/Defines.hpp>
+#ifdef LIBHAT_WINDOWS
+
+#include <libhat/ImageFile.hpp>
+
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+
+#include <utility>
+
+namespace hat {
+
+    std::optional<image_file> image_file::open(const std::filesystem::path& path) {
+        const auto file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return {};
+        }
+
+        LARGE_INTEGER fileSize{};
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0) {
+            CloseHandle(file);
+            return {};
+        }
+
+        // The mapping object keeps a reference to the file, so the file handle isn't needed after creating it
+        const auto mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (!mapping) {
+            return {};
+        }
+
+        const auto view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!view) {
+            CloseHandle(mapping);
+            return {};
+        }
+
+        image_file image{};
+        image.view = static_cast<const std::byte*>(view);
+        image.size = static_cast<size_t>(fileSize.QuadPart);
+        image.handle = reinterpret_cast<intptr_t>(mapping);
+        if (!image.parse()) {
+            return {};
+        }
+        return image;
+    }
+
+    image_file::image_file(image_file&& other) noexcept
+        : view(std::exchange(other.view, nullptr)),
+          size(std::exchange(other.size, 0)),
+          handle(std::exchange(other.handle, 0)),
+          fileFormat(other.fileFormat),
+          preferredBase(other.preferredBase),
+          sectionList(std::move(other.sectionList)),
+          ranges(std::move(other.ranges)) {}
+
+    image_file& image_file::operator=(image_file&& other) noexcept {
+        if (this != &other) {
+            if (this->view) {
+                UnmapViewOfFile(this->view);
+                CloseHandle(reinterpret_cast<HANDLE>(this->handle));
+            }
+            this->view = std::exchange(other.view, nullptr);
+            this->size = std::exchange(other.size, 0);
+            this->handle = std::exchange(other.handle, 0);
+            this->fileFormat = other.fileFormat;
+            this->preferredBase = other.preferredBase;
+            this->sectionList = std::move(other.sectionList);
+            this->ranges = std::move(other.ranges);
+        }
+        return *this;
+    }
+
+    image_file::~image_file() {
+        if (this->view) {
+            UnmapViewOfFile(this->view);
+            CloseHandle(reinterpret_cast<HANDLE>(this->handle));
+        }
+    }
+}
+#endif
@@ -7,9 +7,11 @@
 #define WIN32_LEAN_AND_MEAN
 #include <Windows.h>
 
+#include <algorithm>
 #include <bit>
 #include <string>
 #include <span>
+#include <vector>
 
 namespace hat::process {
 
@@ -41,6 +43,22 @@ namespace hat::process {
         return *reinterpret_cast<const IMAGE_NT_HEADERS*>(scanBytes + dosHeader->e_lfanew);
     }
 
+    static protection fromWinProt(const DWORD prot) {
+        if (prot & (PAGE_GUARD | PAGE_NOACCESS)) {
+            return protection{};
+        }
+        switch (prot & 0xFF) {
+            case PAGE_READONLY:          return protection::Read;
+            case PAGE_READWRITE:
+            case PAGE_WRITECOPY:         return protection::Read | protection::Write;
+            case PAGE_EXECUTE:           return protection::Execute;
+            case PAGE_EXECUTE_READ:      return protection::Read | protection::Execute;
+            case PAGE_EXECUTE_READWRITE:
+            case PAGE_EXECUTE_WRITECOPY: return protection::Read | protection::Write | protection::Execute;
+            default:                     return protection{};
+        }
+    }
+
     module_t get_process_module() {
         return module_t{reinterpret_cast<uintptr_t>(GetModuleHandleA(nullptr))};
     }
@@ -82,5 +100,36 @@ namespace hat::process {
         }
         return {};
     }
+
+    std::vector<std::span<std::byte>> module_regions(const module_t mod, const protection flags) {
+        auto* bytes = reinterpret_cast<std::byte*>(mod);
+        const auto& ntHeaders = getNTHeaders(mod);
+
+        std::vector<std::span<std::byte>> regions{};
+        const auto* sectionHeader = IMAGE_FIRST_SECTION(&ntHeaders);
+        for (int i = 0; i < ntHeaders.FileHeader.NumberOfSections; i++, sectionHeader++) {
+            auto* begin = bytes + sectionHeader->VirtualAddress;
+            auto* const end = begin + sectionHeader->Misc.VirtualSize;
+
+            // A section may span multiple allocations with different states, e.g. if part of it was protected
+            while (begin < end) {
+                MEMORY_BASIC_INFORMATION info;
+                if (!VirtualQuery(begin, &info, sizeof(info))) {
+                    break;
+                }
+                auto* const regionEnd = std::min(end, static_cast<std::byte*>(info.BaseAddress) + info.RegionSize);
+                const auto prot = fromWinProt(info.Protect);
+                if (info.State == MEM_COMMIT && prot != protection{} && (prot & flags) == flags) {
+                    if (!regions.empty() && regions.back().data() + regions.back().size() == begin) {
+                        regions.back() = {regions.back().data(), regionEnd};
+                    } else {
+                        regions.emplace_back(begin, regionEnd);
+                    }
+                }
+                begin = regionEnd;
+            }
+        }
+        return regions;
+    }
 }
 #endif
@@ -0,0 +1,158 @@
+#include <libhat/Defines.hpp>
+#ifdef LIBHAT_WINDOWS
+
+#include <libhat/RemoteProcess.hpp>
+
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#include <TlHelp32.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace hat {
+
+    // Invokes the callback with every module of the process, starting with the base executable, until it returns true
+    template<typename Fn>
+    static bool forEachModule(const uint32_t pid, Fn&& fn) {
+        const auto snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPMODULE | TH32CS_SNAPMODULE32, pid);
+        if (snapshot == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+
+        MODULEENTRY32 entry{};
+        entry.dwSize = sizeof(entry);
+        bool found = false;
+        for (auto valid = Module32First(snapshot, &entry); valid && !found; valid = Module32Next(snapshot, &entry)) {
+            found = fn(entry);
+        }
+        CloseHandle(snapshot);
+        return found;
+    }
+
+    template<typename T>
+    static std::optional<T> readObject(const remote_process& process, const uintptr_t address) {
+        T object{};
+        if (!process.read(address, {reinterpret_cast<std::byte*>(&object), sizeof(T)})) {
+            return {};
+        }
+        return object;
+    }
+
+    // The file header and the offset of SizeOfImage are identical in the PE32 and PE32+ formats, so the headers of a
+    // remote module can be read regardless of its bitness
+    static std::optional<std::pair<uintptr_t, IMAGE_NT_HEADERS>> readNTHeaders(const remote_process& process, const process::module_t mod) {
+        const auto base = static_cast<uintptr_t>(mod);
+        const auto dosHeader = readObject<IMAGE_DOS_HEADER>(process, base);
+        if (!dosHeader || dosHeader->e_magic != IMAGE_DOS_SIGNATURE) {
+            return {};
+        }
+        const auto address = base + static_cast<uintptr_t>(dosHeader->e_lfanew);
+        const auto ntHeaders = readObject<IMAGE_NT_HEADERS>(process, address);
+        if (!ntHeaders || ntHeaders->Signature != IMAGE_NT_SIGNATURE) {
+            return {};
+        }
+        return std::make_pair(address, *ntHeaders);
+    }
+
+    std::optional<remote_process> remote_process::open(const uint32_t pid) {
+        const auto handle = OpenProcess(PROCESS_VM_READ | PROCESS_QUERY_INFORMATION, FALSE, pid);
+        if (!handle) {
+            return {};
+        }
+        return remote_process{pid, reinterpret_cast<intptr_t>(handle)};
+    }
+
+    remote_process::remote_process(remote_process&& other) noexcept
+        : id(other.id), handle(std::exchange(other.handle, 0)) {}
+
+    remote_process& remote_process::operator=(remote_process&& other) noexcept {
+        if (this != &other) {
+            if (this->handle) {
+                CloseHandle(reinterpret_cast<HANDLE>(this->handle));
+            }
+            this->id = other.id;
+            this->handle = std::exchange(other.handle, 0);
+        }
+        return *this;
+    }
+
+    remote_process::~remote_process() {
+        if (this->handle) {
+            CloseHandle(reinterpret_cast<HANDLE>(this->handle));
+        }
+    }
+
+    bool remote_process::read(const uintptr_t address, const std::span<std::byte> buffer) const {
+        SIZE_T count{};
+        const auto success = ReadProcessMemory(
+            reinterpret_cast<HANDLE>(this->handle),
+            reinterpret_cast<LPCVOID>(address),
+            buffer.data(),
+            buffer.size(),
+            &count
+        );
+        return success && count == buffer.size();
+    }
+
+    std::optional<process::module_t> remote_process::get_process_module() const {
+        std::optional<process::module_t> mod{};
+        forEachModule(this->id, [&](const MODULEENTRY32& entry) {
+            mod = process::module_t{reinterpret_cast<uintptr_t>(entry.modBaseAddr)};
+            return true;
+        });
+        return mod;
+    }
+
+    std::optional<process::module_t> remote_process::get_module(const std::string& name) const {
+        std::optional<process::module_t> mod{};
+        forEachModule(this->id, [&](const MODULEENTRY32& entry) {
+            // Module names are case insensitive, like with GetModuleHandle
+            if (_stricmp(entry.szModule, name.c_str()) == 0 || _stricmp(entry.szExePath, name.c_str()) == 0) {
+                mod = process::module_t{reinterpret_cast<uintptr_t>(entry.modBaseAddr)};
+                return true;
+            }
+            return false;
+        });
+        return mod;
+    }
+
+    remote_region remote_process::get_module_data(const process::module_t mod) const {
+        const auto headers = readNTHeaders(*this, mod);
+        if (!headers) {
+            return {};
+        }
+        return {static_cast<uintptr_t>(mod), static_cast<size_t>(headers->second.OptionalHeader.SizeOfImage)};
+    }
+
+    remote_region remote_process::get_section_data(const process::module_t mod, const std::string_view name) const {
+        const auto headers = readNTHeaders(*this, mod);
+        if (!headers) {
+            return {};
+        }
+        const auto& [address, ntHeaders] = *headers;
+
+        std::vector<IMAGE_SECTION_HEADER> sections(ntHeaders.FileHeader.NumberOfSections);
+        const auto sectionTable = address + offsetof(IMAGE_NT_HEADERS, OptionalHeader) + ntHeaders.FileHeader.SizeOfOptionalHeader;
+        if (!this->read(sectionTable, {reinterpret_cast<std::byte*>(sections.data()), sections.size() * sizeof(IMAGE_SECTION_HEADER)})) {
+            return {};
+        }
+
+        const auto maxChars = std::min<size_t>(name.size(), 8);
+        for (const auto& section : sections) {
+            if (strncmp(name.data(), reinterpret_cast<const char*>(section.Name), maxChars) == 0) {
+                return {
+                    static_cast<uintptr_t>(mod) + section.VirtualAddress,
+                    static_cast<size_t>(section.Misc.VirtualSize)
+                };
+            }
+        }
+        return {};
+    }
+}
+#endif
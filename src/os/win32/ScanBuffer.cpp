@@ -0,0 +1,112 @@
+#include <libhat/Defines.hpp>
+#ifdef LIBHAT_WINDOWS
+
+#include <libhat/ScanBuffer.hpp>
+
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#include <Psapi.h>
+
+#include <algorithm>
+
+namespace hat {
+
+    static size_t RoundUp(const size_t value, const size_t multiple) {
+        return (value + multiple - 1) / multiple * multiple;
+    }
+
+    // Large pages can only be allocated with SeLockMemoryPrivilege enabled in the process token. The privilege has to
+    // be granted to the account for this to succeed, otherwise the allocation falls back to regular pages.
+    static bool EnableLockMemoryPrivilege() {
+        static const bool enabled = [] {
+            HANDLE token{};
+            if (!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token)) {
+                return false;
+            }
+
+            TOKEN_PRIVILEGES privileges{};
+            privileges.PrivilegeCount = 1;
+            privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+            bool result = LookupPrivilegeValueW(nullptr, SE_LOCK_MEMORY_NAME, &privileges.Privileges[0].Luid)
+                && AdjustTokenPrivileges(token, FALSE, &privileges, 0, nullptr, nullptr)
+                && GetLastError() == ERROR_SUCCESS;
+            CloseHandle(token);
+            return result;
+        }();
+        return enabled;
+    }
+
+    std::optional<scan_buffer> scan_buffer::allocate(const size_t size, const scan_buffer_options& options) {
+        const DWORD node = options.node ? static_cast<DWORD>(*options.node) : NUMA_NO_PREFERRED_NODE;
+        if (options.node && *options.node >= numa_node_count()) {
+            return std::nullopt;
+        }
+
+        scan_buffer buffer{};
+        buffer.length = size;
+        buffer.numaNode = options.node;
+
+        // Large pages are always committed and locked, so they can't be paged out and the size must be a multiple
+        const auto largePageSize = GetLargePageMinimum();
+        if (options.largePages && largePageSize && EnableLockMemoryPrivilege()) {
+            const auto length = RoundUp(std::max<size_t>(size, 1), largePageSize);
+            const auto flags = MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES;
+            if (auto* memory = VirtualAllocExNuma(GetCurrentProcess(), nullptr, length, flags, PAGE_READWRITE, node)) {
+                buffer.memory = static_cast<std::byte*>(memory);
+                buffer.mapping = buffer.memory;
+                buffer.mappingSize = length;
+                buffer.largePages = true;
+                return buffer;
+            }
+        }
+
+        auto* memory = VirtualAllocExNuma(GetCurrentProcess(), nullptr, std::max<size_t>(size, 1), MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE, node);
+        if (!memory) {
+            return std::nullopt;
+        }
+        buffer.memory = static_cast<std::byte*>(memory);
+        buffer.mapping = buffer.memory;
+        buffer.mappingSize = std::max<size_t>(size, 1);
+        return buffer;
+    }
+
+    void scan_buffer::release() noexcept {
+        if (this->mapping) {
+            VirtualFree(this->mapping, 0, MEM_RELEASE);
+            this->mapping = nullptr;
+        }
+    }
+
+    size_t numa_node_count() {
+        static const size_t count = [] {
+            ULONG highest{};
+            if (!GetNumaHighestNodeNumber(&highest)) {
+                return size_t{1};
+            }
+            return static_cast<size_t>(highest) + 1;
+        }();
+        return count;
+    }
+
+    std::optional<uint32_t> numa_node_of(const void* address) {
+        PSAPI_WORKING_SET_EX_INFORMATION info{};
+        info.VirtualAddress = const_cast<void*>(address);
+        if (!QueryWorkingSetEx(GetCurrentProcess(), &info, sizeof(info)) || !info.VirtualAttributes.Valid) {
+            return std::nullopt;
+        }
+        return static_cast<uint32_t>(info.VirtualAttributes.Node);
+    }
+}
+
+namespace hat::detail {
+
+    bool bind_thread_to_node(const uint32_t node) {
+        GROUP_AFFINITY affinity{};
+        if (!GetNumaNodeProcessorMaskEx(static_cast<USHORT>(node), &affinity) || !affinity.Mask) {
+            return false;
+        }
+        return SetThreadGroupAffinity(GetCurrentThread(), &affinity, nullptr);
+    }
+}
+#endif
@@ -2,50 +2,64 @@
 #ifdef LIBHAT_WINDOWS
 
 #include <libhat/Scanner.hpp>
+#include <libhat/XrefIndex.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
 
 namespace hat::experimental {
 
-    template<>
-    scan_result find_vtable<compiler_type::MSVC>(const std::string& className, hat::process::module_t mod) {
-        // Tracing cross-references
-        // Type Descriptor => Object Locator => VTable
+    // FIXME: These appear to be the values just for basic classes with single inheritance. We should be using a
+    //        different method to differentiate the object locator from the base class descriptor.
+    static constexpr std::array<std::byte, 12> locator_header{
+        #ifdef LIBHAT_X86_64
+        std::byte{0x01}, std::byte{0x00}, std::byte{0x00}, std::byte{0x00}, // signature
+        #else
+        std::byte{0x00}, std::byte{0x00}, std::byte{0x00}, std::byte{0x00}, // signature
+        #endif
+        std::byte{0x00}, std::byte{0x00}, std::byte{0x00}, std::byte{0x00}, // offset
+        std::byte{0x00}, std::byte{0x00}, std::byte{0x00}, std::byte{0x00}  // constructor displacement offset
+    };
+
+    // Finds the type descriptor of the class by its name, which precedes the name in the descriptor
+    static std::byte* find_type_descriptor(const std::string& className, hat::process::module_t mod) {
         auto sig = string_to_signature(".?AV" + className + "@@");
 
         // TODO: Have a better solution for this
         // 3rd character may be 'V' for classes and 'U' for structs
         sig[3] = {};
 
-        auto typeDesc = *find_pattern(sig, ".data", mod);
+        const auto typeDesc = find_pattern(sig, ".data", mod).get();
+        // 0x10 is the offset from the type descriptor name to the type descriptor header
+        return typeDesc ? typeDesc - 2 * sizeof(void*) : nullptr;
+    }
+
+    static std::byte* find_type_name(const std::string& className, hat::process::module_t mod) {
+        return find_pattern(string_to_signature(std::to_string(className.size()) + className + "\0"), ".rdata", mod).get();
+    }
+
+    template<>
+    scan_result find_vtable<compiler_type::MSVC>(const std::string& className, hat::process::module_t mod) {
+        // Tracing cross-references
+        // Type Descriptor => Object Locator => VTable
+        const auto typeDesc = find_type_descriptor(className, mod);
         if (!typeDesc) {
             return nullptr;
         }
-        // 0x10 is the offset from the type descriptor name to the type descriptor header
-        typeDesc -= 2 * sizeof(void*);
 
         // The actual xref refers to an offset from the base module
         const auto loffset = static_cast<uint32_t>(typeDesc - reinterpret_cast<std::byte*>(mod));
-        auto locator = object_to_signature(loffset);
-        // FIXME: These appear to be the values just for basic classes with single inheritance. We should be using a
-        //        different method to differentiate the object locator from the base class descriptor.
-        #ifdef LIBHAT_X86_64
-        locator.insert(locator.begin(), {
-            std::byte{0x01}, std::byte{0x00}, std::byte{0x00}, std::byte{0x00}, // signature
-            std::byte{0x00}, std::byte{0x00}, std::byte{0x00}, std::byte{0x00}, // offset
-            std::byte{0x00}, std::byte{0x00}, std::byte{0x00}, std::byte{0x00}  // constructor displacement offset
-        });
-        #else
-        locator.insert(locator.begin(), {
-            std::byte{0x00}, std::byte{0x00}, std::byte{0x00}, std::byte{0x00}, // signature
-            std::byte{0x00}, std::byte{0x00}, std::byte{0x00}, std::byte{0x00}, // offset
-            std::byte{0x00}, std::byte{0x00}, std::byte{0x00}, std::byte{0x00}  // constructor displacement offset
-        });
-        #endif
-        const auto objectLocator = *find_pattern(locator, ".rdata", mod);
+        small_signature<locator_header.size() + sizeof(loffset)> locator{};
+        locator.append(locator_header);
+        locator.append(std::bit_cast<std::array<std::byte, sizeof(loffset)>>(loffset));
+        // The fields of the object locator are 32-bit integers
+        const auto objectLocator = *find_pattern<scan_alignment::X4>(locator, ".rdata", mod);
         if (!objectLocator) {
             return nullptr;
         }
 
-        const auto vtable = *find_pattern(object_to_signature(objectLocator), ".data", mod);
+        const auto vtable = *find_pattern<pointer_alignment>(object_to_signature(objectLocator), ".data", mod);
         return vtable ? vtable + sizeof(void*) : nullptr;
     }
 
@@ -53,20 +67,65 @@ namespace hat::experimental {
     scan_result find_vtable<compiler_type::GNU>(const std::string& className, hat::process::module_t mod) {
         // Tracing cross-references
         // Type Descriptor Name => Type Info => VTable
-        const auto sig = string_to_signature(std::to_string(className.size()) + className + "\0");
-        const auto typeName = *find_pattern(sig, ".rdata", mod);
+        const auto typeName = find_type_name(className, mod);
         if (!typeName) {
             return nullptr;
         }
-        auto typeInfo = *find_pattern(object_to_signature(typeName), ".rdata", mod);
+        auto typeInfo = *find_pattern<pointer_alignment>(object_to_signature(typeName), ".rdata", mod);
         if (!typeInfo) {
             return nullptr;
         }
         // A single pointer is the offset from the type name pointer to the start of the type info
         typeInfo -= sizeof(void*);
 
-        const auto vtable = *find_pattern(object_to_signature(typeInfo), ".rdata", mod);
+        const auto vtable = *find_pattern<pointer_alignment>(object_to_signature(typeInfo), ".rdata", mod);
         return vtable ? vtable + sizeof(void*) : nullptr;
     }
+
+    template<>
+    scan_result find_vtable<compiler_type::MSVC>(const std::string& className, const xref_index& index, hat::process::module_t mod) {
+        const auto typeDesc = find_type_descriptor(className, mod);
+        if (!typeDesc) {
+            return nullptr;
+        }
+
+        // The type descriptor is referenced by an image offset at the end of the object locator's header
+        const auto rdata = process::get_section_data(mod, ".rdata");
+        std::byte* objectLocator{};
+        for (const auto& ref : index.references(typeDesc)) {
+            if (ref.kind != xref_kind::image_offset || ref.source < rdata.data() + locator_header.size()
+                || ref.source >= rdata.data() + rdata.size()) {
+                continue;
+            }
+            auto* const header = ref.source - locator_header.size();
+            if (std::equal(locator_header.begin(), locator_header.end(), header)) {
+                objectLocator = header;
+                break;
+            }
+        }
+        if (!objectLocator) {
+            return nullptr;
+        }
+
+        const auto vtable = index.find(objectLocator, xref_kind::pointer, process::get_section_data(mod, ".data"));
+        return vtable.has_result() ? vtable.get() + sizeof(void*) : nullptr;
+    }
+
+    template<>
+    scan_result find_vtable<compiler_type::GNU>(const std::string& className, const xref_index& index, hat::process::module_t mod) {
+        const auto typeName = find_type_name(className, mod);
+        if (!typeName) {
+            return nullptr;
+        }
+        const auto rdata = process::get_section_data(mod, ".rdata");
+        auto typeInfo = index.find(typeName, xref_kind::pointer, rdata).get();
+        if (!typeInfo) {
+            return nullptr;
+        }
+        typeInfo -= sizeof(void*);
+
+        const auto vtable = index.find(typeInfo, xref_kind::pointer, rdata);
+        return vtable.has_result() ? vtable.get() + sizeof(void*) : nullptr;
+    }
 }
 #endif
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+// AddressSanitizer places redzones between the globals of instrumented code, so a scan over a whole section of the test
+// executable reads bytes which it reports, even though the section is mapped and readable. The tests which scan their
+// own module skip themselves in such builds, the scanners are still covered on buffers by the other tests.
+#if defined(__SANITIZE_ADDRESS__)
+    #define LIBHAT_TEST_ASAN
+#elif defined(__has_feature)
+    #if __has_feature(address_sanitizer)
+        #define LIBHAT_TEST_ASAN
+    #endif
+#endif
+
+#if defined(LIBHAT_TEST_ASAN)
+    #define LIBHAT_TEST_REQUIRE_MODULE_SCAN() GTEST_SKIP() << "the sections of the module contain AddressSanitizer redzones"
+#else
+    #define LIBHAT_TEST_REQUIRE_MODULE_SCAN() static_cast<void>(0)
+#endif
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <libhat/Scanner.hpp>
+#include <libhat/Signature.hpp>
+
+// A scanner which is obviously correct, for testing the vectorized ones against. A match is accepted if every element
+// of the signature matches, and the first element that isn't a wildcard lies on the alignment boundary, because the
+// scanners skip the leading wildcards and align the remainder of the signature.
+namespace hat::test {
+
+    [[nodiscard]] inline size_t leading_wildcards(const signature_view signature) {
+        size_t count = 0;
+        while (count < signature.size() && signature[count].is_wildcard()) {
+            count++;
+        }
+        return count;
+    }
+
+    [[nodiscard]] inline bool reference_matches(const std::byte* candidate, const signature_view signature) {
+        for (size_t i = 0; i < signature.size(); i++) {
+            if (!signature[i].matches(candidate[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    [[nodiscard]] inline std::vector<const std::byte*> reference_find_all(
+        const std::span<const std::byte> range,
+        const signature_view             signature,
+        const scan_alignment             alignment
+    ) {
+        std::vector<const std::byte*> matches{};
+        if (signature.size() > range.size()) {
+            return matches;
+        }
+
+        const auto lead = leading_wildcards(signature);
+        const auto stride = static_cast<uintptr_t>(alignment);
+        for (size_t i = 0; i + signature.size() <= range.size(); i++) {
+            const auto candidate = range.data() + i;
+            if (reinterpret_cast<uintptr_t>(candidate + lead) % stride == 0 && reference_matches(candidate, signature)) {
+                matches.push_back(candidate);
+            }
+        }
+        return matches;
+    }
+}
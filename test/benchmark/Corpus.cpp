@@ -0,0 +1,326 @@
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <libhat/Process.hpp>
+#include <libhat/Scanner.hpp>
+
+// Unlike Compare.cpp, which measures the throughput of a pattern that never matches random bytes, these benchmarks
+// scan data resembling the machine code that signatures are usually written against. The leading bytes of most
+// signatures occur constantly in real code, so the throughput depends on how many candidates the anchor of the scan
+// lets through and how quickly each of them is rejected. Every benchmark reports the number of candidates per byte
+// and the number of candidates which failed verification, so that a change in the anchor selected by apply_hints
+// shows up in the counters as well as the timings.
+
+static constexpr size_t corpus_size = 1 << 24; // 16 MiB
+
+// Encodings of frequently used x86-64 instructions, where wildcards are filled with random operands
+static constexpr std::string_view instruction_templates[]{
+    "48 8B 05 ? ? ? ?",     // mov rax, [rip+rel32]
+    "48 8D 0D ? ? ? ?",     // lea rcx, [rip+rel32]
+    "48 8D 15 ? ? ? ?",     // lea rdx, [rip+rel32]
+    "E8 ? ? ? ?",           // call rel32
+    "FF 15 ? ? ? ?",        // call [rip+rel32]
+    "48 8B C8",             // mov rcx, rax
+    "48 8B D9",             // mov rbx, rcx
+    "4C 8B C0",             // mov r8, rax
+    "48 8B 4C 24 ?",        // mov rcx, [rsp+disp8]
+    "48 89 44 24 ?",        // mov [rsp+disp8], rax
+    "8B 4? ?",              // mov eax..edi, [rax..rdi+disp8]
+    "89 4? ?",              // mov [rax..rdi+disp8], eax..edi
+    "48 85 C0",             // test rax, rax
+    "84 C0",                // test al, al
+    "48 3B C1",             // cmp rax, rcx
+    "83 F8 ?",              // cmp eax, imm8
+    "74 ?",                 // je rel8
+    "75 ?",                 // jne rel8
+    "EB ?",                 // jmp rel8
+    "0F 84 ? ? ? ?",        // je rel32
+    "33 C0",                // xor eax, eax
+    "41 B8 ? ? ? ?",        // mov r8d, imm32
+    "C7 44 24 ? ? ? ? ?",   // mov dword [rsp+disp8], imm32
+    "0F B6 4?",             // movzx eax..edi, byte [rax..rdi]
+};
+
+static constexpr std::string_view prologue_template = "48 89 5C 24 08 57 48 83 EC ?";
+static constexpr std::string_view epilogue_template = "48 83 C4 ? 5F C3";
+
+// Appends the template to the buffer, filling the bits which aren't covered by the mask of each element randomly
+template<typename Gen>
+static void emit(std::vector<std::byte>& buffer, const hat::signature_view pattern, Gen& generator) {
+    std::uniform_int_distribution<uint32_t> distribution(0, 0xFF);
+    for (const auto& element : pattern) {
+        const auto random = static_cast<std::byte>(distribution(generator));
+        buffer.push_back(element.value() | (random & ~element.mask()));
+    }
+}
+
+// Generates an instruction stream laid out like the .text section of a compiled x86-64 binary, made of functions that
+// are aligned to 16 bytes and padded with int3. The seed is fixed, so every run scans the same bytes.
+static const std::vector<std::byte>& code_corpus() {
+    static const auto buffer = [] {
+        std::vector<hat::signature> instructions{};
+        for (const auto text : instruction_templates) {
+            instructions.push_back(hat::parse_signature(text).value());
+        }
+        const auto prologue = hat::parse_signature(prologue_template).value();
+        const auto epilogue = hat::parse_signature(epilogue_template).value();
+
+        std::default_random_engine generator(123);
+        std::uniform_int_distribution<size_t> pick(0, instructions.size() - 1);
+        std::uniform_int_distribution<size_t> length(4, 64);
+
+        std::vector<std::byte> buffer{};
+        buffer.reserve(corpus_size + 1024);
+        while (buffer.size() < corpus_size) {
+            emit(buffer, prologue, generator);
+            for (size_t count = length(generator); count; count--) {
+                emit(buffer, instructions[pick(generator)], generator);
+            }
+            emit(buffer, epilogue, generator);
+            while (buffer.size() % 16) {
+                buffer.push_back(std::byte{0xCC});
+            }
+        }
+        buffer.resize(corpus_size);
+        return buffer;
+    }();
+    return buffer;
+}
+
+static std::vector<std::byte> gen_random_buffer(const size_t size) {
+    std::vector<std::byte> buffer(size);
+    std::default_random_engine generator(123);
+    std::uniform_int_distribution<uint64_t> distribution(0, 0xFFFFFFFFFFFFFFFF);
+    for (size_t i = 0; i < buffer.size(); i += 8) {
+        const auto value = distribution(generator);
+        std::copy_n(reinterpret_cast<const std::byte*>(&value), std::min<size_t>(8, size - i), &buffer[i]);
+    }
+    return buffer;
+}
+
+struct candidate_counts {
+    size_t candidates{};
+    size_t matches{};
+};
+
+// Counts the positions at which the scanner resolved for the signature compares the full signature, and how many of
+// them actually match. Scans without a byte pair are anchored on the first byte, and aligned scans only consider
+// aligned positions.
+static candidate_counts count_candidates(
+    const std::span<const std::byte> data,
+    const hat::signature_view        signature,
+    const hat::scan_alignment        alignment,
+    const hat::scan_hint             hints
+) {
+    const auto [offset, trunc] = hat::detail::truncate(signature);
+    const auto context = hat::detail::scan_context::create(trunc, alignment, hints, data);
+    const auto stride = static_cast<size_t>(alignment);
+    const bool paired = alignment == hat::scan_alignment::X1 && context.pairIndex.has_value();
+    const auto first = paired ? *context.pairIndex : 0;
+    const auto second = first + context.pairDistance;
+
+    candidate_counts counts{};
+    if (data.size() < signature.size()) {
+        return counts;
+    }
+    for (size_t i = 0; i + signature.size() <= data.size(); i++) {
+        const auto candidate = data.data() + i + offset;
+        if (reinterpret_cast<uintptr_t>(candidate) % stride) {
+            continue;
+        }
+        const bool anchored = trunc[first].matches(candidate[first]) && (!paired || trunc[second].matches(candidate[second]));
+        if (!anchored) {
+            continue;
+        }
+        counts.candidates++;
+        if (std::equal(trunc.begin(), trunc.end(), candidate, [](auto e, auto b) { return e.matches(b); })) {
+            counts.matches++;
+        }
+    }
+    return counts;
+}
+
+// Reports the throughput over the bytes up to the end of the first match, or the entire data if the scan stops there
+static void report(benchmark::State& state, const std::span<const std::byte> data, const candidate_counts& counts, const hat::const_scan_result first = nullptr) {
+    const auto scanned = first.has_result()
+        ? static_cast<size_t>(first.get() - data.data())
+        : data.size();
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * scanned));
+    state.counters["candidates_per_byte"] = static_cast<double>(counts.candidates) / static_cast<double>(data.size());
+    state.counters["verify_misses"] = static_cast<double>(counts.candidates - counts.matches);
+    state.counters["matches"] = static_cast<double>(counts.matches);
+}
+
+// Signatures representative of the ones written against real code: a common instruction sequence that matches often,
+// one with leading wildcards, one whose first bytes are common but whose tail rarely matches, a function prologue that
+// is only matched at 16 byte boundaries, and a long signature taken from the corpus itself
+struct corpus_signature {
+    const char* name;
+    std::string pattern;
+    hat::scan_alignment alignment;
+};
+
+static std::string long_signature() {
+    // 96 bytes from the middle of the corpus, with the operands of every sixth byte left as wildcards
+    const auto& corpus = code_corpus();
+    std::string pattern{};
+    for (size_t i = 0; i < 96; i++) {
+        char byte[4];
+        std::snprintf(byte, sizeof(byte), "%02X ", static_cast<unsigned>(corpus[corpus.size() / 2 + i]));
+        pattern += i % 6 == 5 ? "? " : byte;
+    }
+    return pattern;
+}
+
+static const std::vector<corpus_signature>& corpus_signatures() {
+    static const std::vector<corpus_signature> signatures{
+        {"common",           "48 8B 05 ? ? ? ? 48 85 C0 74",           hat::scan_alignment::X1},
+        {"leading_wildcard", "? ? ? ? 48 8B 05 ? ? ? ? 48 85 C0 74",   hat::scan_alignment::X1},
+        {"rare_tail",        "48 8B C8 E8 ? ? ? ? 48 3B C1 0F 84",     hat::scan_alignment::X1},
+        {"prologue_x16",     "48 89 5C 24 08 57 48 83 EC 20",          hat::scan_alignment::X16},
+        {"long",             long_signature(),                         hat::scan_alignment::X1},
+    };
+    return signatures;
+}
+
+static void BM_Corpus_FindPattern(benchmark::State& state, const corpus_signature& sig, const hat::scan_hint hints) {
+    const auto& data = code_corpus();
+    const auto signature = hat::parse_signature(sig.pattern).value();
+    const auto counts = count_candidates(data, signature, sig.alignment, hints);
+
+    const auto scan = [&] {
+        return sig.alignment == hat::scan_alignment::X16
+            ? hat::find_pattern<hat::scan_alignment::X16>(data.begin(), data.end(), signature, hints)
+            : hat::find_pattern<hat::scan_alignment::X1>(data.begin(), data.end(), signature, hints);
+    };
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(scan());
+    }
+    report(state, data, counts, scan());
+}
+
+static void BM_Corpus_FindAll(benchmark::State& state, const corpus_signature& sig, const hat::scan_hint hints) {
+    const auto& data = code_corpus();
+    const auto signature = hat::parse_signature(sig.pattern).value();
+    const auto counts = count_candidates(data, signature, sig.alignment, hints);
+
+    std::vector<hat::const_scan_result> results(counts.matches + 1);
+    for (auto _ : state) {
+        const auto found = sig.alignment == hat::scan_alignment::X16
+            ? hat::find_all_pattern<hat::scan_alignment::X16>(data.begin(), data.end(), std::span{results}, signature, hints)
+            : hat::find_all_pattern<hat::scan_alignment::X1>(data.begin(), data.end(), std::span{results}, signature, hints);
+        benchmark::DoNotOptimize(found);
+    }
+    report(state, data, counts);
+}
+
+// Scans random bytes into which the anchor pair of the signature has been planted with the given density, in
+// candidates per million bytes, without ever completing a match. Each candidate costs a full verification.
+static void BM_CandidateDensity(benchmark::State& state) {
+    const auto sig = hat::compile_signature<"48 8B 05 ? ? ? ? 48 85 C0 74">();
+    auto data = gen_random_buffer(corpus_size);
+
+    std::default_random_engine generator(456);
+    std::bernoulli_distribution plant(static_cast<double>(state.range(0)) / 1e6);
+    for (size_t i = 0; i + 3 <= data.size(); i++) {
+        if (plant(generator)) {
+            data[i] = std::byte{0x48};
+            data[i + 1] = std::byte{0x8B};
+            data[i + 2] = std::byte{0x05};
+            i += 2;
+        }
+    }
+
+    const auto counts = count_candidates(data, sig, hat::scan_alignment::X1, hat::scan_hint::none);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(hat::find_pattern(data.cbegin(), data.cend(), sig));
+    }
+    report(state, data, counts);
+}
+
+// Measures the latency until the first match is found, including the setup of the scan, for a single match placed at
+// the given offset into a buffer that is much larger than the offset
+static void BM_FirstMatch(benchmark::State& state) {
+    const auto sig = hat::compile_signature<"48 8B 05 ? ? ? ? 48 85 C0 74">();
+    auto data = gen_random_buffer(corpus_size);
+
+    const auto offset = static_cast<size_t>(state.range(0));
+    constexpr std::byte match[]{
+        std::byte{0x48}, std::byte{0x8B}, std::byte{0x05}, std::byte{0x11}, std::byte{0x22}, std::byte{0x33},
+        std::byte{0x44}, std::byte{0x48}, std::byte{0x85}, std::byte{0xC0}, std::byte{0x74}
+    };
+    std::ranges::copy(match, data.begin() + static_cast<ptrdiff_t>(offset));
+
+    const auto expected = hat::find_pattern(data.cbegin(), data.cend(), sig);
+    if (expected.get() != data.data() + offset) {
+        state.SkipWithError("random data contains an earlier match");
+        return;
+    }
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(hat::find_pattern(data.cbegin(), data.cend(), sig));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * (offset + sizeof(match))));
+}
+
+// Scans the .text section of the benchmark itself, which unlike the generated corpus is real compiler output
+static void BM_ProcessText(benchmark::State& state, const hat::scan_hint hints) {
+    const std::span<const std::byte> text = hat::process::get_section_data(hat::process::get_process_module(), ".text");
+    if (text.empty()) {
+        state.SkipWithError(".text section not found");
+        return;
+    }
+    const auto sig = hat::compile_signature<"48 8B 05 ? ? ? ? 48 85 C0 74">();
+    const auto counts = count_candidates(text, sig, hat::scan_alignment::X1, hints);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(hat::find_pattern(text.begin(), text.end(), sig, hints));
+    }
+    report(state, text, counts, hat::find_pattern(text.begin(), text.end(), sig, hints));
+}
+
+static void register_corpus_benchmarks() {
+    constexpr std::pair<hat::scan_hint, const char*> hintSets[]{
+        {hat::scan_hint::none,    "none"},
+        {hat::scan_hint::x86_64,  "x86_64"},
+        {hat::scan_hint::measure, "measure"},
+    };
+
+    for (const auto& sig : corpus_signatures()) {
+        for (const auto& [hints, hintName] : hintSets) {
+            const auto suffix = std::string{sig.name} + "/" + hintName;
+            benchmark::RegisterBenchmark(("BM_Corpus_FindPattern/" + suffix).c_str(), [&sig, hints](benchmark::State& state) {
+                BM_Corpus_FindPattern(state, sig, hints);
+            })->UseRealTime();
+            benchmark::RegisterBenchmark(("BM_Corpus_FindAll/" + suffix).c_str(), [&sig, hints](benchmark::State& state) {
+                BM_Corpus_FindAll(state, sig, hints);
+            })->UseRealTime();
+        }
+    }
+
+    for (const auto& [hints, hintName] : hintSets) {
+        benchmark::RegisterBenchmark((std::string{"BM_ProcessText/"} + hintName).c_str(), [hints](benchmark::State& state) {
+            BM_ProcessText(state, hints);
+        })->UseRealTime();
+    }
+
+    benchmark::RegisterBenchmark("BM_CandidateDensity", BM_CandidateDensity)
+        ->Arg(0)->Arg(100)->Arg(1000)->Arg(10000)->Arg(50000)->UseRealTime();
+    benchmark::RegisterBenchmark("BM_FirstMatch", BM_FirstMatch)
+        ->Arg(0)->Arg(1 << 12)->Arg(1 << 16)->Arg(1 << 20)->Arg(corpus_size - 64)->UseRealTime();
+}
+
+int main(int argc, char** argv) {
+    register_corpus_benchmarks();
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
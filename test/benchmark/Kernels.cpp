@@ -0,0 +1,106 @@
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <libhat/CompiledPattern.hpp>
+#include <libhat/FixedPattern.hpp>
+#include <libhat/Scanner.hpp>
+
+// Measures every scanner on the same buffer, so that the modes can be compared on the system running the benchmark.
+// The signatures don't match anywhere in the buffer. The cmpeq2 variant anchors the scan on the leading byte pair,
+// while the veccmp variant, which lacks a leading pair and is scanned with scan_hint::pair0, only has its first byte.
+static constexpr std::string_view pair_pattern = "48 8B 05 ? ? ? ? 48 85 C0 74 ? 48 8B";
+static constexpr std::string_view single_pattern = "48 ? 05 ? ? ? ? 48 85 C0 74 ? 48 8B";
+
+static constexpr size_t buffer_size = 1 << 26; // 64 MiB
+
+static const std::vector<std::byte>& shared_buffer() {
+    static const auto buffer = [] {
+        std::vector<std::byte> buffer(buffer_size);
+        std::default_random_engine generator(123);
+        std::uniform_int_distribution<uint64_t> distribution(0, 0xFFFFFFFFFFFFFFFF);
+        for (size_t i = 0; i < buffer.size(); i += 8) {
+            *reinterpret_cast<uint64_t*>(&buffer[i]) = distribution(generator);
+        }
+        return buffer;
+    }();
+    return buffer;
+}
+
+static void BM_Kernel(benchmark::State& state, const hat::scan_mode mode, const hat::scan_alignment alignment, const bool cmpeq2) {
+    if (!hat::is_scan_mode_supported(mode)) {
+        state.SkipWithError("scan mode not supported");
+        return;
+    }
+
+    const auto& buf = shared_buffer();
+    const auto sig = hat::parse_signature(cmpeq2 ? pair_pattern : single_pattern).value();
+    const auto hints = cmpeq2 ? hat::scan_hint::none : hat::scan_hint::pair0;
+    const hat::compiled_pattern pattern{sig, alignment, hints, nullptr, mode};
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(pattern.find(buf.begin(), buf.end()));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * buf.size()));
+}
+
+// The literal variant scans for the cmpeq2 signature through the scanner specialized for it at compile time
+static void BM_Literal(benchmark::State& state, const hat::scan_mode mode) {
+    if (!hat::is_scan_mode_supported(mode)) {
+        state.SkipWithError("scan mode not supported");
+        return;
+    }
+
+    const auto& buf = shared_buffer();
+    hat::pin_scan_mode(mode);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(hat::find_pattern<"48 8B 05 ? ? ? ? 48 85 C0 74 ? 48 8B">(buf.begin(), buf.end()));
+    }
+    hat::pin_scan_mode(std::nullopt);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * buf.size()));
+}
+
+static void register_kernels() {
+    constexpr std::pair<hat::scan_mode, const char*> modes[]{
+        {hat::scan_mode::Single, "Single"},
+        {hat::scan_mode::SSE,    "SSE"},
+        {hat::scan_mode::AVX2,   "AVX2"},
+        {hat::scan_mode::AVX512, "AVX512"},
+        {hat::scan_mode::NEON,   "NEON"},
+        {hat::scan_mode::SVE2,   "SVE2"},
+    };
+    constexpr std::pair<hat::scan_alignment, const char*> alignments[]{
+        {hat::scan_alignment::X1,  "X1"},
+        {hat::scan_alignment::X8,  "X8"},
+        {hat::scan_alignment::X16, "X16"},
+    };
+
+    for (const auto& [mode, modeName] : modes) {
+        for (const auto& [alignment, alignmentName] : alignments) {
+            for (const bool cmpeq2 : {true, false}) {
+                const auto name = std::string{"BM_Kernel/"} + modeName + "/" + alignmentName + (cmpeq2 ? "/cmpeq2" : "/veccmp");
+                benchmark::RegisterBenchmark(name.c_str(), [=](benchmark::State& state) {
+                    BM_Kernel(state, mode, alignment, cmpeq2);
+                })
+                    ->Threads(1)->MinWarmUpTime(1)->MinTime(2)->UseRealTime();
+            }
+        }
+        const auto name = std::string{"BM_Kernel/"} + modeName + "/X1/literal";
+        benchmark::RegisterBenchmark(name.c_str(), [=](benchmark::State& state) {
+            BM_Literal(state, mode);
+        })
+            ->Threads(1)->MinWarmUpTime(1)->MinTime(2)->UseRealTime();
+    }
+}
+
+int main(int argc, char** argv) {
+    register_kernels();
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,114 @@
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <libhat/CompiledPattern.hpp>
+#include <libhat/Scanner.hpp>
+
+// Measures one-shot scans over buffers larger than the cache, with and without scan_hint::streaming. Between scans,
+// a co-running workload walks its working set of 1 MiB in a random order, the time it takes per load is reported as
+// the "walk" counter. The "hot" counter is the same walk without a scan in between, for reference.
+static constexpr std::string_view pattern = "48 8B 05 ? ? ? ? 48 85 C0 74 ? 48 8B";
+
+static constexpr size_t max_buffer_size = size_t{1} << 28; // 256 MiB
+static constexpr size_t working_set_size = size_t{1} << 20;
+
+static const std::vector<std::byte>& shared_buffer() {
+    static const auto buffer = [] {
+        std::vector<std::byte> buffer(max_buffer_size);
+        std::default_random_engine generator(123);
+        std::uniform_int_distribution<uint64_t> distribution(0, 0xFFFFFFFFFFFFFFFF);
+        for (size_t i = 0; i < buffer.size(); i += 8) {
+            *reinterpret_cast<uint64_t*>(&buffer[i]) = distribution(generator);
+        }
+        return buffer;
+    }();
+    return buffer;
+}
+
+// A single cycle through every element in a random order, so that the walk can't be prefetched
+static std::vector<uint32_t> make_working_set() {
+    std::vector<uint32_t> order(working_set_size / sizeof(uint32_t));
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), std::default_random_engine(456));
+
+    std::vector<uint32_t> next(order.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        next[order[i]] = order[(i + 1) % order.size()];
+    }
+    return next;
+}
+
+// Returns the time the walk took per load in nanoseconds
+static double walk(const std::vector<uint32_t>& next) {
+    const auto start = std::chrono::steady_clock::now();
+    uint32_t i{};
+    for (size_t n = 0; n < next.size(); n++) {
+        i = next[i];
+    }
+    benchmark::DoNotOptimize(i);
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / static_cast<double>(next.size());
+}
+
+static void BM_Streaming(benchmark::State& state, const hat::scan_mode mode, const bool streaming) {
+    if (!hat::is_scan_mode_supported(mode)) {
+        state.SkipWithError("scan mode not supported");
+        return;
+    }
+
+    const auto& buf = shared_buffer();
+    const auto size = static_cast<size_t>(state.range(0)) << 20;
+    const auto sig = hat::parse_signature(pattern).value();
+    const hat::compiled_pattern compiled{sig, hat::scan_alignment::X1, streaming ? hat::scan_hint::streaming : hat::scan_hint::none, nullptr, mode};
+
+    const auto workingSet = make_working_set();
+    double walkTotal{};
+    double hotTotal{};
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(compiled.find(buf.begin(), buf.begin() + static_cast<ptrdiff_t>(size)));
+
+        state.PauseTiming();
+        walkTotal += walk(workingSet);
+        hotTotal += walk(workingSet);
+        state.ResumeTiming();
+    }
+
+    const auto iterations = static_cast<double>(state.iterations());
+    state.counters["walk"] = walkTotal / iterations;
+    state.counters["hot"] = hotTotal / iterations;
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+}
+
+static void register_streaming() {
+    constexpr std::pair<hat::scan_mode, const char*> modes[]{
+        {hat::scan_mode::AVX2,   "AVX2"},
+        {hat::scan_mode::AVX512, "AVX512"},
+    };
+
+    for (const auto& [mode, modeName] : modes) {
+        for (const bool streaming : {false, true}) {
+            const auto name = std::string{"BM_Streaming/"} + modeName + (streaming ? "/streaming" : "/default");
+            benchmark::RegisterBenchmark(name.c_str(), [=](benchmark::State& state) {
+                BM_Streaming(state, mode, streaming);
+            })
+                ->RangeMultiplier(4)->Range(16, 256)->Threads(1)->MinWarmUpTime(1)->MinTime(2)->UseRealTime();
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    register_streaming();
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,86 @@
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include <libhat/CompiledPattern.hpp>
+#include <libhat/Scanner.hpp>
+
+#include "../Reference.hpp"
+
+// Scans the input with every supported scanner and aborts if any of them disagrees with the reference scanner. The
+// input is laid out as a byte selecting the alignment and hint, the length of the signature minus one, a value and
+// mask byte pair for every element of the signature, and the data that is scanned. The data is copied into a buffer
+// of its exact size, so that the sanitizers catch the scanners reading past the end of the range.
+namespace {
+
+    constexpr std::array modes{
+        hat::scan_mode::Single,
+        hat::scan_mode::SSE,
+        hat::scan_mode::AVX2,
+        hat::scan_mode::AVX512,
+        hat::scan_mode::NEON,
+        hat::scan_mode::SVE2,
+    };
+
+    constexpr std::array alignments{
+        hat::scan_alignment::X1,
+        hat::scan_alignment::X2,
+        hat::scan_alignment::X4,
+        hat::scan_alignment::X8,
+        hat::scan_alignment::X16,
+        hat::scan_alignment::X32,
+        hat::scan_alignment::X64,
+    };
+
+    constexpr std::array hints{
+        hat::scan_hint::none,
+        hat::scan_hint::x86_64,
+        hat::scan_hint::pair0,
+    };
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, const size_t size) {
+    if (size < 2) {
+        return 0;
+    }
+
+    const auto alignment = alignments[(data[0] & 0x7) % alignments.size()];
+    const auto hint = hints[(data[0] >> 3) % hints.size()];
+    const size_t length = data[1] + 1;
+    if (size < 2 + length * 2) {
+        return 0;
+    }
+
+    hat::signature signature{};
+    signature.reserve(length);
+    for (size_t i = 0; i < length; i++) {
+        signature.emplace_back(static_cast<std::byte>(data[2 + i * 2]), static_cast<std::byte>(data[3 + i * 2]));
+    }
+    if (hat::test::leading_wildcards(signature) == signature.size()) {
+        return 0;
+    }
+
+    const auto payload = data + 2 + length * 2;
+    const std::vector buffer(reinterpret_cast<const std::byte*>(payload), reinterpret_cast<const std::byte*>(data + size));
+    const auto expected = hat::test::reference_find_all(buffer, signature, alignment);
+
+    for (const auto mode : modes) {
+        if (!hat::is_scan_mode_supported(mode)) {
+            continue;
+        }
+
+        const hat::compiled_pattern pattern{signature, alignment, hint, nullptr, mode};
+        const auto first = pattern.find(buffer.begin(), buffer.end());
+        const auto all = pattern.find_all(buffer.begin(), buffer.end());
+        if (first.get() != (expected.empty() ? nullptr : expected.front()) || all.size() != expected.size()) {
+            std::abort();
+        }
+        for (size_t i = 0; i < all.size(); i++) {
+            if (all[i].get() != expected[i]) {
+                std::abort();
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,140 @@
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <libhat/Defines.hpp>
+#include <libhat/c/libhat.h>
+
+#include "../Module.hpp"
+
+// Read only data of the test executable which is looked up in its own module
+extern const std::array<uint8_t, 8> c_api_marker;
+alignas(8) const std::array<uint8_t, 8> c_api_marker{0xA7, 0x1E, 0x5C, 0xF3, 0x82, 0x4D, 0x09, 0xB6};
+
+namespace {
+
+    // The rodata section name of the platform
+#if defined(LIBHAT_WINDOWS)
+    constexpr const char* section = ".rdata";
+#else
+    constexpr const char* section = ".rodata";
+#endif
+
+    [[nodiscard]] signature_t* parse(const char* str) {
+        signature_t* signature{};
+        EXPECT_EQ(libhat_parse_signature(str, &signature), libhat_success);
+        return signature;
+    }
+
+    // A buffer with "11 22 33 44" at three offsets, of which only 32 is aligned to 16 bytes
+    class CApiTest : public testing::Test {
+    protected:
+        void SetUp() override {
+            for (const size_t offset : {5, 32, 70}) {
+                this->data[offset] = 0x11;
+                this->data[offset + 1] = 0x22;
+                this->data[offset + 2] = 0x33;
+                this->data[offset + 3] = 0x44;
+            }
+        }
+
+        alignas(64) std::array<uint8_t, 128> data{};
+    };
+}
+
+TEST(CApiSignatureTest, ReportsParseErrors) {
+    signature_t* signature = parse("11 ? 33");
+    ASSERT_NE(signature, nullptr);
+    EXPECT_EQ(signature->count, 3);
+    libhat_free(signature);
+
+    EXPECT_EQ(libhat_parse_signature("11 XY", &signature), libhat_err_sig_invalid);
+    EXPECT_EQ(signature, nullptr);
+    EXPECT_EQ(libhat_parse_signature("", &signature), libhat_err_sig_empty);
+    EXPECT_EQ(libhat_parse_signature("? ?", &signature), libhat_err_sig_nobyte);
+}
+
+TEST_F(CApiTest, CreatesSignatureFromMask) {
+    signature_t* signature{};
+    ASSERT_EQ(libhat_create_signature("\x11\x00\x33", "\x01\x00\x01", 3, &signature), libhat_success);
+    EXPECT_EQ(signature->count, 3);
+    EXPECT_EQ(libhat_find_pattern(signature, this->data.data(), this->data.size(), scan_alignment_x1), &this->data[5]);
+    libhat_free(signature);
+}
+
+TEST_F(CApiTest, FindsPatterns) {
+    signature_t* signature = parse("11 22 33 44");
+    EXPECT_EQ(libhat_find_pattern(signature, this->data.data(), this->data.size(), scan_alignment_x1), &this->data[5]);
+    EXPECT_EQ(libhat_find_pattern(signature, this->data.data(), this->data.size(), scan_alignment_x16), &this->data[32]);
+    EXPECT_EQ(libhat_find_pattern(signature, this->data.data(), this->data.size(), scan_alignment_x64), nullptr);
+
+    // The scan stops once the buffer is full
+    std::array<const void*, 3> results{};
+    EXPECT_EQ(libhat_find_all_pattern(signature, this->data.data(), this->data.size(), scan_alignment_x1, results.data(), 3), 3);
+    EXPECT_EQ(results[0], &this->data[5]);
+    EXPECT_EQ(results[1], &this->data[32]);
+    EXPECT_EQ(results[2], &this->data[70]);
+    EXPECT_EQ(libhat_find_all_pattern(signature, this->data.data(), this->data.size(), scan_alignment_x1, results.data(), 2), 2);
+    EXPECT_EQ(libhat_find_all_pattern(signature, this->data.data(), this->data.size(), scan_alignment_x2, results.data(), 3), 2);
+    EXPECT_EQ(libhat_find_all_pattern(signature, this->data.data(), this->data.size(), scan_alignment_x1, results.data(), 0), 0);
+    libhat_free(signature);
+}
+
+TEST_F(CApiTest, FindsPatternsInOnePass) {
+    std::array signatures{parse("11 22 33 44"), parse("33 44 00"), parse("55 66")};
+    std::array<const void*, 3> results{};
+    ASSERT_EQ(libhat_find_patterns(signatures.data(), signatures.size(), this->data.data(), this->data.size(), scan_alignment_x4, results.data()), libhat_success);
+    EXPECT_EQ(results[0], &this->data[32]);
+    EXPECT_EQ(results[1], &this->data[72]);
+    EXPECT_EQ(results[2], nullptr);
+    for (auto* signature : signatures) {
+        libhat_free(signature);
+    }
+}
+
+TEST_F(CApiTest, FindsCompiledPatterns) {
+    signature_t* signature = parse("11 22 ? 44");
+    compiled_pattern_t* pattern{};
+    ASSERT_EQ(libhat_compile_pattern(signature, scan_alignment_x8, &pattern), libhat_success);
+    libhat_free(signature);
+
+    EXPECT_EQ(libhat_find_compiled_pattern(pattern, this->data.data(), this->data.size()), &this->data[32]);
+    std::array<const void*, 3> results{};
+    EXPECT_EQ(libhat_find_all_compiled_pattern(pattern, this->data.data(), this->data.size(), results.data(), 3), 1);
+    EXPECT_EQ(results[0], &this->data[32]);
+    libhat_free_compiled_pattern(pattern);
+}
+
+TEST(CApiModuleTest, GetsProcessModule) {
+    const void* module = libhat_get_module(nullptr);
+    EXPECT_NE(module, nullptr);
+    EXPECT_EQ(libhat_get_module("libhat-does-not-exist"), module);
+}
+
+TEST(CApiModuleTest, FindsPatternsInModule) {
+    LIBHAT_TEST_REQUIRE_MODULE_SCAN();
+
+    const void* module = libhat_get_module(nullptr);
+    signature_t* signature = parse("A7 1E 5C F3 82 4D 09 B6");
+    EXPECT_EQ(libhat_find_pattern_mod(signature, module, section, scan_alignment_x8), c_api_marker.data());
+
+    std::array<const void*, 4> results{};
+    EXPECT_GE(libhat_find_all_pattern_mod(signature, module, section, scan_alignment_x1, results.data(), results.size()), 1);
+    EXPECT_EQ(results[0], c_api_marker.data());
+
+    const std::array<const signature_t*, 1> signatures{signature};
+    std::array<const void*, 1> first{};
+    ASSERT_EQ(libhat_find_patterns_mod(signatures.data(), 1, module, section, scan_alignment_x1, first.data()), libhat_success);
+    EXPECT_EQ(first[0], c_api_marker.data());
+
+    compiled_pattern_t* pattern{};
+    ASSERT_EQ(libhat_compile_pattern(signature, scan_alignment_x1, &pattern), libhat_success);
+    EXPECT_EQ(libhat_find_compiled_pattern_mod(pattern, module, section), c_api_marker.data());
+    EXPECT_GE(libhat_find_all_compiled_pattern_mod(pattern, module, section, results.data(), results.size()), 1);
+    EXPECT_EQ(results[0], c_api_marker.data());
+    EXPECT_EQ(libhat_find_compiled_pattern_mod(pattern, module, ".does-not-exist"), nullptr);
+
+    libhat_free_compiled_pattern(pattern);
+    libhat_free(signature);
+}
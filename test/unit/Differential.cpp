@@ -0,0 +1,315 @@
+#include <algorithm>
+#include <array>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <libhat/CompiledPattern.hpp>
+#include <libhat/FixedPattern.hpp>
+#include <libhat/Scanner.hpp>
+
+#include "../Reference.hpp"
+
+// Compares every scanner against the reference scanner. The buffers are filled from a small alphabet so that partial
+// matches are frequent, and the begin of the scanned range is moved across a whole vector, so that every candidate
+// position is covered by the "pre", vector and "post" parts of segment_scan in turn.
+namespace {
+
+    constexpr std::array modes{
+        hat::scan_mode::Single,
+        hat::scan_mode::SSE,
+        hat::scan_mode::AVX2,
+        hat::scan_mode::AVX512,
+        hat::scan_mode::NEON,
+        hat::scan_mode::SVE2,
+    };
+
+    constexpr std::array alignments{
+        hat::scan_alignment::X1,
+        hat::scan_alignment::X2,
+        hat::scan_alignment::X4,
+        hat::scan_alignment::X8,
+        hat::scan_alignment::X16,
+        hat::scan_alignment::X32,
+        hat::scan_alignment::X64,
+    };
+
+    constexpr std::array hints{
+        hat::scan_hint::none,
+        hat::scan_hint::x86_64,
+        hat::scan_hint::pair0,
+    };
+
+    // Sizes around the vector sizes of every scanner, and around the 256 bytes that are preloaded for the comparison
+    constexpr size_t boundary_sizes[]{
+        1, 2, 3, 4, 7, 8, 9, 15, 16, 17, 31, 32, 33, 63, 64, 65, 127, 128, 129, 255, 256, 257, 300
+    };
+
+    // A buffer whose data is aligned to 64 bytes, so that the offset of a range from a vector boundary is known
+    class aligned_buffer {
+    public:
+        explicit aligned_buffer(const size_t size) : storage(size + 64) {
+            const auto address = reinterpret_cast<uintptr_t>(this->storage.data());
+            this->base = this->storage.data() + (64 - address % 64) % 64;
+            this->length = size;
+        }
+
+        [[nodiscard]] std::byte* data() noexcept {
+            return this->base;
+        }
+
+        [[nodiscard]] size_t size() const noexcept {
+            return this->length;
+        }
+    private:
+        std::vector<std::byte> storage;
+        std::byte* base{};
+        size_t length{};
+    };
+
+    [[nodiscard]] std::string describe(const hat::signature_view signature, const hat::scan_alignment alignment, const hat::scan_hint hint) {
+        return "signature \"" + hat::to_string(signature)
+            + "\" alignment " + std::to_string(static_cast<int>(alignment))
+            + " hint " + std::to_string(static_cast<int>(hint));
+    }
+
+    // Compares find, find_all and count of a scanner against the reference in the range
+    void expect_reference(
+        const hat::compiled_pattern&     pattern,
+        const std::span<const std::byte> range,
+        const hat::signature_view        signature,
+        const hat::scan_alignment        alignment,
+        const hat::scan_hint             hint
+    ) {
+        const auto expected = hat::test::reference_find_all(range, signature, alignment);
+        const auto first = pattern.find(range.begin(), range.end());
+        const auto all = pattern.find_all(range.begin(), range.end());
+
+        SCOPED_TRACE(describe(signature, alignment, hint));
+        ASSERT_EQ(first.get(), expected.empty() ? nullptr : expected.front());
+        ASSERT_EQ(all.size(), expected.size());
+        for (size_t i = 0; i < all.size(); i++) {
+            ASSERT_EQ(all[i].get(), expected[i]) << "match " << i;
+        }
+        ASSERT_EQ(pattern.count(range.begin(), range.end()), expected.size());
+    }
+
+    [[nodiscard]] hat::signature_element random_element(std::mt19937& generator) {
+        const auto value = static_cast<std::byte>(generator() % 4);
+        switch (generator() % 8) {
+            case 0: return {};
+            case 1: return {value, std::byte{0x0F}};     // Nibble wildcard "?N"
+            case 2: return {value, std::byte{0xF3}};     // Bit mask
+            default: return value;
+        }
+    }
+
+    // A signature with optional leading and trailing wildcards, and solid segments separated by runs of wildcards of
+    // up to twice the size of the preloaded part
+    [[nodiscard]] hat::signature random_signature(std::mt19937& generator) {
+        hat::signature signature{};
+        signature.resize(generator() % 3);
+
+        const auto segments = generator() % 4 + 1;
+        for (size_t segment = 0; segment < segments; segment++) {
+            signature.push_back(static_cast<std::byte>(generator() % 4));
+            for (auto count = generator() % 6; count > 0; count--) {
+                signature.push_back(random_element(generator));
+            }
+            if (segment + 1 != segments) {
+                signature.resize(signature.size() + (generator() % 4 == 0 ? generator() % 512 : generator() % 8));
+            }
+        }
+        signature.resize(signature.size() + (generator() % 2 ? generator() % 40 : 0));
+        return signature;
+    }
+
+    [[nodiscard]] std::string mode_name(const hat::scan_mode mode) {
+        constexpr std::array names{"Single", "SSE", "AVX2", "AVX512", "NEON", "SVE2"};
+        return names[static_cast<size_t>(mode)];
+    }
+
+    // Pins the scan mode for the scanners of signature literals, which don't take a mode, while it is alive
+    class pinned_scan_mode {
+    public:
+        explicit pinned_scan_mode(const hat::scan_mode mode) {
+            hat::pin_scan_mode(mode);
+        }
+
+        pinned_scan_mode(const pinned_scan_mode&) = delete;
+        pinned_scan_mode& operator=(const pinned_scan_mode&) = delete;
+
+        ~pinned_scan_mode() {
+            hat::pin_scan_mode(std::nullopt);
+        }
+    };
+
+    // Compares the scanner specialized for a signature literal against the runtime scanner and the reference, on random
+    // buffers with the literal planted at random offsets of ranges at every misalignment of a vector
+    template<hat::fixed_string str, hat::scan_alignment alignment>
+    void expect_literal(std::mt19937& generator) {
+        constexpr auto signature = hat::compile_signature<str>();
+
+        for (size_t iteration = 0; iteration < 100; iteration++) {
+            aligned_buffer buffer(generator() % 1024 + signature.size());
+            for (size_t i = 0; i < buffer.size(); i++) {
+                buffer.data()[i] = static_cast<std::byte>(generator() % 4);
+            }
+            for (auto count = generator() % 4; count > 0; count--) {
+                const auto offset = generator() % (buffer.size() - signature.size() + 1);
+                for (size_t i = 0; i < signature.size(); i++) {
+                    auto& byte = buffer.data()[offset + i];
+                    byte = (byte & ~signature[i].mask()) | signature[i].value();
+                }
+            }
+
+            const auto misalignment = std::min<size_t>(iteration % 64, buffer.size());
+            const std::span<const std::byte> range{buffer.data() + misalignment, buffer.size() - misalignment};
+            const auto expected = hat::test::reference_find_all(range, signature, alignment);
+            const auto literal = hat::find_pattern<str, alignment>(range.begin(), range.end());
+            const auto runtime = hat::find_pattern<alignment>(range.begin(), range.end(), signature);
+
+            SCOPED_TRACE(describe(signature, alignment, hat::scan_hint::none));
+            ASSERT_EQ(literal.get(), expected.empty() ? nullptr : expected.front()) << "iteration " << iteration;
+            ASSERT_EQ(runtime.get(), literal.get()) << "iteration " << iteration;
+        }
+    }
+
+    template<hat::fixed_string str>
+    void expect_literal_alignments(std::mt19937& generator) {
+        // X16 and wider exceed the SSE and AVX2 vectors, which fall back to the single byte scanner
+        expect_literal<str, hat::scan_alignment::X1>(generator);
+        expect_literal<str, hat::scan_alignment::X2>(generator);
+        expect_literal<str, hat::scan_alignment::X4>(generator);
+        expect_literal<str, hat::scan_alignment::X8>(generator);
+        expect_literal<str, hat::scan_alignment::X16>(generator);
+        expect_literal<str, hat::scan_alignment::X32>(generator);
+        expect_literal<str, hat::scan_alignment::X64>(generator);
+    }
+
+    class DifferentialTest : public testing::TestWithParam<hat::scan_mode> {
+    protected:
+        void SetUp() override {
+            if (!hat::is_scan_mode_supported(GetParam())) {
+                GTEST_SKIP() << "scan mode not supported";
+            }
+        }
+    };
+}
+
+TEST_P(DifferentialTest, RandomSignatures) {
+    // Every mode is given the same sequence of inputs
+    std::mt19937 generator(11);
+
+    for (size_t iteration = 0; iteration < 2000; iteration++) {
+        const auto signature = random_signature(generator);
+        const auto alignment = alignments[generator() % alignments.size()];
+        const auto hint = hints[generator() % hints.size()];
+
+        aligned_buffer buffer(generator() % 4096 + 1);
+        for (size_t i = 0; i < buffer.size(); i++) {
+            buffer.data()[i] = static_cast<std::byte>(generator() % 4);
+        }
+
+        // Plant a few matches, so that the long signatures are found at all
+        for (auto count = generator() % 4; count > 0 && buffer.size() >= signature.size(); count--) {
+            const auto offset = generator() % (buffer.size() - signature.size() + 1);
+            for (size_t i = 0; i < signature.size(); i++) {
+                auto& byte = buffer.data()[offset + i];
+                byte = (byte & ~signature[i].mask()) | signature[i].value();
+            }
+        }
+
+        const auto misalignment = std::min<size_t>(generator() % 64, buffer.size());
+        const std::span<const std::byte> range{buffer.data() + misalignment, buffer.size() - misalignment};
+        const hat::compiled_pattern pattern{signature, alignment, hint, nullptr, GetParam()};
+        expect_reference(pattern, range, signature, alignment, hint);
+        if (HasFatalFailure()) {
+            return;
+        }
+    }
+}
+
+TEST_P(DifferentialTest, SegmentBoundaries) {
+    std::mt19937 generator(17);
+
+    for (const auto size : boundary_sizes) {
+        // The signature has a byte pair at each end, so that a pair is selected as the anchor, and only matches where
+        // it was placed, since the filler is zero and the signature never contains a zero
+        hat::signature signature(size);
+        for (size_t i = 0; i < size; i++) {
+            signature[i] = i < 2 || i + 2 >= size || generator() % 2
+                ? hat::signature_element{static_cast<std::byte>(generator() % 255 + 1)}
+                : hat::signature_element{};
+        }
+
+        for (const auto alignment : alignments) {
+            for (const auto hint : hints) {
+                const hat::compiled_pattern pattern{signature, alignment, hint, nullptr, GetParam()};
+                aligned_buffer buffer(size + 192);
+
+                // Place the match at every offset of a buffer that is barely larger than it, which moves it from the
+                // vectorized part into the parts before and after it
+                for (size_t offset = 0; offset + size <= buffer.size(); offset++) {
+                    std::fill_n(buffer.data(), buffer.size(), std::byte{});
+                    for (size_t i = 0; i < size; i++) {
+                        buffer.data()[offset + i] = signature[i].value();
+                    }
+
+                    for (const size_t misalignment : {0, 1, 15, 33}) {
+                        const std::span<const std::byte> range{buffer.data() + misalignment, buffer.size() - misalignment};
+                        expect_reference(pattern, range, signature, alignment, hint);
+                        if (HasFatalFailure()) {
+                            return;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST_P(DifferentialTest, RangeEnd) {
+    std::mt19937 generator(29);
+
+    // A match must fit into the range entirely, including its trailing wildcards, even if the scanner reads ahead
+    for (const auto size : boundary_sizes) {
+        hat::signature signature(size);
+        signature[0] = std::byte{0x01};
+        for (size_t i = 1; i < size; i++) {
+            signature[i] = generator() % 2 ? hat::signature_element{std::byte{0x01}} : hat::signature_element{};
+        }
+
+        aligned_buffer buffer(size + 128);
+        std::fill_n(buffer.data(), buffer.size(), std::byte{0x01});
+        for (const auto alignment : alignments) {
+            const hat::compiled_pattern pattern{signature, alignment, hat::scan_hint::none, nullptr, GetParam()};
+            for (size_t length = size - 1; length <= buffer.size(); length++) {
+                expect_reference(pattern, {buffer.data(), length}, signature, alignment, hat::scan_hint::none);
+                if (HasFatalFailure()) {
+                    return;
+                }
+            }
+        }
+    }
+}
+
+TEST_P(DifferentialTest, SignatureLiterals) {
+    const pinned_scan_mode pin{GetParam()};
+    ASSERT_EQ(hat::selected_scan_mode(), GetParam());
+    std::mt19937 generator(37);
+
+    // An exact pair at the start, nibble-masked and bit-masked first bytes with and without a later pair, leading
+    // wildcards, and signatures verified in several words, one of which is only wildcards
+    expect_literal_alignments<"01 02 ? ? 03">(generator);
+    expect_literal_alignments<"?1 ? 02 ?3">(generator);
+    expect_literal_alignments<"02&FE ? ? 01 03 00">(generator);
+    expect_literal_alignments<"? ? 03 ? 01 02">(generator);
+    expect_literal_alignments<"01 02 03 00 01 02 03 00 01 02 03 00 01 02 03 00 01 02 03">(generator);
+    expect_literal_alignments<"03 ? ? ? ? ? ? ? ? ? ? ? ? ? ? ? ? ? ? ? 02 01">(generator);
+}
+
+INSTANTIATE_TEST_SUITE_P(Scanner, DifferentialTest, testing::ValuesIn(modes), [](const auto& info) {
+    return mode_name(info.param);
+});
@@ -0,0 +1,125 @@
+#include <array>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <libhat/Scanner.hpp>
+
+#include "../Reference.hpp"
+
+namespace {
+
+    constexpr std::array modes{
+        hat::scan_mode::Single,
+        hat::scan_mode::SSE,
+        hat::scan_mode::AVX2,
+        hat::scan_mode::AVX512,
+        hat::scan_mode::NEON,
+        hat::scan_mode::SVE2,
+    };
+
+    constexpr std::array signatures{
+        "AA BB",
+        "AA ? BB",
+        "? ? AA BB ? CC",
+        "AA ? ? ? ? ? ? ? ? ? ? ? ? ? ? ? ? ? ? ? BB CC",
+    };
+
+    [[nodiscard]] std::string mode_name(const testing::TestParamInfo<hat::scan_mode>& info) {
+        constexpr std::array names{"Single", "SSE", "AVX2", "AVX512", "NEON", "SVE2"};
+        return names[static_cast<size_t>(info.param)];
+    }
+
+    // A buffer filled from a small alphabet, so that the signatures match at many positions
+    [[nodiscard]] std::vector<std::byte> make_buffer(const size_t size) {
+        std::mt19937 rng{1234};
+        std::uniform_int_distribution<int> dist{0, 2};
+        constexpr std::array alphabet{std::byte{0xAA}, std::byte{0xBB}, std::byte{0xCC}};
+        std::vector<std::byte> data(size);
+        for (auto& byte : data) {
+            byte = alphabet[dist(rng)];
+        }
+        return data;
+    }
+
+    // Runs every test once per supported scan mode, by pinning it for the scans resolved during the test
+    class FindAllTest : public testing::TestWithParam<hat::scan_mode> {
+    protected:
+        void SetUp() override {
+            if (!hat::is_scan_mode_supported(GetParam())) {
+                GTEST_SKIP() << "scan mode not supported";
+            }
+            hat::pin_scan_mode(GetParam());
+        }
+
+        void TearDown() override {
+            hat::pin_scan_mode(std::nullopt);
+        }
+
+        std::vector<std::byte> data = make_buffer(4096 + 13);
+    };
+}
+
+TEST_P(FindAllTest, CountsMatches) {
+    const std::span<const std::byte> range{this->data};
+    for (const auto str : signatures) {
+        const auto signature = hat::parse_signature(str).value();
+        EXPECT_EQ(hat::count_pattern(range.begin(), range.end(), signature),
+            hat::test::reference_find_all(range, signature, hat::scan_alignment::X1).size()) << str;
+        EXPECT_EQ(hat::count_pattern<hat::scan_alignment::X4>(range.begin(), range.end(), signature),
+            hat::test::reference_find_all(range, signature, hat::scan_alignment::X4).size()) << str;
+    }
+}
+
+TEST_P(FindAllTest, StopsWhenSpanIsFull) {
+    const std::span<const std::byte> range{this->data};
+    for (const auto str : signatures) {
+        const auto signature = hat::parse_signature(str).value();
+        const auto expected = hat::test::reference_find_all(range, signature, hat::scan_alignment::X1);
+
+        // Spans which are smaller than, exactly as large as and larger than the number of matches
+        for (const size_t capacity : {size_t{1}, expected.size() / 2, expected.size(), expected.size() + 5}) {
+            std::vector<hat::const_scan_result> results(capacity);
+            const auto written = hat::find_all_pattern(range.begin(), range.end(), std::span{results}, signature);
+            ASSERT_EQ(written, std::min(capacity, expected.size())) << str << " capacity " << capacity;
+            for (size_t i = 0; i < written; i++) {
+                EXPECT_EQ(results[i].get(), expected[i]) << str << " match " << i;
+            }
+        }
+
+        // Mutable input, which doesn't write into the span directly
+        std::vector<hat::scan_result> mutableResults(expected.size() / 2);
+        ASSERT_EQ(hat::find_all_pattern(this->data.begin(), this->data.end(), std::span{mutableResults}, signature), mutableResults.size());
+        for (size_t i = 0; i < mutableResults.size(); i++) {
+            EXPECT_EQ(mutableResults[i].get(), expected[i]) << str << " match " << i;
+        }
+    }
+}
+
+TEST_P(FindAllTest, CallbackStopsScan) {
+    const std::span<const std::byte> range{this->data};
+    for (const auto str : signatures) {
+        const auto signature = hat::parse_signature(str).value();
+        const auto expected = hat::test::reference_find_all(range, signature, hat::scan_alignment::X1);
+        ASSERT_GT(expected.size(), 3) << str;
+
+        // Returning false stops the scan after the match it was returned for
+        std::vector<const std::byte*> seen{};
+        const auto invoked = hat::find_all_pattern(range.begin(), range.end(), [&](const hat::const_scan_result result) {
+            seen.push_back(result.get());
+            return seen.size() < 3;
+        }, signature);
+        EXPECT_EQ(invoked, 3) << str;
+        EXPECT_EQ(seen, std::vector(expected.begin(), expected.begin() + 3)) << str;
+
+        // A callback without a result is invoked with every match
+        seen.clear();
+        EXPECT_EQ(hat::find_all_pattern(range.begin(), range.end(), [&](const hat::const_scan_result result) {
+            seen.push_back(result.get());
+        }, signature), expected.size()) << str;
+        EXPECT_EQ(seen, expected) << str;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Modes, FindAllTest, testing::ValuesIn(modes), mode_name);
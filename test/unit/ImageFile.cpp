@@ -0,0 +1,89 @@
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+
+#include <gtest/gtest.h>
+#include <libhat/Defines.hpp>
+#include <libhat/ImageFile.hpp>
+#include <libhat/Process.hpp>
+
+// Read only data of the test executable which is looked up in its file
+extern const std::array<uint8_t, 16> image_file_marker;
+const std::array<uint8_t, 16> image_file_marker{
+    0x8E, 0x3F, 0x51, 0xA6, 0x0C, 0xD7, 0x92, 0x4B, 0xE1, 0x75, 0x2A, 0xC8, 0x19, 0x6D, 0xB3, 0xF0
+};
+
+namespace {
+
+    constexpr std::string_view marker_signature = "8E 3F 51 A6 0C D7 92 4B E1 75 2A C8 19 6D B3 F0";
+
+    class ImageFileTest : public testing::Test {
+    protected:
+        void SetUp() override {
+#if defined(LIBHAT_LINUX)
+            this->path = std::filesystem::read_symlink("/proc/self/exe");
+#else
+            GTEST_SKIP() << "the path of the test executable is only known on Linux";
+#endif
+        }
+
+        std::filesystem::path path{};
+    };
+}
+
+TEST_F(ImageFileTest, RejectsOtherFiles) {
+    EXPECT_FALSE(hat::image_file::open(this->path.parent_path() / "does-not-exist").has_value());
+
+    const auto text = std::filesystem::temp_directory_path() / "libhat_image_file_test.txt";
+    std::ofstream{text} << "not an image file, but larger than the headers of one would be";
+    EXPECT_FALSE(hat::image_file::open(text).has_value());
+    std::filesystem::remove(text);
+}
+
+TEST_F(ImageFileTest, ParsesSections) {
+    const auto file = hat::image_file::open(this->path);
+    ASSERT_TRUE(file.has_value());
+    EXPECT_EQ(file->type(), hat::image_file::format::ELF);
+    EXPECT_EQ(file->data().size(), std::filesystem::file_size(this->path));
+
+    const auto text = std::ranges::find(file->sections(), ".text", &hat::image_section::name);
+    ASSERT_NE(text, file->sections().end());
+    EXPECT_FALSE(text->data.empty());
+    EXPECT_EQ(text->flags & hat::protection::Execute, hat::protection::Execute);
+    EXPECT_EQ(file->get_section_data(".text").data(), text->data.data());
+    EXPECT_TRUE(file->get_section_data(".does-not-exist").empty());
+
+    // The addresses of the section translate to the file and back
+    const auto offset = file->rva_to_offset(text->rva);
+    ASSERT_TRUE(offset.has_value());
+    EXPECT_EQ(file->data().data() + *offset, text->data.data());
+    EXPECT_EQ(file->offset_to_rva(*offset), text->rva);
+    EXPECT_EQ(file->at_rva(text->rva), text->data.data());
+    EXPECT_EQ(file->rva_of(text->data.data()), text->rva);
+    EXPECT_FALSE(file->rva_of(file->data().data() + file->data().size()).has_value());
+}
+
+TEST_F(ImageFileTest, FindsPatternAtLoadedAddress) {
+    const auto file = hat::image_file::open(this->path);
+    ASSERT_TRUE(file.has_value());
+
+    const auto signature = hat::parse_signature(marker_signature).value();
+    const auto result = file->find_pattern(signature, ".rodata");
+    ASSERT_TRUE(result.has_result());
+
+    // The match lies at the same address relative to the image base as the marker of the running executable
+    const auto base = static_cast<uintptr_t>(hat::process::get_process_module());
+    EXPECT_EQ(file->rva_of(result.get()), reinterpret_cast<uintptr_t>(image_file_marker.data()) - base);
+    EXPECT_FALSE(file->find_pattern(signature, ".does-not-exist").has_result());
+}
+
+TEST_F(ImageFileTest, MoveTransfersMapping) {
+    auto file = hat::image_file::open(this->path);
+    ASSERT_TRUE(file.has_value());
+    const auto data = file->data();
+
+    auto moved = std::move(*file);
+    EXPECT_EQ(moved.data().data(), data.data());
+    EXPECT_FALSE(moved.sections().empty());
+}
@@ -0,0 +1,172 @@
+#include <array>
+#include <chrono>
+#include <stop_token>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <libhat/Scanner.hpp>
+
+#include "../Reference.hpp"
+
+namespace {
+
+    // A stop condition which interrupts the scan at every poll, so that each call scans a single slice
+    struct always_stop {
+        [[nodiscard]] bool stop_requested() const noexcept {
+            return true;
+        }
+    };
+
+    // Signatures with and without leading wildcards, with matches placed across the slice boundaries of the buffer
+    constexpr std::array signatures{
+        "E8 ? ? ? ? 90",
+        "? ? E8 ? ? ? ? 90",
+        "? E8 ? ? ? ? 90 ? ?",
+    };
+
+    // A buffer of a few slices, with "E8 ? ? ? ? 90" placed just before, across and after every slice boundary
+    [[nodiscard]] std::vector<std::byte> make_buffer() {
+        constexpr size_t slice = hat::detail::scan_slice_size;
+        std::vector<std::byte> data(slice * 4 + 100);
+        for (size_t boundary = slice; boundary <= slice * 4; boundary += slice) {
+            for (const size_t offset : {boundary - 12, boundary - 3, boundary + 8, boundary + 64}) {
+                data[offset] = std::byte{0xE8};
+                data[offset + 5] = std::byte{0x90};
+            }
+        }
+        data[8] = std::byte{0xE8};
+        data[13] = std::byte{0x90};
+        return data;
+    }
+
+    // Collects every match by resuming find_pattern at the iterator it returns until the range is exhausted
+    template<hat::scan_alignment alignment, typename Stop>
+    [[nodiscard]] std::vector<const std::byte*> resume_find(const std::vector<std::byte>& data, const hat::signature_view signature, const Stop& stop) {
+        std::vector<const std::byte*> matches{};
+        auto it = data.begin();
+        for (size_t calls = 0; it != data.end(); calls++) {
+            if (calls > data.size()) {
+                ADD_FAILURE() << "the scan doesn't make progress";
+                break;
+            }
+            const auto [resume, result] = hat::find_pattern<alignment>(it, data.end(), signature, stop);
+            if (result.has_result()) {
+                matches.push_back(result.get());
+            }
+            EXPECT_GT(resume, it);
+            it = resume;
+        }
+        return matches;
+    }
+
+    // Collects every match by resuming find_all_pattern at the iterator it returns until the range is exhausted
+    template<hat::scan_alignment alignment, typename Stop>
+    [[nodiscard]] std::vector<const std::byte*> resume_find_all(const std::vector<std::byte>& data, const hat::signature_view signature, const Stop& stop) {
+        std::vector<hat::const_scan_result> results{};
+        auto it = data.begin();
+        for (size_t calls = 0; it != data.end(); calls++) {
+            if (calls > data.size()) {
+                ADD_FAILURE() << "the scan doesn't make progress";
+                break;
+            }
+            const auto [resume, out] = hat::find_all_pattern<alignment>(it, data.end(), std::back_inserter(results), signature, stop);
+            EXPECT_GT(resume, it);
+            it = resume;
+        }
+
+        std::vector<const std::byte*> matches{};
+        for (const auto result : results) {
+            matches.push_back(result.get());
+        }
+        return matches;
+    }
+
+    template<hat::scan_alignment alignment>
+    void expect_resumed_scans_match_reference() {
+        const auto data = make_buffer();
+        for (const auto str : signatures) {
+            const auto signature = hat::parse_signature(str).value();
+            const auto expected = hat::test::reference_find_all(data, signature, alignment);
+            ASSERT_FALSE(expected.empty()) << str;
+
+            EXPECT_EQ(resume_find<alignment>(data, signature, always_stop{}), expected) << str;
+            EXPECT_EQ(resume_find_all<alignment>(data, signature, always_stop{}), expected) << str;
+        }
+    }
+}
+
+TEST(InterruptibleTest, ResumedScansMatchReference) {
+    expect_resumed_scans_match_reference<hat::scan_alignment::X1>();
+    expect_resumed_scans_match_reference<hat::scan_alignment::X2>();
+    expect_resumed_scans_match_reference<hat::scan_alignment::X4>();
+}
+
+TEST(InterruptibleTest, ScansOneSlicePerCall) {
+    const auto data = make_buffer();
+    const auto signature = hat::parse_signature("? ? AB CD").value();
+
+    std::vector<hat::const_scan_result> results{};
+    const auto [resume, out] = hat::find_all_pattern(data.begin(), data.end(), std::back_inserter(results), signature, always_stop{});
+    EXPECT_EQ(resume, data.begin() + hat::detail::scan_slice_size);
+    EXPECT_TRUE(results.empty());
+
+    const auto [none, result] = hat::find_pattern(data.begin(), data.end(), signature, always_stop{});
+    EXPECT_EQ(none, data.begin() + hat::detail::scan_slice_size);
+    EXPECT_FALSE(result.has_result());
+}
+
+TEST(InterruptibleTest, StopConditions) {
+    const auto data = make_buffer();
+    const auto signature = hat::parse_signature("E8 ? ? ? ? 90").value();
+    const auto expected = hat::test::reference_find_all(data, signature, hat::scan_alignment::X1);
+
+    // A deadline that has passed interrupts after the first slice, one that hasn't scans the entire range
+    std::vector<hat::const_scan_result> results{};
+    const auto [expired, out] = hat::find_all_pattern(
+        data.begin(), data.end(), std::back_inserter(results), signature, hat::scan_deadline::after(std::chrono::seconds{-1}));
+    EXPECT_EQ(expired, data.begin() + hat::detail::scan_slice_size);
+
+    results.clear();
+    const auto [finished, _] = hat::find_all_pattern(
+        data.begin(), data.end(), std::back_inserter(results), signature, hat::scan_deadline::after(std::chrono::hours{1}));
+    EXPECT_EQ(finished, data.end());
+    ASSERT_EQ(results.size(), expected.size());
+
+    // A std::stop_token without a stop source never requests a stop
+    const auto [end, last] = hat::find_pattern(data.begin() + static_cast<ptrdiff_t>(expected.back() - data.data()),
+        data.end(), signature, std::stop_token{});
+    EXPECT_EQ(last.get(), expected.back());
+    EXPECT_EQ(end, data.begin() + (expected.back() - data.data()) + 1);
+}
+
+TEST(InterruptibleTest, SlicesOverlapBySignatureSize) {
+    const auto data = make_buffer();
+    const auto begin = data.data();
+    const auto end = data.data() + data.size();
+    constexpr size_t signature_size = 6;
+
+    std::vector<std::pair<const std::byte*, const std::byte*>> slices{};
+    const auto stopped = hat::detail::for_each_slice(begin, end, signature_size, std::stop_token{}, [&](const std::byte* sliceBegin, const std::byte* sliceEnd) {
+        slices.emplace_back(sliceBegin, sliceEnd);
+        return true;
+    });
+    EXPECT_EQ(stopped, end);
+
+    ASSERT_EQ(slices.size(), 5);
+    for (size_t i = 0; i < slices.size(); i++) {
+        EXPECT_EQ(slices[i].first, begin + i * hat::detail::scan_slice_size);
+        if (i + 1 < slices.size()) {
+            EXPECT_EQ(slices[i].second, slices[i + 1].first + signature_size - 1);
+        } else {
+            EXPECT_EQ(slices[i].second, end);
+        }
+    }
+
+    // The first slice is always scanned, the stop condition is polled before the others
+    size_t calls = 0;
+    EXPECT_EQ(hat::detail::for_each_slice(begin, end, signature_size, always_stop{}, [&](const std::byte*, const std::byte*) {
+        calls++;
+        return true;
+    }), begin + hat::detail::scan_slice_size);
+    EXPECT_EQ(calls, 1);
+}
@@ -0,0 +1,93 @@
+#include <charconv>
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <string>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+#include <libhat/MemoryProtector.hpp>
+
+namespace {
+
+    // Returns the "rwx" permissions of the mapping containing the address from /proc/self/maps, if there is one
+    [[nodiscard]] std::optional<std::string> permissions(const void* address) {
+        const auto target = reinterpret_cast<uintptr_t>(address);
+        std::ifstream maps{"/proc/self/maps"};
+        std::string line;
+        while (std::getline(maps, line)) {
+            uintptr_t begin{}, end{};
+            const auto [sep, ec1] = std::from_chars(line.data(), line.data() + line.size(), begin, 16);
+            const auto [perms, ec2] = std::from_chars(sep + 1, line.data() + line.size(), end, 16);
+            if (ec1 == std::errc{} && ec2 == std::errc{} && target >= begin && target < end) {
+                return std::string{perms + 1, 3};
+            }
+        }
+        return std::nullopt;
+    }
+
+    // Two pages of anonymous memory with the given protection, which are unmapped on destruction
+    class mapped_pages {
+    public:
+        explicit mapped_pages(const int prot) {
+            this->memory = static_cast<std::byte*>(mmap(nullptr, this->size, prot, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+        }
+
+        mapped_pages(const mapped_pages&) = delete;
+        mapped_pages& operator=(const mapped_pages&) = delete;
+
+        ~mapped_pages() {
+            munmap(this->memory, this->size);
+        }
+
+        [[nodiscard]] std::byte* page(const size_t index) const {
+            return this->memory + index * page_size;
+        }
+
+        static inline const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    private:
+        size_t size = page_size * 2;
+        std::byte* memory{};
+    };
+}
+
+TEST(MemoryProtectorTest, ProtectsAndRestoresPages) {
+    const mapped_pages pages{PROT_READ};
+    ASSERT_EQ(permissions(pages.page(0)), "r--");
+    {
+        // The protection applies to every page the region touches, and only to those
+        const hat::memory_protector protector{reinterpret_cast<uintptr_t>(pages.page(0) + 10), 5, hat::protection::Read | hat::protection::Write};
+        EXPECT_EQ(permissions(pages.page(0)), "rw-");
+        EXPECT_EQ(permissions(pages.page(1)), "r--");
+        pages.page(0)[12] = std::byte{0xCC};
+    }
+    EXPECT_EQ(permissions(pages.page(0)), "r--");
+    EXPECT_EQ(pages.page(0)[12], std::byte{0xCC});
+}
+
+TEST(MemoryProtectorTest, RestoresExecutablePages) {
+    const mapped_pages pages{PROT_READ | PROT_EXEC};
+    {
+        const hat::memory_protector protector{reinterpret_cast<uintptr_t>(pages.page(0)), mapped_pages::page_size * 2, hat::protection::Read | hat::protection::Write};
+        EXPECT_EQ(permissions(pages.page(0)), "rw-");
+        EXPECT_EQ(permissions(pages.page(1)), "rw-");
+    }
+    EXPECT_EQ(permissions(pages.page(0)), "r-x");
+    EXPECT_EQ(permissions(pages.page(1)), "r-x");
+}
+
+TEST(MemoryProtectorTest, LeavesUnmappedRegionsAlone) {
+    // Without a mapping at construction there is no protection to restore, so memory which is mapped at the address
+    // in the meantime keeps its own protection
+    const auto page = static_cast<std::byte*>(mmap(nullptr, mapped_pages::page_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    ASSERT_EQ(munmap(page, mapped_pages::page_size), 0);
+    ASSERT_FALSE(permissions(page).has_value());
+    {
+        const hat::memory_protector protector{reinterpret_cast<uintptr_t>(page), 1, hat::protection::Read};
+        ASSERT_EQ(mmap(page, mapped_pages::page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0), page);
+    }
+    EXPECT_EQ(permissions(page), "rw-");
+    munmap(page, mapped_pages::page_size);
+}
@@ -0,0 +1,64 @@
+#include <execution>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <libhat/Scanner.hpp>
+
+namespace {
+
+    [[nodiscard]] hat::signature parse(const std::string_view str) {
+        return hat::parse_signature(str).value();
+    }
+
+    // Size of the chunks the parallel scans are split into
+    constexpr size_t chunk_size = 1 << 20;
+
+    // A buffer of a few chunks which contains the signature "11 22 33 44" at the given offsets
+    [[nodiscard]] std::vector<std::byte> make_buffer(const std::vector<size_t>& offsets) {
+        std::vector<std::byte> data(chunk_size * 3 + 100);
+        for (const auto offset : offsets) {
+            data[offset + 0] = std::byte{0x11};
+            data[offset + 1] = std::byte{0x22};
+            data[offset + 2] = std::byte{0x33};
+            data[offset + 3] = std::byte{0x44};
+        }
+        return data;
+    }
+}
+
+TEST(ParallelTest, FindsFirstMatch) {
+    const auto signature = parse("11 22 33 44");
+
+    // The match in the earlier chunk wins even though a later chunk may be scanned first
+    for (const size_t first : {size_t{5}, chunk_size - 2, chunk_size * 2 + 7}) {
+        const auto data = make_buffer({first, chunk_size * 3 + 50});
+        const auto result = hat::find_pattern(std::execution::par, data.begin(), data.end(), signature);
+        EXPECT_EQ(result.get(), data.data() + first) << "offset " << first;
+    }
+
+    const auto none = make_buffer({});
+    EXPECT_FALSE(hat::find_pattern(std::execution::par, none.begin(), none.end(), signature).has_result());
+}
+
+TEST(ParallelTest, FindsAllMatchesAcrossChunks) {
+    // Matches straddling the chunk boundaries are reported once, by the chunk they begin in
+    const std::vector<size_t> offsets{0, 100, chunk_size - 8, chunk_size - 1, chunk_size * 2 - 2, chunk_size * 3 + 96};
+    const auto data = make_buffer(offsets);
+    const auto signature = parse("? 22 33 44");
+
+    const auto results = hat::find_all_pattern(std::execution::par_unseq, data.begin(), data.end(), signature);
+    const auto expected = hat::find_all_pattern(data.begin(), data.end(), signature);
+    ASSERT_EQ(results.size(), offsets.size());
+    ASSERT_EQ(results.size(), expected.size());
+    for (size_t i = 0; i < results.size(); i++) {
+        EXPECT_EQ(results[i].get(), data.data() + offsets[i]);
+        EXPECT_EQ(results[i].get(), expected[i].get());
+    }
+}
+
+TEST(ParallelTest, SequencedPolicyScansInline) {
+    const auto data = make_buffer({chunk_size + 1});
+    const auto signature = parse("11 22 33 44");
+    EXPECT_EQ(hat::find_pattern(std::execution::seq, data.begin(), data.end(), signature).get(), data.data() + chunk_size + 1);
+    EXPECT_EQ(hat::find_all_pattern(std::execution::seq, data.begin(), data.end(), signature).size(), 1);
+}
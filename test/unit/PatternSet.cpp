@@ -0,0 +1,94 @@
+#include <array>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <libhat/PatternSet.hpp>
+#include <libhat/Scanner.hpp>
+
+#include "../Reference.hpp"
+
+namespace {
+
+    [[nodiscard]] hat::signature parse(const std::string_view str) {
+        return hat::parse_signature(str).value();
+    }
+}
+
+TEST(PatternSetTest, AnchorOnLastByteOfInput) {
+    // The only exact byte of the signature is its last one, so the anchor is a single byte which may be the last byte
+    // of the input, where there is no second byte to form a pair with
+    const auto signature = parse("4? 02");
+    const std::array<hat::signature_view, 1> signatures{signature};
+    const hat::pattern_set set{signatures};
+
+    // Inputs of up to a few vectors, so that the end is reached by both the vectorized and the per byte candidate scan
+    for (size_t size = 2; size <= 200; size++) {
+        std::vector<std::byte> data(size);
+        data[size - 2] = std::byte{0x41};
+        data[size - 1] = std::byte{0x02};
+
+        const auto results = set.find_first(data.begin(), data.end());
+        ASSERT_EQ(results.size(), 1);
+        ASSERT_EQ(results[0].get(), &data[size - 2]) << "size " << size;
+        ASSERT_EQ(results[0].get(), hat::find_pattern(data.begin(), data.end(), signature).get());
+    }
+}
+
+TEST(PatternSetTest, MatchesFindPattern) {
+    std::mt19937 generator(5);
+    std::vector<std::byte> data(4096);
+    for (auto& byte : data) {
+        byte = static_cast<std::byte>(generator() % 4);
+    }
+
+    // Signatures anchored on a pair, on a single byte in the middle, and at the end, with and without leading wildcards
+    std::vector<hat::signature> signatures{};
+    for (const auto str : {"01 02 03", "? 00 ? 01", "1? ? 03 ? ?", "03", "? ? 02 02 02 02", "?1 ?2 ?3 00", "00 ? ? ? 01"}) {
+        signatures.push_back(parse(str));
+    }
+    const std::vector<hat::signature_view> views(signatures.begin(), signatures.end());
+
+    for (const auto alignment : {hat::scan_alignment::X1, hat::scan_alignment::X4, hat::scan_alignment::X16}) {
+        const hat::pattern_set set{views, alignment};
+        ASSERT_EQ(set.size(), signatures.size());
+
+        const auto results = set.find_first(data.begin(), data.end());
+        std::vector<std::vector<const std::byte*>> all(signatures.size());
+        set.find_all(data.begin(), data.end(), [&](const size_t index, const hat::scan_result match) {
+            all[index].push_back(match.get());
+        });
+
+        for (size_t i = 0; i < signatures.size(); i++) {
+            SCOPED_TRACE(hat::to_string(signatures[i]));
+            const auto expected = hat::test::reference_find_all(data, signatures[i], alignment);
+            EXPECT_EQ(results[i].get(), expected.empty() ? nullptr : expected.front());
+            EXPECT_EQ(all[i], expected);
+        }
+    }
+}
+
+TEST(PatternSetTest, UnanchoredSignaturesNeverMatch) {
+    // Without an exact byte there is nothing to anchor on, but the other signatures are still found
+    const auto partial = parse("?0 ?0");
+    const auto exact = parse("00 00");
+    const std::array<hat::signature_view, 2> signatures{partial, exact};
+    const std::vector<std::byte> data(64);
+
+    const auto results = hat::find_patterns(data.begin(), data.end(), signatures);
+    ASSERT_EQ(results.size(), 2);
+    EXPECT_FALSE(results[0].has_result());
+    EXPECT_EQ(results[1].get(), data.data());
+}
+
+TEST(PatternSetTest, StopsFindAll) {
+    const auto signature = parse("AA");
+    const std::array<hat::signature_view, 1> signatures{signature};
+    const std::vector data(100, std::byte{0xAA});
+
+    size_t reported = 0;
+    hat::pattern_set{signatures}.find_all(data.begin(), data.end(), [&](size_t, hat::const_scan_result) {
+        return ++reported < 10;
+    });
+    EXPECT_EQ(reported, 10);
+}
@@ -0,0 +1,101 @@
+#include <array>
+#include <execution>
+#include <span>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <libhat/Process.hpp>
+#include <libhat/Scanner.hpp>
+
+namespace {
+
+    [[nodiscard]] hat::signature parse(const std::string_view str) {
+        return hat::parse_signature(str).value();
+    }
+
+    // Three regions of one buffer, with gaps between them which must not be scanned
+    class RegionsTest : public testing::Test {
+    protected:
+        void SetUp() override {
+            this->data.fill(std::byte{0x00});
+            this->regions = {
+                std::span{this->data}.subspan(0, 32),
+                std::span{this->data}.subspan(40, 32),
+                std::span{this->data}.subspan(80, 48)
+            };
+        }
+
+        void place(const size_t offset) {
+            this->data[offset] = std::byte{0xAB};
+            this->data[offset + 1] = std::byte{0xCD};
+        }
+
+        std::array<std::byte, 128> data{};
+        std::array<std::span<std::byte>, 3> regions{};
+    };
+}
+
+TEST_F(RegionsTest, ScansRegionsInOrder) {
+    const auto signature = parse("AB CD");
+    EXPECT_FALSE(hat::find_pattern(this->regions, signature).has_result());
+
+    this->place(90);
+    this->place(50);
+    EXPECT_EQ(hat::find_pattern(this->regions, signature).get(), &this->data[50]);
+    EXPECT_EQ(hat::find_pattern(std::execution::par, this->regions, signature).get(), &this->data[50]);
+
+    const auto all = hat::find_all_pattern(this->regions, signature);
+    ASSERT_EQ(all.size(), 2);
+    EXPECT_EQ(all[0].get(), &this->data[50]);
+    EXPECT_EQ(all[1].get(), &this->data[90]);
+    EXPECT_EQ(hat::find_all_pattern(std::execution::par, this->regions, signature).size(), 2);
+}
+
+TEST_F(RegionsTest, SkipsGapsAndMatchesAcrossRegionEnds) {
+    const auto signature = parse("AB CD");
+
+    // In the gap between the first two regions, and across the end of the second region
+    this->place(34);
+    this->place(71);
+    EXPECT_FALSE(hat::find_pattern(this->regions, signature).has_result());
+    EXPECT_TRUE(hat::find_all_pattern(this->regions, signature).empty());
+}
+
+TEST_F(RegionsTest, WritesIntoOutputIterator) {
+    this->place(0);
+    this->place(40);
+    this->place(126);
+
+    std::vector<hat::scan_result> results(3);
+    EXPECT_EQ(hat::find_all_pattern(this->regions, results.begin(), parse("AB CD")), 3);
+    EXPECT_EQ(results[0].get(), &this->data[0]);
+    EXPECT_EQ(results[1].get(), &this->data[40]);
+    EXPECT_EQ(results[2].get(), &this->data[126]);
+}
+
+TEST(ModuleRegionsTest, ProcessModule) {
+    const auto mod = hat::process::get_process_module();
+    const auto module = hat::process::get_module_data(mod);
+    const auto regions = hat::process::module_regions(mod, hat::protection::Read);
+    ASSERT_FALSE(regions.empty());
+
+    // Sorted, disjoint, and within the module
+    for (size_t i = 0; i < regions.size(); i++) {
+        EXPECT_FALSE(regions[i].empty());
+        EXPECT_GE(regions[i].data(), module.data());
+        EXPECT_LE(regions[i].data() + regions[i].size(), module.data() + module.size());
+        if (i != 0) {
+            EXPECT_GT(regions[i].data(), regions[i - 1].data() + regions[i - 1].size());
+        }
+    }
+
+    // The executable code is among the readable regions
+    const auto code = hat::process::module_regions(mod, hat::protection::Read | hat::protection::Execute);
+    ASSERT_FALSE(code.empty());
+    const auto contains = [&](const std::byte* address) {
+        return std::ranges::any_of(regions, [&](const auto region) {
+            return address >= region.data() && address < region.data() + region.size();
+        });
+    };
+    EXPECT_TRUE(contains(code.front().data()));
+}
@@ -0,0 +1,119 @@
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+#include <libhat/RemoteProcess.hpp>
+
+namespace {
+
+    // The size of the windows the remote scans read, see src/RemoteProcess.cpp
+    constexpr size_t window_size = 1 << 20;
+
+    constexpr std::array signatures{
+        "E8 ? ? ? ? 90",
+        "? ? E8 ? ? ? ? 90",
+    };
+
+    // A buffer of a few windows, with "E8 ? ? ? ? 90" placed before, across and after every window boundary, at
+    // aligned and unaligned offsets
+    [[nodiscard]] std::vector<std::byte> make_buffer() {
+        std::vector<std::byte> data(window_size * 3 + 1000);
+        for (size_t boundary = window_size; boundary <= window_size * 3; boundary += window_size) {
+            for (const ptrdiff_t offset : {-24, -11, -4, 3, 12, 20}) {
+                const auto index = static_cast<size_t>(static_cast<ptrdiff_t>(boundary) + offset);
+                data[index] = std::byte{0xE8};
+                data[index + 5] = std::byte{0x90};
+            }
+        }
+        return data;
+    }
+
+    [[nodiscard]] hat::remote_process open_self() {
+        auto process = hat::remote_process::open(static_cast<uint32_t>(getpid()));
+        if (!process) {
+            throw std::runtime_error{"unable to open the memory of the test process"};
+        }
+        return std::move(*process);
+    }
+
+    // The remote scan of the region must find exactly what the local scan of the same memory finds
+    template<hat::scan_alignment alignment>
+    void expect_remote_matches_local(const hat::remote_process& process, const std::vector<std::byte>& data, const size_t skip) {
+        const auto begin = data.data() + skip;
+        const auto end = data.data() + data.size();
+        const hat::remote_region region{reinterpret_cast<uintptr_t>(begin), static_cast<size_t>(end - begin)};
+
+        for (const auto str : signatures) {
+            const auto signature = hat::parse_signature(str).value();
+
+            std::vector<uintptr_t> expected{};
+            for (const auto result : hat::find_all_pattern<alignment>(begin, end, signature)) {
+                expected.push_back(reinterpret_cast<uintptr_t>(result.get()));
+            }
+            ASSERT_GE(expected.size(), 3) << str;
+
+            EXPECT_EQ(process.find_all_pattern<alignment>(region, signature), expected) << str << " from " << skip;
+            EXPECT_EQ(process.find_pattern<alignment>(region, signature), expected.front()) << str << " from " << skip;
+        }
+    }
+}
+
+TEST(RemoteProcessTest, ScansAcrossWindows) {
+    const auto process = open_self();
+    const auto data = make_buffer();
+
+    // Starting the region elsewhere than the buffer moves the window boundaries relative to the matches
+    for (const size_t skip : {size_t{0}, size_t{3}, window_size - 30, window_size - 8}) {
+        expect_remote_matches_local<hat::scan_alignment::X1>(process, data, skip);
+        expect_remote_matches_local<hat::scan_alignment::X4>(process, data, skip);
+    }
+}
+
+TEST(RemoteProcessTest, StopsAtFirstMatch) {
+    const auto process = open_self();
+    auto data = make_buffer();
+    const auto signature = hat::parse_signature("E8 ? ? ? ? 90").value();
+
+    // A match in the first window ends the scan before the remaining windows are scanned
+    data[100] = std::byte{0xE8};
+    data[105] = std::byte{0x90};
+    const hat::remote_region region{reinterpret_cast<uintptr_t>(data.data()), data.size()};
+    EXPECT_EQ(process.find_pattern<hat::scan_alignment::X4>(region, signature), reinterpret_cast<uintptr_t>(&data[100]));
+
+    // Without any match, every window is scanned
+    const auto none = hat::parse_signature("E8 ? ? ? ? 91").value();
+    EXPECT_FALSE(process.find_pattern<hat::scan_alignment::X4>(region, none).has_value());
+    EXPECT_TRUE(process.find_all_pattern<hat::scan_alignment::X4>(region, none).empty());
+}
+
+TEST(RemoteProcessTest, FindsSections) {
+    const auto process = open_self();
+    const auto mod = process.get_process_module();
+    ASSERT_TRUE(mod.has_value());
+    EXPECT_EQ(*mod, hat::process::get_process_module());
+
+    for (const auto name : {".text", ".rodata", ".data"}) {
+        const auto local = hat::process::get_section_data(hat::process::get_process_module(), name);
+        const auto remote = process.get_section_data(*mod, name);
+        EXPECT_EQ(remote.address, reinterpret_cast<uintptr_t>(local.data())) << name;
+        EXPECT_EQ(remote.size, local.size()) << name;
+    }
+    EXPECT_TRUE(process.get_section_data(*mod, ".libhat_missing").empty());
+
+    // A signature taken from the middle of the local text section is found at the same address remotely
+    const auto text = hat::process::get_section_data(hat::process::get_process_module(), ".text");
+    ASSERT_GE(text.size(), 64);
+    const auto sample = text.subspan(text.size() / 2, 32);
+    hat::signature signature{};
+    for (const auto byte : sample) {
+        signature.emplace_back(byte);
+    }
+    const auto local = hat::find_pattern(text.begin(), text.end(), signature);
+    ASSERT_TRUE(local.has_result());
+    EXPECT_EQ(process.find_pattern(signature, ".text", *mod), reinterpret_cast<uintptr_t>(local.get()));
+}
@@ -0,0 +1,87 @@
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+
+#include <gtest/gtest.h>
+#include <libhat/Defines.hpp>
+#include <libhat/Process.hpp>
+#include <libhat/ResolutionCache.hpp>
+
+#include "../Module.hpp"
+
+// Read only data of the test executable which is looked up in its own module
+extern const std::array<uint8_t, 16> resolution_cache_marker;
+alignas(16) const std::array<uint8_t, 16> resolution_cache_marker{
+    0x3B, 0xC4, 0x7E, 0x05, 0x9A, 0x61, 0xF2, 0x2D, 0x86, 0x4F, 0xE9, 0x10, 0xB7, 0x58, 0x23, 0xDC
+};
+
+namespace {
+
+    constexpr std::string_view marker_signature = "3B C4 7E 05 9A 61 F2 2D 86 4F E9 10 B7 58 23 DC";
+
+    // The rodata section name of the platform
+#if defined(LIBHAT_WINDOWS)
+    constexpr std::string_view section = ".rdata";
+#else
+    constexpr std::string_view section = ".rodata";
+#endif
+
+    class ResolutionCacheTest : public testing::Test {
+    protected:
+        void TearDown() override {
+            std::filesystem::remove(this->path);
+        }
+
+        const std::filesystem::path path = std::filesystem::temp_directory_path() / "libhat_resolution_cache_test.bin";
+    };
+}
+
+TEST_F(ResolutionCacheTest, CachesMatches) {
+    LIBHAT_TEST_REQUIRE_MODULE_SCAN();
+
+    const auto signature = hat::parse_signature(marker_signature).value();
+    const auto expected = reinterpret_cast<const std::byte*>(resolution_cache_marker.data());
+
+    hat::resolution_cache cache{};
+    EXPECT_EQ(cache.find_pattern(signature, section).get(), expected);
+    EXPECT_EQ(cache.size(), 1);
+
+    // The cached match is verified and returned, without adding another entry
+    EXPECT_EQ(cache.find_pattern(signature, section).get(), expected);
+    EXPECT_EQ(cache.size(), 1);
+
+    // The alignment is part of the key
+    EXPECT_EQ(cache.find_pattern<hat::scan_alignment::X16>(signature, section).get(), expected);
+    EXPECT_EQ(cache.size(), 2);
+
+    // Signatures without a match aren't cached
+    const auto missing = hat::parse_signature("3B C4 7E 05 9A 61 F2 2D 86 4F E9 10 B7 58 23 DD 00 11 22").value();
+    EXPECT_FALSE(cache.find_pattern(missing, section).has_result());
+    EXPECT_EQ(cache.size(), 2);
+
+    cache.clear();
+    EXPECT_EQ(cache.size(), 0);
+}
+
+TEST_F(ResolutionCacheTest, SavesAndLoads) {
+    LIBHAT_TEST_REQUIRE_MODULE_SCAN();
+
+    const auto signature = hat::parse_signature(marker_signature).value();
+
+    hat::resolution_cache cache{};
+    ASSERT_TRUE(cache.find_pattern(signature, section).has_result());
+    ASSERT_TRUE(cache.save(this->path));
+
+    auto loaded = hat::resolution_cache::load(this->path);
+    EXPECT_EQ(loaded.size(), 1);
+    EXPECT_EQ(loaded.find_pattern(signature, section).get(), reinterpret_cast<const std::byte*>(resolution_cache_marker.data()));
+    EXPECT_EQ(loaded.size(), 1);
+}
+
+TEST_F(ResolutionCacheTest, IgnoresInvalidFiles) {
+    EXPECT_EQ(hat::resolution_cache::load(this->path).size(), 0);
+
+    std::ofstream{this->path, std::ios::binary} << "not a cache";
+    EXPECT_EQ(hat::resolution_cache::load(this->path).size(), 0);
+}
@@ -0,0 +1,98 @@
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <libhat/ResolveChain.hpp>
+
+namespace {
+
+    [[nodiscard]] hat::signature parse(const std::string_view str) {
+        return hat::parse_signature(str).value();
+    }
+
+    // A buffer containing "48 8B 05 rel32" at offset 16, which refers to a pointer at offset 64, which in turn points
+    // to offset 128 of the buffer
+    class ResolveChainTest : public testing::Test {
+    protected:
+        void SetUp() override {
+            this->write(16, std::array<uint8_t, 3>{0x48, 0x8B, 0x05});
+            this->write(19, static_cast<int32_t>(64 - (19 + 4)));
+            this->write(64, reinterpret_cast<uintptr_t>(&this->data[128]));
+        }
+
+        template<typename T>
+        void write(const size_t offset, const T& value) {
+            std::memcpy(&this->data[offset], &value, sizeof(value));
+        }
+
+        [[nodiscard]] hat::scan_result at(const size_t offset) {
+            return &this->data[offset];
+        }
+
+        std::array<std::byte, 256> data{};
+    };
+}
+
+TEST_F(ResolveChainTest, AppliesSteps) {
+    EXPECT_EQ(hat::resolve_chain{}.rel(3).resolve(this->at(16), this->data), this->at(64));
+    EXPECT_EQ(hat::resolve_chain{}.rel(3).deref().resolve(this->at(16), this->data), this->at(128));
+    EXPECT_EQ(hat::resolve_chain{}.rel(3).deref().add(0x10).resolve(this->at(16), this->data), this->at(144));
+    EXPECT_EQ(hat::resolve_chain{}.deref(48).resolve(this->at(16), this->data), this->at(128));
+    EXPECT_EQ(hat::resolve_chain{}.add(-16).resolve(this->at(16), this->data), this->at(0));
+
+    // An empty chain returns the match itself
+    EXPECT_EQ(hat::resolve_chain{}.resolve(this->at(16), this->data), this->at(16));
+    EXPECT_FALSE(hat::resolve_chain{}.rel(3).resolve(nullptr, this->data).has_result());
+}
+
+TEST_F(ResolveChainTest, ValidatesBounds) {
+    const std::span bounds{this->data.data(), 96};
+
+    // The pointer is read from within the bounds, but it points past them
+    EXPECT_FALSE(hat::resolve_chain{}.rel(3).deref().resolve(this->at(16), bounds).has_result());
+
+    // Reads which end past the bounds, and addresses which leave them
+    EXPECT_FALSE(hat::resolve_chain{}.deref(90 - 16).resolve(this->at(16), bounds).has_result());
+    EXPECT_FALSE(hat::resolve_chain{}.rel(3).add(32).resolve(this->at(16), bounds).has_result());
+    EXPECT_FALSE(hat::resolve_chain{}.add(-17).rel(0).resolve(this->at(16), bounds).has_result());
+}
+
+TEST_F(ResolveChainTest, LimitsSteps) {
+    constexpr auto chain = [] {
+        hat::resolve_chain chain{};
+        for (size_t i = 0; i < hat::max_resolve_steps; i++) {
+            chain.add(1);
+        }
+        return chain;
+    }();
+    static_assert(chain.valid());
+    static_assert(chain.steps().size() == hat::max_resolve_steps);
+    EXPECT_EQ(chain.resolve(this->at(0), this->data), this->at(hat::max_resolve_steps));
+
+    auto overflow = chain;
+    overflow.add(1);
+    EXPECT_FALSE(overflow.valid());
+    EXPECT_TRUE(overflow.steps().empty());
+    EXPECT_FALSE(overflow.resolve(this->at(0), this->data).has_result());
+}
+
+TEST_F(ResolveChainTest, ResolvesBatches) {
+    const auto load = parse("48 8B 05 ? ? ? ?");
+    const auto missing = parse("FF FF FF");
+    const std::array<hat::signature_view, 2> signatures{load, missing};
+    const std::array chains{hat::resolve_chain{}.rel(3).deref(), hat::resolve_chain{}.add(1)};
+
+    const auto results = hat::find_and_resolve(signatures, chains, this->data, this->data);
+    ASSERT_EQ(results.size(), 2);
+    EXPECT_EQ(results[0], this->at(128));
+    EXPECT_FALSE(results[1].has_result());
+
+    // Matches without a chain are returned as they are
+    const std::array matches{this->at(16), this->at(20)};
+    const auto resolved = hat::resolve_all(matches, std::span{chains}.first(1), this->data);
+    ASSERT_EQ(resolved.size(), 2);
+    EXPECT_EQ(resolved[0], this->at(128));
+    EXPECT_EQ(resolved[1], this->at(20));
+}
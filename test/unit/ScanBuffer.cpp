@@ -0,0 +1,120 @@
+#include <cstdint>
+#include <execution>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+#include <libhat/ScanBuffer.hpp>
+#include <libhat/Scanner.hpp>
+
+namespace {
+
+    constexpr size_t huge_page_size = 1 << 21;
+
+    // Pins the NUMA node count of the parallel scans for the lifetime of the object
+    class pinned_node_count {
+    public:
+        explicit pinned_node_count(const size_t count) {
+            hat::detail::pin_numa_node_count(count);
+        }
+
+        pinned_node_count(const pinned_node_count&) = delete;
+        pinned_node_count& operator=(const pinned_node_count&) = delete;
+
+        ~pinned_node_count() {
+            hat::detail::pin_numa_node_count(std::nullopt);
+        }
+    };
+
+    // Fills the buffer with a pattern which matches "11 22 33 44" at a few offsets, including across the chunk
+    // boundaries of the parallel scans
+    void fill(const hat::scan_buffer& buffer) {
+        for (size_t i = 0; i < buffer.size(); i++) {
+            buffer.data()[i] = static_cast<std::byte>(i % 251);
+        }
+        for (const size_t offset : {size_t{7}, (size_t{1} << 20) - 2, (size_t{2} << 20) + 100, buffer.size() - 4}) {
+            buffer.data()[offset + 0] = std::byte{0x11};
+            buffer.data()[offset + 1] = std::byte{0x22};
+            buffer.data()[offset + 2] = std::byte{0x33};
+            buffer.data()[offset + 3] = std::byte{0x44};
+        }
+    }
+}
+
+TEST(ScanBufferTest, Allocates) {
+    const auto size = (size_t{3} << 20) + 5;
+    auto buffer = hat::scan_buffer::allocate(size);
+    ASSERT_TRUE(buffer.has_value());
+    EXPECT_EQ(buffer->size(), size);
+    EXPECT_EQ(buffer->end() - buffer->begin(), static_cast<ptrdiff_t>(size));
+    EXPECT_EQ(buffer->span().data(), buffer->data());
+    EXPECT_FALSE(buffer->node().has_value());
+
+    // The buffer is aligned for huge pages whether or not the kernel grants them, and starts out zeroed
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(buffer->data()) % huge_page_size, 0);
+    for (const auto byte : buffer->span()) {
+        ASSERT_EQ(byte, std::byte{0});
+    }
+    buffer->data()[size - 1] = std::byte{0xCC};
+
+    // Moving transfers the memory, the moved-from buffer is empty
+    const auto data = buffer->data();
+    auto moved = std::move(*buffer);
+    EXPECT_EQ(moved.data(), data);
+    EXPECT_EQ(moved.data()[size - 1], std::byte{0xCC});
+    EXPECT_EQ(buffer->data(), nullptr);
+    EXPECT_EQ(buffer->size(), 0);
+}
+
+TEST(ScanBufferTest, AllocatesRegularPages) {
+    const auto buffer = hat::scan_buffer::allocate(100, {.largePages = false});
+    ASSERT_TRUE(buffer.has_value());
+    EXPECT_FALSE(buffer->large_pages());
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(buffer->data()) % static_cast<uintptr_t>(sysconf(_SC_PAGESIZE)), 0);
+    buffer->data()[99] = std::byte{1};
+
+    // An empty buffer still has a valid address
+    const auto empty = hat::scan_buffer::allocate(0);
+    ASSERT_TRUE(empty.has_value());
+    EXPECT_NE(empty->data(), nullptr);
+    EXPECT_EQ(empty->size(), 0);
+}
+
+TEST(ScanBufferTest, PlacesOnNode) {
+    // Node 0 always exists, a kernel without NUMA support places every page on it
+    const auto buffer = hat::scan_buffer::allocate(1 << 20, {.node = 0});
+    ASSERT_TRUE(buffer.has_value());
+    EXPECT_EQ(buffer->node(), 0);
+    buffer->data()[0] = std::byte{1};
+    if (const auto node = hat::numa_node_of(buffer->data())) {
+        EXPECT_EQ(*node, 0);
+    }
+
+    // Nodes which don't exist can't be placed on
+    EXPECT_FALSE(hat::scan_buffer::allocate(1 << 20, {.node = static_cast<uint32_t>(hat::numa_node_count())}).has_value());
+    EXPECT_FALSE(hat::scan_buffer::allocate(1 << 20, {.node = UINT32_MAX}).has_value());
+}
+
+TEST(ScanBufferTest, ParallelScans) {
+    const auto buffer = hat::scan_buffer::allocate((size_t{4} << 20) + 10, {.node = 0});
+    ASSERT_TRUE(buffer.has_value());
+    fill(*buffer);
+
+    const auto signature = hat::parse_signature("11 22 33 44").value();
+    const auto expected = hat::find_all_pattern(buffer->begin(), buffer->end(), signature);
+    ASSERT_EQ(expected.size(), 4);
+
+    // With the system's node count, and with more nodes than the system has so that the chunks are scheduled per node
+    for (const size_t nodes : {size_t{0}, size_t{2}, size_t{4}}) {
+        std::optional<pinned_node_count> pin{};
+        if (nodes != 0) {
+            pin.emplace(nodes);
+        }
+        EXPECT_EQ(hat::find_all_pattern(std::execution::par, buffer->begin(), buffer->end(), signature), expected) << nodes;
+        EXPECT_EQ(hat::find_pattern(std::execution::par, buffer->begin(), buffer->end(), signature).get(), expected.front().get()) << nodes;
+    }
+    EXPECT_FALSE(hat::detail::pinned_numa_node_count().has_value());
+}
@@ -0,0 +1,103 @@
+#include <array>
+#include <atomic>
+#include <coroutine>
+#include <future>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <libhat/ScanScheduler.hpp>
+
+namespace {
+
+    [[nodiscard]] hat::signature parse(const std::string_view str) {
+        return hat::parse_signature(str).value();
+    }
+
+    // A coroutine which runs eagerly and is never awaited, for awaiting a scan_awaitable from a test
+    struct detached {
+        struct promise_type {
+            detached get_return_object() noexcept { return {}; }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() noexcept {}
+            void unhandled_exception() { std::terminate(); }
+        };
+    };
+
+    detached await_scan(hat::scan_awaitable awaitable, std::promise<hat::scan_result>& result) {
+        result.set_value(co_await awaitable);
+    }
+
+    // A range larger than a single chunk, with "11 22 33 44" close to its end and "55 66" at its beginning
+    class ScanSchedulerTest : public testing::Test {
+    protected:
+        void SetUp() override {
+            this->place(this->data.size() - 100, {0x11, 0x22, 0x33, 0x44});
+            this->place(8, {0x55, 0x66});
+        }
+
+        void place(const size_t offset, const std::initializer_list<uint8_t> bytes) {
+            for (size_t i = 0; const auto byte : bytes) {
+                this->data[offset + i++] = static_cast<std::byte>(byte);
+            }
+        }
+
+        std::vector<std::byte> data = std::vector<std::byte>(3 << 20);
+        hat::scan_scheduler scheduler{2};
+    };
+}
+
+TEST_F(ScanSchedulerTest, CreatesWorkers) {
+    EXPECT_EQ(this->scheduler.size(), 2);
+    EXPECT_GE(hat::scan_scheduler{}.size(), 1);
+}
+
+TEST_F(ScanSchedulerTest, ReturnsFutures) {
+    auto found = this->scheduler.submit(parse("11 22 33 44"), this->data);
+    auto missing = this->scheduler.submit(parse("11 22 33 45"), this->data);
+    auto aligned = this->scheduler.submit(parse("55 66"), this->data, hat::scan_alignment::X16);
+
+    EXPECT_EQ(found.get().get(), &this->data[this->data.size() - 100]);
+    EXPECT_FALSE(missing.get().has_result());
+    EXPECT_FALSE(aligned.get().has_result());
+}
+
+TEST_F(ScanSchedulerTest, InvokesCallbacks) {
+    std::promise<hat::scan_result> promise{};
+    this->scheduler.submit(parse("55 66"), this->data, hat::scan_alignment::X8, [&](const hat::scan_result result) {
+        promise.set_value(result);
+    });
+    EXPECT_EQ(promise.get_future().get().get(), &this->data[8]);
+}
+
+TEST_F(ScanSchedulerTest, ScansBatches) {
+    const auto first = parse("11 22 33 44");
+    const auto second = parse("55 66");
+    const auto third = parse("77 88");
+    const std::array<hat::signature_view, 3> signatures{first, second, third};
+
+    auto results = this->scheduler.submit(signatures, this->data);
+    ASSERT_EQ(results.size(), 3);
+    EXPECT_EQ(results[0].get().get(), &this->data[this->data.size() - 100]);
+    EXPECT_EQ(results[1].get().get(), &this->data[8]);
+    EXPECT_FALSE(results[2].get().has_result());
+}
+
+TEST_F(ScanSchedulerTest, ResumesCoroutines) {
+    std::promise<hat::scan_result> promise{};
+    await_scan(this->scheduler.schedule(parse("11 22 33 44"), this->data), promise);
+    EXPECT_EQ(promise.get_future().get().get(), &this->data[this->data.size() - 100]);
+}
+
+TEST_F(ScanSchedulerTest, CompletesJobsOnDestruction) {
+    std::atomic<size_t> completed{};
+    {
+        hat::scan_scheduler pool{1};
+        for (size_t i = 0; i < 8; i++) {
+            pool.submit(parse("11 22 33 44"), this->data, hat::scan_alignment::X1, [&](const hat::scan_result) {
+                completed++;
+            });
+        }
+    }
+    EXPECT_EQ(completed, 8);
+}
@@ -0,0 +1,111 @@
+#include <array>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <libhat/ScanStats.hpp>
+
+// Only built with -DLIBHAT_SCAN_STATS=ON, since the scanners aren't instrumented otherwise
+static_assert(hat::scan_stats_enabled);
+
+namespace {
+
+    // A buffer with "E8 11 22 33 44 90" at two offsets, which is scanned for with a leading wildcard
+    class ScanStatsTest : public testing::Test {
+    protected:
+        void SetUp() override {
+            for (const size_t offset : {1000, 3000}) {
+                const std::array bytes{0xE8, 0x11, 0x22, 0x33, 0x44, 0x90};
+                for (size_t i = 0; i < bytes.size(); i++) {
+                    this->data[offset + i] = static_cast<std::byte>(bytes[i]);
+                }
+            }
+        }
+
+        void TearDown() override {
+            hat::set_scan_trace_hook(nullptr);
+        }
+
+        [[nodiscard]] hat::const_scan_result find() const {
+            return hat::find_pattern(this->data.cbegin(), this->data.cend(), this->signature);
+        }
+
+        std::vector<std::byte> data = std::vector<std::byte>(4096);
+        hat::signature signature = hat::parse_signature("? E8 ? ? ? ? 90").value();
+    };
+}
+
+TEST_F(ScanStatsTest, CollectsScans) {
+    hat::scan_stats_collector collector{};
+    ASSERT_EQ(this->find().get(), &this->data[999]);
+    EXPECT_EQ(hat::find_all_pattern(this->data.cbegin(), this->data.cend(), this->signature).size(), 2);
+    hat::find_pattern<hat::scan_alignment::X4>(this->data.cbegin(), this->data.cend(), this->signature);
+
+    const auto scans = collector.scans();
+    ASSERT_EQ(scans.size(), 3);
+
+    // The scans begin after the leading wildcard, and the first one stops at the end of its match
+    const auto& first = scans[0];
+    EXPECT_EQ(first.mode, hat::selected_scan_mode());
+    EXPECT_EQ(first.alignment, hat::scan_alignment::X1);
+    EXPECT_EQ(first.signatureSize, 6);
+    EXPECT_EQ(first.bytesScanned, 1000 + 6 - 1);
+    EXPECT_EQ(first.matches, 1);
+    EXPECT_GE(first.candidates, 1);
+    EXPECT_EQ(first.verifyFailures, first.candidates - 1);
+    if (first.anchorOffset) {
+        EXPECT_LT(*first.anchorOffset + first.anchorDistance, first.signatureSize);
+    }
+
+    const auto& all = scans[1];
+    EXPECT_EQ(all.bytesScanned, this->data.size() - 1);
+    EXPECT_EQ(all.matches, 2);
+    EXPECT_GE(all.candidates, 2);
+    EXPECT_EQ(all.verifyFailures, all.candidates - 2);
+
+    const auto& aligned = scans[2];
+    EXPECT_EQ(aligned.alignment, hat::scan_alignment::X4);
+    EXPECT_FALSE(aligned.anchorOffset.has_value());
+
+    collector.clear();
+    EXPECT_TRUE(collector.scans().empty());
+}
+
+TEST_F(ScanStatsTest, NestedCollectors) {
+    hat::scan_stats_collector outer{};
+    static_cast<void>(this->find());
+    {
+        // Only the innermost collector receives the statistics
+        hat::scan_stats_collector inner{};
+        static_cast<void>(this->find());
+        static_cast<void>(this->find());
+        EXPECT_EQ(inner.scans().size(), 2);
+        EXPECT_EQ(outer.scans().size(), 1);
+    }
+    static_cast<void>(this->find());
+    EXPECT_EQ(outer.scans().size(), 2);
+
+    // Scans on other threads aren't collected
+    std::thread{[this] { static_cast<void>(this->find()); }}.join();
+    EXPECT_EQ(outer.scans().size(), 2);
+}
+
+TEST_F(ScanStatsTest, TraceHook) {
+    std::vector<hat::scan_stats> traced{};
+    hat::set_scan_trace_hook([](const hat::scan_stats& stats, void* user) {
+        static_cast<std::vector<hat::scan_stats>*>(user)->push_back(stats);
+    }, &traced);
+
+    // The hook receives the scans of every thread, along with any collector
+    hat::scan_stats_collector collector{};
+    static_cast<void>(this->find());
+    std::thread{[this] { static_cast<void>(this->find()); }}.join();
+    ASSERT_EQ(traced.size(), 2);
+    EXPECT_EQ(collector.scans().size(), 1);
+    EXPECT_EQ(traced[0].matches, 1);
+    EXPECT_EQ(traced[0].candidates, collector.scans()[0].candidates);
+
+    hat::set_scan_trace_hook(nullptr);
+    static_cast<void>(this->find());
+    EXPECT_EQ(traced.size(), 2);
+}
@@ -0,0 +1,54 @@
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <libhat/FrequencyModel.hpp>
+#include <libhat/Scanner.hpp>
+
+namespace {
+
+    [[nodiscard]] hat::signature parse(const std::string_view str) {
+        return hat::parse_signature(str).value();
+    }
+
+    [[nodiscard]] hat::detail::scan_context create_context(
+        const hat::signature_view    signature,
+        const hat::scan_hint         hints,
+        const hat::frequency_model*  model = nullptr
+    ) {
+        return hat::detail::scan_context::create(signature, hat::scan_alignment::X1, hints, {}, model, hat::scan_mode::SSE);
+    }
+
+    class ScannerTest : public testing::Test {
+    protected:
+        void SetUp() override {
+            if (!hat::is_scan_mode_supported(hat::scan_mode::SSE)) {
+                GTEST_SKIP() << "scan mode not supported";
+            }
+        }
+    };
+}
+
+TEST_F(ScannerTest, X86HintKeepsAdjacentPair) {
+    // The built-in model only ranks the most common pairs, so the bytes outside of it must not look rarer than a pair
+    const auto signature = parse("48 8B ? 12 ? 34");
+    const auto context = create_context(signature, hat::scan_hint::x86_64);
+    ASSERT_TRUE(context.pairIndex.has_value());
+    EXPECT_EQ(*context.pairIndex, 0);
+    EXPECT_EQ(context.pairDistance, 1);
+}
+
+TEST_F(ScannerTest, MeasuredModelSelectsDistantPair) {
+    // In the data, the adjacent pair is common while the bytes around the wildcards are rare
+    std::vector<std::byte> data{};
+    for (size_t i = 0; i < 4096; i++) {
+        data.insert(data.end(), {std::byte{0x48}, std::byte{0x8B}, std::byte{0x00}, std::byte{0x00}});
+    }
+    data.insert(data.end(), {std::byte{0x12}, std::byte{0x00}, std::byte{0x34}, std::byte{0x00}});
+    const auto model = hat::frequency_model::from_data(data);
+
+    const auto signature = parse("48 8B ? 12 ? 34");
+    const auto context = create_context(signature, hat::scan_hint::none, &model);
+    ASSERT_TRUE(context.pairIndex.has_value());
+    EXPECT_EQ(*context.pairIndex, 3);
+    EXPECT_EQ(context.pairDistance, 2);
+}
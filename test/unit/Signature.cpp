@@ -0,0 +1,110 @@
+#include <array>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <libhat/Signature.hpp>
+#include <libhat/SignatureArena.hpp>
+
+namespace {
+
+    [[nodiscard]] bool equal(const hat::signature_view lhs, const hat::signature_view rhs) {
+        return std::ranges::equal(lhs, rhs, [](const auto a, const auto b) {
+            return a.value() == b.value() && a.mask() == b.mask();
+        });
+    }
+}
+
+TEST(SmallSignatureTest, ParsesLikeParseSignature) {
+    for (const auto str : {"48 8B ? ? 05", "4? ?2 ?? E8", "AA"}) {
+        const auto expected = hat::parse_signature(str);
+        const auto parsed = hat::parse_small_signature<4>(str);
+        ASSERT_TRUE(parsed.has_value()) << str;
+        EXPECT_TRUE(equal(parsed.value(), expected.value())) << str;
+    }
+}
+
+TEST(SmallSignatureTest, ReportsParseErrors) {
+    EXPECT_EQ(hat::parse_small_signature("").error(), hat::signature_parse_error::empty_signature);
+    EXPECT_EQ(hat::parse_small_signature("? ?").error(), hat::signature_parse_error::missing_byte);
+    EXPECT_EQ(hat::parse_small_signature("48 XY").error(), hat::signature_parse_error::parse_error);
+}
+
+TEST(SmallSignatureTest, MovesToHeapPastCapacity) {
+    hat::small_signature<4> sig{};
+    for (size_t i = 0; i < 4; i++) {
+        sig.push_back(static_cast<std::byte>(i));
+    }
+    EXPECT_TRUE(sig.is_inline());
+
+    sig.push_back(std::byte{4});
+    EXPECT_FALSE(sig.is_inline());
+    ASSERT_EQ(sig.size(), 5);
+    for (size_t i = 0; i < sig.size(); i++) {
+        EXPECT_EQ(sig[i].value(), static_cast<std::byte>(i));
+    }
+}
+
+TEST(SmallSignatureTest, AppendsBytesAndElements) {
+    hat::small_signature<8> sig{};
+    sig.append(std::array{std::byte{0xE8}});
+    sig.append(hat::signature(4));
+    EXPECT_TRUE(equal(sig, hat::parse_signature("E8 ? ? ? ?").value()));
+}
+
+TEST(SmallSignatureTest, CopyAndMove) {
+    for (const auto str : {"01 02", "01 02 03 04 05 06"}) {
+        const auto original = hat::parse_small_signature<4>(str).value();
+
+        auto copy = original;
+        EXPECT_TRUE(equal(copy, original)) << str;
+
+        const auto moved = std::move(copy);
+        EXPECT_TRUE(equal(moved, original)) << str;
+        EXPECT_TRUE(copy.empty()) << str;
+    }
+}
+
+TEST(SignatureArenaTest, ParsesIntoBlocks) {
+    hat::signature_arena arena{8};
+
+    std::vector<hat::signature_view> views{};
+    std::vector<hat::signature> expected{};
+    for (size_t i = 0; i < 20; i++) {
+        const auto str = "48 ? " + std::to_string(10 + i);
+        const auto view = arena.parse(str);
+        ASSERT_TRUE(view.has_value());
+        views.push_back(view.value());
+        expected.push_back(hat::parse_signature(str).value());
+    }
+    EXPECT_EQ(arena.size(), 60);
+
+    // Adding blocks doesn't move the signatures stored before
+    for (size_t i = 0; i < views.size(); i++) {
+        EXPECT_TRUE(equal(views[i], expected[i])) << i;
+    }
+}
+
+TEST(SignatureArenaTest, StoresLargeSignatures) {
+    hat::signature_arena arena{4};
+    const hat::signature large(100, hat::signature_element{std::byte{0x90}});
+
+    const auto view = arena.store(large);
+    EXPECT_NE(view.data(), large.data());
+    EXPECT_TRUE(equal(view, large));
+    EXPECT_EQ(arena.size(), 100);
+}
+
+TEST(SignatureArenaTest, InvalidSignaturesAreNotStored) {
+    hat::signature_arena arena{};
+    EXPECT_EQ(arena.parse("48 XY").error(), hat::signature_parse_error::parse_error);
+    EXPECT_EQ(arena.parse("? ?").error(), hat::signature_parse_error::missing_byte);
+    EXPECT_EQ(arena.size(), 0);
+
+    const auto view = arena.parse("AA BB");
+    ASSERT_TRUE(view.has_value());
+    EXPECT_TRUE(equal(view.value(), hat::parse_signature("AA BB").value()));
+
+    arena.clear();
+    EXPECT_EQ(arena.size(), 0);
+}
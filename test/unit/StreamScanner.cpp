@@ -0,0 +1,91 @@
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <libhat/StreamScanner.hpp>
+
+#include "../Reference.hpp"
+
+namespace {
+
+    [[nodiscard]] hat::signature parse(const std::string_view str) {
+        return hat::parse_signature(str).value();
+    }
+
+    // The stream offsets of the matches in the data, which is aligned to 64 bytes so that the reference alignment of
+    // an address is that of its offset
+    [[nodiscard]] std::vector<uint64_t> expected_offsets(const std::vector<std::byte>& data, const hat::signature_view signature, const hat::scan_alignment alignment) {
+        alignas(64) static std::byte aligned[1024];
+        std::ranges::copy(data, aligned);
+        std::vector<uint64_t> offsets{};
+        for (const auto match : hat::test::reference_find_all({aligned, data.size()}, signature, alignment)) {
+            offsets.push_back(static_cast<uint64_t>(match - aligned));
+        }
+        return offsets;
+    }
+
+    // Feeds the data in chunks of the given size, and collects the offsets of every match
+    [[nodiscard]] std::vector<uint64_t> feed_chunks(hat::stream_scanner& scanner, const std::vector<std::byte>& data, const size_t chunkSize) {
+        std::vector<uint64_t> offsets{};
+        for (size_t i = 0; i < data.size(); i += chunkSize) {
+            const auto chunk = std::span{data}.subspan(i, std::min(chunkSize, data.size() - i));
+            scanner.feed(chunk, [&](const uint64_t offset) {
+                offsets.push_back(offset);
+            });
+        }
+        return offsets;
+    }
+}
+
+TEST(StreamScannerTest, MatchesAcrossChunks) {
+    std::mt19937 generator(3);
+    std::vector<std::byte> data(1000);
+    for (auto& byte : data) {
+        byte = static_cast<std::byte>(generator() % 3);
+    }
+
+    const auto signature = parse("01 ? 02 00 ? ? 01");
+    const auto expected = expected_offsets(data, signature, hat::scan_alignment::X1);
+    ASSERT_FALSE(expected.empty());
+
+    for (const size_t chunkSize : {1, 2, 3, 6, 7, 8, 64, 999, 1000}) {
+        hat::stream_scanner scanner{signature};
+        EXPECT_EQ(feed_chunks(scanner, data, chunkSize), expected) << "chunk size " << chunkSize;
+        EXPECT_EQ(scanner.offset(), data.size());
+    }
+}
+
+TEST(StreamScannerTest, AlignmentAppliesToFirstSolidElement) {
+    std::vector<std::byte> data(256);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<std::byte>(i % 2 ? 0x90 : 0xCC);
+    }
+
+    // With two leading wildcards, the aligned matches begin 2 bytes before a multiple of 4
+    const auto signature = parse("? ? CC 90");
+    const auto expected = expected_offsets(data, signature, hat::scan_alignment::X4);
+    ASSERT_FALSE(expected.empty());
+    EXPECT_EQ(expected.front(), 2);
+
+    for (const size_t chunkSize : {1, 5, 256}) {
+        hat::stream_scanner scanner{signature, hat::scan_alignment::X4};
+        EXPECT_EQ(feed_chunks(scanner, data, chunkSize), expected) << "chunk size " << chunkSize;
+    }
+}
+
+TEST(StreamScannerTest, StopAndReset) {
+    const std::vector data(16, std::byte{0xAB});
+    hat::stream_scanner scanner{parse("AB AB")};
+
+    // Returning false stops reporting for the rest of the chunk, but the next chunk is reported again
+    size_t reported = 0;
+    scanner.feed(data, [&](uint64_t) {
+        return ++reported < 3;
+    });
+    EXPECT_EQ(reported, 3);
+    EXPECT_EQ(scanner.feed(std::span{data}.first(1)), std::vector<uint64_t>{15});
+
+    scanner.reset();
+    EXPECT_EQ(scanner.offset(), 0);
+    EXPECT_EQ(scanner.feed(std::span{data}.first(2)), std::vector<uint64_t>{0});
+}
@@ -0,0 +1,51 @@
+#include <cstring>
+
+#include <gtest/gtest.h>
+#include <libhat/Scanner.hpp>
+#include <libhat/XrefIndex.hpp>
+
+#include "../Module.hpp"
+
+// A polymorphic class whose key function is defined here, so that its vtable and type info are emitted into the test
+// executable
+struct LibhatVtableTest {
+    virtual ~LibhatVtableTest();
+    virtual int value() const;
+};
+
+LibhatVtableTest::~LibhatVtableTest() = default;
+
+int LibhatVtableTest::value() const {
+    return 42;
+}
+
+namespace {
+
+    // The address the vptr of an object points to, i.e. the first virtual function in the vtable
+    [[nodiscard]] const std::byte* vtable_of(const LibhatVtableTest& object) {
+        const void* vptr;
+        std::memcpy(&vptr, &object, sizeof(vptr));
+        return static_cast<const std::byte*>(vptr);
+    }
+}
+
+TEST(VtableTest, FindsGnuVtable) {
+    LIBHAT_TEST_REQUIRE_MODULE_SCAN();
+
+    const LibhatVtableTest object{};
+    const auto vtable = hat::experimental::find_vtable<hat::experimental::compiler_type::GNU>("LibhatVtableTest");
+    ASSERT_TRUE(vtable.has_result());
+    EXPECT_EQ(vtable.get(), vtable_of(object));
+
+    EXPECT_FALSE(hat::experimental::find_vtable<hat::experimental::compiler_type::GNU>("LibhatVtableTestMissing").has_result());
+}
+
+TEST(VtableTest, FindsGnuVtableThroughIndex) {
+    LIBHAT_TEST_REQUIRE_MODULE_SCAN();
+
+    const LibhatVtableTest object{};
+    const auto index = hat::xref_index::build(hat::process::get_process_module(), hat::xref_kind::pointer);
+    const auto vtable = hat::experimental::find_vtable<hat::experimental::compiler_type::GNU>("LibhatVtableTest", index);
+    ASSERT_TRUE(vtable.has_result());
+    EXPECT_EQ(vtable.get(), vtable_of(object));
+}
@@ -0,0 +1,104 @@
+#include <array>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <libhat/Watch.hpp>
+
+namespace {
+
+    [[nodiscard]] hat::signature parse(const std::string_view str) {
+        return hat::parse_signature(str).value();
+    }
+
+    // A range of a few pages which is watched for two signatures
+    class WatchTest : public testing::Test {
+    protected:
+        void place(const size_t offset, const std::initializer_list<uint8_t> bytes) {
+            for (size_t i = 0; const auto byte : bytes) {
+                this->data[offset + i++] = static_cast<std::byte>(byte);
+            }
+        }
+
+        [[nodiscard]] std::vector<const std::byte*> matches(const hat::watch& watch, const size_t index) const {
+            std::vector<const std::byte*> result{};
+            for (const auto match : watch.matches(index)) {
+                result.push_back(match.get());
+            }
+            return result;
+        }
+
+        std::vector<std::byte> data = std::vector<std::byte>(hat::watch_page_size * 4);
+        hat::signature first = parse("E8 ? ? ? ? 90");
+        hat::signature second = parse("CC CC");
+        std::array<hat::signature_view, 2> signatures{first, second};
+    };
+}
+
+TEST_F(WatchTest, ScansRangeOnCreation) {
+    this->place(10, {0xE8, 1, 2, 3, 4, 0x90});
+    this->place(hat::watch_page_size * 3, {0xCC, 0xCC});
+
+    const hat::watch watch{this->data, this->signatures};
+    EXPECT_EQ(watch.size(), 2);
+    EXPECT_EQ(watch.range().data(), this->data.data());
+    EXPECT_EQ(this->matches(watch, 0), std::vector<const std::byte*>{&this->data[10]});
+    EXPECT_EQ(this->matches(watch, 1), std::vector<const std::byte*>{&this->data[hat::watch_page_size * 3]});
+}
+
+TEST_F(WatchTest, UnchangedRangeRescansNothing) {
+    this->place(10, {0xE8, 1, 2, 3, 4, 0x90});
+    hat::watch watch{this->data, this->signatures};
+
+    const auto update = watch.update();
+    EXPECT_EQ(update.pages, 0);
+    EXPECT_EQ(update.added, 0);
+    EXPECT_EQ(update.removed, 0);
+    EXPECT_EQ(watch.matches(0).size(), 1);
+}
+
+TEST_F(WatchTest, RescansChangedPages) {
+    this->place(10, {0xE8, 1, 2, 3, 4, 0x90});
+    hat::watch watch{this->data, this->signatures};
+
+    // Patch the first match, and add one in the last page
+    this->data[15] = std::byte{0xC3};
+    this->place(hat::watch_page_size * 3 + 100, {0xCC, 0xCC});
+
+    const auto update = watch.update();
+    EXPECT_EQ(update.pages, 2);
+    EXPECT_EQ(update.added, 1);
+    EXPECT_EQ(update.removed, 1);
+    EXPECT_TRUE(watch.matches(0).empty());
+    EXPECT_EQ(this->matches(watch, 1), std::vector<const std::byte*>{&this->data[hat::watch_page_size * 3 + 100]});
+}
+
+TEST_F(WatchTest, FindsMatchesAcrossPageBoundaries) {
+    hat::watch watch{this->data, this->signatures};
+
+    // Only the page after the boundary changes, but the match begins in the page before it
+    this->place(hat::watch_page_size - 3, {0xE8, 1, 2});
+    watch.update();
+    this->place(hat::watch_page_size, {3, 4, 0x90});
+    const auto update = watch.update();
+    EXPECT_EQ(update.pages, 1);
+    EXPECT_EQ(update.added, 1);
+    EXPECT_EQ(this->matches(watch, 0), std::vector<const std::byte*>{&this->data[hat::watch_page_size - 3]});
+}
+
+TEST_F(WatchTest, RescansGivenRegions) {
+    hat::watch watch{this->data, this->signatures};
+    this->place(hat::watch_page_size * 2, {0xCC, 0xCC});
+
+    // Empty regions are ignored
+    const std::array<std::span<std::byte>, 2> changed{
+        std::span{this->data}.subspan(hat::watch_page_size * 2, 2),
+        std::span{this->data}.subspan(0, 0)
+    };
+    const auto update = watch.update(changed);
+    EXPECT_EQ(update.pages, 1);
+    EXPECT_EQ(update.added, 1);
+    EXPECT_EQ(watch.matches(1).size(), 1);
+
+    // The hashes of the rescanned pages were refreshed
+    EXPECT_EQ(watch.update().pages, 0);
+}
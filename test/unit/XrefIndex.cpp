@@ -0,0 +1,60 @@
+#include <algorithm>
+
+#include <gtest/gtest.h>
+#include <libhat/Process.hpp>
+#include <libhat/XrefIndex.hpp>
+
+#include "../Module.hpp"
+
+// An absolute pointer within the test executable, which is recorded as a pointer reference to its target
+extern const int xref_target;
+extern const int* const xref_pointer;
+const int xref_target = 42;
+const int* const xref_pointer = &xref_target;
+
+namespace {
+
+    [[nodiscard]] const std::byte* address_of(const void* ptr) {
+        return static_cast<const std::byte*>(ptr);
+    }
+}
+
+TEST(XrefIndexTest, FindsPointers) {
+    LIBHAT_TEST_REQUIRE_MODULE_SCAN();
+
+    const auto index = hat::xref_index::build(hat::process::get_process_module(), hat::xref_kind::pointer);
+    ASSERT_FALSE(index.empty());
+
+    const auto refs = index.references(&xref_target);
+    const auto pointer = std::ranges::find(refs, address_of(&xref_pointer), &hat::xref::source);
+    ASSERT_NE(pointer, refs.end());
+    EXPECT_EQ(pointer->target, address_of(&xref_target));
+    EXPECT_EQ(pointer->kind, hat::xref_kind::pointer);
+
+    // The lowest source of any reference, which is at most the address of the pointer
+    const auto found = index.find(&xref_target, hat::xref_kind::pointer);
+    ASSERT_TRUE(found.has_result());
+    EXPECT_LE(found.get(), address_of(&xref_pointer));
+
+    // Restricted to a range containing only the pointer
+    const std::span range{address_of(&xref_pointer), sizeof(xref_pointer)};
+    EXPECT_EQ(index.find(&xref_target, hat::xref_kind::pointer, range).get(), address_of(&xref_pointer));
+    EXPECT_FALSE(index.find(&xref_target, hat::xref_kind::relative, range).has_result());
+}
+
+TEST(XrefIndexTest, OnlyCollectsRequestedKinds) {
+    LIBHAT_TEST_REQUIRE_MODULE_SCAN();
+
+    const auto index = hat::xref_index::build(hat::process::get_process_module(), hat::xref_kind::image_offset);
+    for (const auto& ref : index.references(&xref_target)) {
+        EXPECT_EQ(ref.kind, hat::xref_kind::image_offset);
+    }
+}
+
+TEST(XrefIndexTest, EmptyIndex) {
+    const hat::xref_index index{};
+    EXPECT_TRUE(index.empty());
+    EXPECT_EQ(index.size(), 0);
+    EXPECT_TRUE(index.references(&xref_target).empty());
+    EXPECT_FALSE(index.find(&xref_target).has_result());
+}